@@ -80,6 +80,14 @@ if( NOT MacOSX )
   endif()
 endif()
 
+#-------------------------------------------------------------------------------
+# io_uring (used via raw system calls so only the kernel header is needed)
+#-------------------------------------------------------------------------------
+if( Linux )
+  check_include_file( linux/io_uring.h HAVE_IOURING )
+  compiler_define_if_found( HAVE_IOURING HAVE_IOURING )
+endif()
+
 #-------------------------------------------------------------------------------
 # Check for libcrypt
 #-------------------------------------------------------------------------------
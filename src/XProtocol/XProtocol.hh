@@ -140,6 +140,7 @@ enum XRequestTypes {
    kXR_sigver,  // 3029
    kXR_decrypt, // 3030
    kXR_writev,  // 3031
+   kXR_statm,   // 3032
    kXR_REQFENCE // Always last valid request code +1
 };
 
@@ -190,7 +191,8 @@ enum XLoginVersion {
 };
 
 enum XStatRequestOption {
-   kXR_vfs    = 1
+   kXR_vfs    = 1,
+   kXR_retcks = 2    // kXR_statm only: return the file's checksum, if known
 };
 
 enum XStatRespFlags {
@@ -207,7 +209,8 @@ enum XStatRespFlags {
 
 enum XDirlistRequestOption {
    kXR_online = 1,
-   kXR_dstat  = 2
+   kXR_dstat  = 2,
+   kXR_dpage  = 4
 };
 
 enum XOpenRequestOption {
@@ -411,7 +414,14 @@ struct ClientDecryptRequest {
 struct ClientDirlistRequest {
    kXR_char  streamid[2];
    kXR_unt16 requestid;
-   kXR_char reserved[15];
+   kXR_char  reserved1[4];
+   kXR_int32 pgsize;     // kXR_dpage: maximum entries to return (0 -> all)
+   kXR_int32 pgcursor;   // kXR_dpage: cursor returned by the previous page
+                         // It is the number of entries already returned, so
+                         // the server rereads those for each page and entries
+                         // may be skipped or repeated should the directory
+                         // change between pages.
+   kXR_char  reserved2[3];
    kXR_char options[1];
    kXR_int32  dlen;
 };
@@ -0,0 +1,276 @@
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d B u f f A r e n a . c c                        */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "XrdOuc/XrdOucUtils.hh"
+#include "Xrd/XrdBuffArena.hh"
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// Regions are aligned on a huge page boundary and a sliced region is a single
+// huge page. So, the region holding a slice is found by rounding it down.
+//
+inline char *regBase(char *bp)
+{
+   return (char *)((size_t)bp & ~((size_t)XrdBuffArena::hpSize - 1));
+}
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdBuffArena::XrdBuffArena() : totmap(0), minsz(0), numhtlb(0), numthp(0),
+                               numfail(0), useHTLB(false)
+{
+   memset(slice, 0, sizeof(slice));
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+  
+char *XrdBuffArena::Alloc(int bsz, int node)
+{
+   SliceQ *sP;
+   char *bp, *rp;
+   int i, n;
+   bool htlb;
+
+// Check if this buffer should come from the arena. Buffer sizes are always
+// a power of two, which is what makes slicing a region work.
+//
+   if (!minsz || bsz < minsz || (bsz & (bsz-1))) return 0;
+
+// Large buffers get a region of their own
+//
+   if (bsz >= hpSize)
+      {bp = mapRegion(bsz, htlb);
+       arMutex.Lock();
+       if (!bp) numfail++;
+          else {totmap += bsz; if (htlb) numhtlb++; else numthp++;}
+       arMutex.UnLock();
+       return bp;
+      }
+
+// Return a free slice of the caller's node if we have one
+//
+   i = XrdOucUtils::Log2(bsz) - minShift;
+   sP = &slice[node % maxNodes][i];
+   arMutex.Lock();
+   if ((bp = sP->bnext))
+      {sP->bnext = *(char **)bp;
+       sP->numfree--;
+       regUse[regBase(bp)]++;
+       arMutex.UnLock();
+       return bp;
+      }
+
+// Carve up a new region into slices of the wanted size and keep all but the
+// first one for the caller's node. The lock is held so that concurrent
+// requests do not each map a region for the same size.
+//
+   if (!(rp = mapRegion(hpSize, htlb)))
+      {numfail++;
+       arMutex.UnLock();
+       return 0;
+      }
+   totmap += hpSize;
+   if (htlb) numhtlb++;
+      else   numthp++;
+   n = hpSize / bsz;
+   for (bp = rp + bsz*(n-1); bp > rp; bp -= bsz)
+       {*(char **)bp = sP->bnext;
+        sP->bnext = bp;
+       }
+   sP->numfree += n-1;
+   regUse[rp] = 1;
+   arMutex.UnLock();
+   return rp;
+}
+
+/******************************************************************************/
+/*                                  F r e e                                   */
+/******************************************************************************/
+  
+void XrdBuffArena::Free(char *bp, int bsz, int node)
+{
+   SliceQ *sP;
+   int i;
+
+// Large buffers have their own region so we can simply unmap it
+//
+   if (bsz >= hpSize)
+      {munmap(bp, bsz);
+       arMutex.Lock(); totmap -= bsz; arMutex.UnLock();
+       return;
+      }
+
+// Slices are kept for reuse by the node they were carved out for. Once all
+// of the slices of a region are free, the region is given back.
+//
+   i = XrdOucUtils::Log2(bsz) - minShift;
+   sP = &slice[node % maxNodes][i];
+   arMutex.Lock();
+   *(char **)bp = sP->bnext;
+   sP->bnext = bp;
+   sP->numfree++;
+   if (!(--regUse[regBase(bp)])) relRegion(regBase(bp), i, node);
+   arMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+void XrdBuffArena::Init(int minBSZ, bool hugetlb)
+{
+   int lg2;
+
+// A zero or negative size turns the arena off
+//
+   if (minBSZ <= 0) {minsz = 0; return;}
+
+// Round the minimum size up to a power of two within our range
+//
+   if (minBSZ < minSize) minBSZ = minSize;
+   lg2 = XrdOucUtils::Log2(minBSZ);
+   if ((1 << lg2) < minBSZ) lg2++;
+   if (lg2 > hpShift) lg2 = hpShift;
+   minsz   = 1 << lg2;
+   useHTLB = hugetlb;
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+  
+int XrdBuffArena::Stats(char *buff, int blen, int do_sync)
+{
+    static char statfmt[] = "<hpmem>%lld</hpmem><hptlb>%d</hptlb>"
+                "<hpthp>%d</hpthp><hpfail>%d</hpfail>";
+    int nlen;
+
+// If only size wanted, return it
+//
+   if (!buff) return sizeof(statfmt) + 16*4;
+
+// Return formatted stats
+//
+   if (do_sync) arMutex.Lock();
+   nlen = snprintf(buff, blen, statfmt, totmap, numhtlb, numthp, numfail);
+   if (do_sync) arMutex.UnLock();
+   return nlen;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                             m a p R e g i o n                              */
+/******************************************************************************/
+
+// The region size must be a multiple of the huge page size. Upon return, htlb
+// is true if the region came from the hugetlb pool.
+  
+char *XrdBuffArena::mapRegion(int rsz, bool &htlb)
+{
+   static const int mapOpts = MAP_PRIVATE | MAP_ANONYMOUS;
+   char *rp, *ap;
+   size_t hsz, tsz;
+
+// First try to get the region from the reserved hugetlb pool, if so wanted.
+// This fails when the pool is exhausted, in which case we fall through.
+//
+#ifdef MAP_HUGETLB
+   if (useHTLB)
+      {rp = (char *)mmap(0, rsz, PROT_READ|PROT_WRITE, mapOpts|MAP_HUGETLB,
+                         -1, 0);
+       if (rp != MAP_FAILED) {htlb = true; return rp;}
+      }
+#endif
+
+// Map an area large enough so that we can align the region on a huge page
+// boundary and trim off the excess. Then ask that it be backed by
+// transparent huge pages. Failing that, it is still well aligned memory.
+//
+   rp = (char *)mmap(0, rsz+hpSize, PROT_READ|PROT_WRITE, mapOpts, -1, 0);
+   if (rp == MAP_FAILED) return 0;
+   ap  = (char *)(((size_t)rp + hpSize - 1) & ~((size_t)hpSize - 1));
+   hsz = ap - rp;
+   tsz = hpSize - hsz;
+   if (hsz) munmap(rp, hsz);
+   if (tsz) munmap(ap+rsz, tsz);
+#ifdef MADV_HUGEPAGE
+   madvise(ap, rsz, MADV_HUGEPAGE);
+#endif
+   htlb = false;
+   return ap;
+}
+
+/******************************************************************************/
+/*                             r e l R e g i o n                              */
+/******************************************************************************/
+
+// The caller must hold arMutex and all slices of the region must be free
+
+void XrdBuffArena::relRegion(char *rp, int i, int node)
+{
+   SliceQ *sP = &slice[node % maxNodes][i];
+   char **pp = &(sP->bnext), *bp;
+
+// Take the region's slices off the free list. They are all on this list as
+// a region is only carved up for one size and node.
+//
+   while((bp = *pp))
+        {if (bp >= rp && bp < rp + hpSize)
+            {*pp = *(char **)bp; sP->numfree--;}
+            else pp = (char **)bp;
+        }
+
+// Now give back the region
+//
+   regUse.erase(rp);
+   munmap(rp, hpSize);
+   totmap -= hpSize;
+}
@@ -0,0 +1,96 @@
+#ifndef __XrdBuffArena_H__
+#define __XrdBuffArena_H__
+/******************************************************************************/
+/*                                                                            */
+/*                       X r d B u f f A r e n a . h h                        */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <map>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+// The arena hands out large buffers carved out of huge page regions. Buffers
+// smaller than a huge page are slices of a region dedicated to that size and
+// are kept for reuse once released. When all of a region's slices have been
+// released the region is unmapped so that the memory is returned and counts
+// against the buffer limit no more. Larger buffers get their own region which
+// is unmapped when the buffer is released. When huge pages cannot be had, the
+// arena returns a null pointer and the caller should allocate memory itself.
+//
+// Free slices are kept per NUMA node. A region is carved up for the node of
+// the thread asking for a slice and its slices are only handed out to threads
+// on that node, so the region is first touched and placed on that node. Large
+// buffers are placed on the node of the thread that first touches them.
+//
+// There should be only one instance of this class.
+//
+class XrdBuffArena
+{
+public:
+
+char       *Alloc(int bsz, int node=0);
+
+void        Free(char *bp, int bsz, int node=0);
+
+void        Init(int minBSZ, bool hugetlb);
+
+int         Stats(char *buff, int blen, int do_sync=0);
+
+            XrdBuffArena();
+
+           ~XrdBuffArena() {} // The arena is never deleted
+
+static const int hpShift  = 21;
+static const int hpSize   = 1 << hpShift;   // 2MB
+static const int minShift = 16;
+static const int minSize  = 1 << minShift;  // 64K
+static const int maxNodes = 64;             // Higher nodes share queues
+
+private:
+
+char       *mapRegion(int rsz, bool &htlb);
+void        relRegion(char *rp, int i, int node);
+
+static const int numSlices = hpShift - minShift; // minSize to hpSize/2
+
+XrdSysMutex       arMutex;
+
+struct SliceQ
+      {char      *bnext;      // Free slices are chained via their first word
+       int        numfree;
+       };
+
+       SliceQ     slice[maxNodes][numSlices];
+std::map<char *, int> regUse; // Slices in use by region (sliced regions only)
+       long long  totmap;     // Bytes mapped
+       int        minsz;      // Smallest buffer we hand out (0 -> disabled)
+       int        numhtlb;    // Regions mapped from the hugetlb pool
+       int        numthp;     // Regions mapped with transparent huge pages
+       int        numfail;    // Requests we could not satisfy
+       bool       useHTLB;
+};
+#endif
@@ -37,8 +37,16 @@
 
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "Xrd/XrdBuffArena.hh"
 #include "XrdBuffXL.hh"
 
+namespace XrdGlobal
+{
+extern XrdBuffArena hpArena;
+}
+
+using namespace XrdGlobal;
+
 /******************************************************************************/
 /*                          L o c a l   V a l u e s                           */
 /******************************************************************************/
@@ -103,6 +111,7 @@ XrdBuffer *XrdBuffXL::Obtain(int sz)
    XrdBuffer *bp;
    char *memp;
    int mk, buffSz, bindex = 0;
+   bool inArena;
 
 // Make sure the request is within our limits
 //
@@ -132,14 +141,21 @@ XrdBuffer *XrdBuffXL::Obtain(int sz)
 //
    if (bp) return bp;
 
-// Allocate a chunk of aligned memory
+// Allocate a chunk of aligned memory, preferably out of huge pages
 //
-   if (!(memp = static_cast<char *>(memalign(pagsz, buffSz)))) return 0;
+   if (!(memp = hpArena.Alloc(buffSz)))
+      {if (!(memp = static_cast<char *>(memalign(pagsz, buffSz)))) return 0;
+       inArena = false;
+      } else inArena = true;
 
 // Wrap the memory with a buffer object
 //
    if (!(bp = new XrdBuffer(memp, buffSz, bindex|isBigBuff)))
-      {free(memp); return 0;}
+      {if (inArena) hpArena.Free(memp, buffSz);
+          else free(memp);
+       return 0;
+      }
+   bp->inArena = inArena;
 
 // Update statistics
 //
@@ -32,15 +32,21 @@
 #if !defined(__APPLE__) && !defined(__FreeBSD__)
 #include <malloc.h>
 #endif
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include "Xrd/XrdBuffer.hh"
+#include "Xrd/XrdBuffArena.hh"
 #include "XrdBuffXL.hh"
 
 #define XRD_TRACE XrdTrace->
@@ -65,16 +71,121 @@ const char *XrdBuffManager::TraceID = "BuffManager";
 
 namespace
 {
-static const int minBuffSz = 1 << XRD_BUSHIFT;
+static const int minBuffSz   = 1 << XRD_BUSHIFT;
+static const int maxCacheMem = 4*1024*1024;  // Per thread
+static const int maxCacheBuf = 4;            // Per thread and bucket
 }
 
 namespace XrdGlobal
 {
-XrdBuffXL xlBuff;
+XrdBuffXL    xlBuff;
+XrdBuffArena hpArena;
 }
 
 using namespace XrdGlobal;
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+class XrdBuffPool
+{
+public:
+
+XrdSysMutex pMutex;
+XrdBuffer  *bnext[XRD_BUCKETS];
+int         numbuf[XRD_BUCKETS];
+char        pad[64];              // Keep node pools on separate cache lines
+
+            XrdBuffPool() {memset(bnext,  0, sizeof(bnext));
+                           memset(numbuf, 0, sizeof(numbuf));
+                          }
+           ~XrdBuffPool() {}
+};
+
+class XrdBuffCache
+{
+public:
+
+XrdSysMutex     cMutex;           // Only contended when the cache is trimmed
+XrdBuffCache   *next;
+XrdBuffManager *bMgr;
+XrdBuffer      *bnext[XRD_BUCKETS];
+int             numbuf[XRD_BUCKETS];
+int             numreq[XRD_BUCKETS];
+int             node;
+int             numHit;
+int             numMiss;
+int             numSpill;
+
+                XrdBuffCache(XrdBuffManager *bP, int nx)
+                            : next(0), bMgr(bP), node(nx),
+                              numHit(0), numMiss(0), numSpill(0)
+                            {memset(bnext,  0, sizeof(bnext));
+                             memset(numbuf, 0, sizeof(numbuf));
+                             memset(numreq, 0, sizeof(numreq));
+                            }
+               ~XrdBuffCache() {}
+};
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+// Return the number of NUMA nodes this machine may have
+//
+int numaNodes()
+{
+#ifdef __linux__
+   char buff[256], *bP, *cP;
+   int fd, n;
+
+// The file holds a list of node ranges (e.g. "0-3" or "0,2-3"). We only need
+// the highest node number as a node's pool is indexed by its number.
+//
+   if ((fd = open("/sys/devices/system/node/possible", O_RDONLY)) < 0)
+      return 1;
+   n = read(fd, buff, sizeof(buff)-1);
+   close(fd);
+   if (n <= 0) return 1;
+   buff[n] = 0;
+   bP = strrchr(buff, '-'); cP = strrchr(buff, ',');
+   if (cP > bP) bP = cP;
+   n = atoi(bP ? bP+1 : buff) + 1;
+   if (n > XRD_MAXNODES) n = XRD_MAXNODES;
+   return (n > 0 ? n : 1);
+#else
+   return 1;
+#endif
+}
+
+// Return the NUMA node the calling thread is running on
+//
+int numaNode(int nmax)
+{
+#ifdef __linux__
+   unsigned int cpu, node;
+
+   if (!syscall(SYS_getcpu, &cpu, &node, 0) && int(node) < nmax) return node;
+#endif
+   return 0;
+}
+}
  
+/******************************************************************************/
+/*                  X r d B u f f e r   D e s t r u c t o r                   */
+/******************************************************************************/
+
+XrdBuffer::~XrdBuffer()
+{
+   if (buff)
+      {if (inArena) hpArena.Free(buff, bsize, bnode);
+          else free(buff);
+      }
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -103,7 +214,25 @@ XrdBuffManager::XrdBuffManager(XrdSysError *lP, XrdOucTrace *tP, int minrst) :
 #endif
    rsinprog = 0;
    minrsw   = minrst;
-   memset(static_cast<void *>(bucket), 0, sizeof(bucket));
+   numHit   = numMiss = numSpill = 0;
+
+// Allocate a buffer pool for each NUMA node
+//
+   numNodes = numaNodes();
+   nodePool = new XrdBuffPool[numNodes];
+
+// Calculate how many buffers of each size a thread may keep for itself. We
+// always allow one so that a thread can reuse its last buffer.
+//
+   for (int i = 0; i < XRD_BUCKETS; i++)
+       {int n = maxCacheMem >> (XRD_BUSHIFT + i);
+        cacheMax[i] = (n < 1 ? 1 : (n > maxCacheBuf ? maxCacheBuf : n));
+       }
+
+// Thread caches are created on first use and returned when the thread ends
+//
+   cacheList = 0;
+   pthread_key_create(&cacheKey, dropCache);
 }
 
 /******************************************************************************/
@@ -114,13 +243,15 @@ XrdBuffManager::~XrdBuffManager()
 {
    XrdBuffer *bP;
 
+   for (int n = 0; n < numNodes; n++)
    for (int i = 0; i < XRD_BUCKETS; i++)
-       {while((bP = bucket[i].bnext))
-             {bucket[i].bnext = bP->next;
+       {while((bP = nodePool[n].bnext[i]))
+             {nodePool[n].bnext[i] = bP->next;
               delete bP;
              }
-        bucket[i].numbuf = 0;
+        nodePool[n].numbuf[i] = 0;
        }
+   delete [] nodePool;
 }
 
 /******************************************************************************/
@@ -145,9 +276,12 @@ void XrdBuffManager::Init()
   
 XrdBuffer *XrdBuffManager::Obtain(int sz)
 {
+   XrdBuffCache *cP;
+   XrdBuffPool  *pP;
    XrdBuffer *bp;
    char *memp;
    int mk, pk, bindex;
+   bool inArena;
 
 // Make sure the request is within our limits
 //
@@ -162,27 +296,43 @@ XrdBuffer *XrdBuffManager::Obtain(int sz)
    if (mk < sz) {bindex++; mk = mk << 1;}
    if (bindex >= slots) return 0;    // Should never happen!
 
-// Obtain a lock on the bucket array and try to give away an existing buffer
+// Try to give away a buffer from this thread's cache
 //
-    Reshaper.Lock();
-    totreq++;
-    bucket[bindex].numreq++;
-    if ((bp = bucket[bindex].bnext))
-       {bucket[bindex].bnext = bp->next; bucket[bindex].numbuf--;}
-    Reshaper.UnLock();
+   cP = getCache();
+   cP->cMutex.Lock();
+   cP->numreq[bindex]++;
+   if ((bp = cP->bnext[bindex]))
+      {cP->bnext[bindex] = bp->next; cP->numbuf[bindex]--; cP->numHit++;}
+      else cP->numMiss++;
+   cP->cMutex.UnLock();
+   if (bp) return bp;
 
-// Check if we really allocated a buffer
+// Try to give away a buffer from the pool for the node we are running on
 //
+   pP = &nodePool[cP->node];
+   pP->pMutex.Lock();
+   if ((bp = pP->bnext[bindex]))
+      {pP->bnext[bindex] = bp->next; pP->numbuf[bindex]--;}
+   pP->pMutex.UnLock();
    if (bp) return bp;
 
-// Allocate a chunk of aligned memory
+// Allocate a chunk of aligned memory. It will be first touched by this
+// thread so it will be local to this thread's node.
 //
-   pk = (mk < pagsz ? mk : pagsz);
-   if (!(memp = static_cast<char *>(memalign(pk, mk)))) return 0;
+   if (!(memp = hpArena.Alloc(mk, cP->node)))
+      {pk = (mk < pagsz ? mk : pagsz);
+       if (!(memp = static_cast<char *>(memalign(pk, mk)))) return 0;
+       inArena = false;
+      } else inArena = true;
 
 // Wrap the memory with a buffer object
 //
-   if (!(bp = new XrdBuffer(memp, mk, bindex))) {free(memp); return 0;}
+   if (!(bp = new XrdBuffer(memp, mk, bindex, cP->node)))
+      {if (inArena) hpArena.Free(memp, mk, cP->node);
+          else free(memp);
+       return 0;
+      }
+   bp->inArena = inArena;
 
 // Update statistics
 //
@@ -226,19 +376,37 @@ int XrdBuffManager::Recalc(int sz)
   
 void XrdBuffManager::Release(XrdBuffer *bp)
 {
+   XrdBuffCache *cP;
+   XrdBuffPool  *pP;
    int bindex = bp->bindex;
 
 // Check if we should release this via the big buffer object
 //
    if (bindex >= slots) {xlBuff.Release(bp); return;}
 
-// Obtain a lock on the bucket array and reclaim the buffer
+// Keep the buffer in this thread's cache if it is local to the thread's node
+// and the cache has room for it.
 //
-    Reshaper.Lock();
-    bp->next = bucket[bp->bindex].bnext;
-    bucket[bp->bindex].bnext = bp;
-    bucket[bindex].numbuf++;
-    Reshaper.UnLock();
+   cP = getCache();
+   cP->cMutex.Lock();
+   if (bp->bnode == cP->node && cP->numbuf[bindex] < cacheMax[bindex])
+      {bp->next = cP->bnext[bindex];
+       cP->bnext[bindex] = bp;
+       cP->numbuf[bindex]++;
+       cP->cMutex.UnLock();
+       return;
+      }
+   cP->numSpill++;
+   cP->cMutex.UnLock();
+
+// Spill the buffer to the pool of the node that owns it
+//
+   pP = &nodePool[bp->bnode];
+   pP->pMutex.Lock();
+   bp->next = pP->bnext[bindex];
+   pP->bnext[bindex] = bp;
+   pP->numbuf[bindex]++;
+   pP->pMutex.UnLock();
 }
  
 /******************************************************************************/
@@ -247,15 +415,19 @@ void XrdBuffManager::Release(XrdBuffer *bp)
   
 void XrdBuffManager::Reshape()
 {
-int i, bufprof[XRD_BUCKETS], numfreed;
+int i, n, bufprof[XRD_BUCKETS], numreq[XRD_BUCKETS], numfreed, numspilled;
+int nodeprof;
 time_t delta, lastshape = time(0);
-long long memslot, memhave, memtarget = (long long)(.80*(float)maxalo);
+long long memslot, memhave, memfreed, memtarget = (long long)(.80*(float)maxalo);
 XrdSysTimer Timer;
 float requests, buffers;
+XrdBuffCache *cP;
+XrdBuffPool  *pP;
 XrdBuffer *bp;
 
 // This is an endless loop to periodically reshape the buffer pool
 //
+memset(numreq, 0, sizeof(numreq));
 while(1)
      {Reshaper.Lock();
       while(Reshaper.Wait(minrsw) && totalo <= maxalo)
@@ -266,40 +438,63 @@ while(1)
           Reshaper.Lock();
          }
 
-      // We have the lock so compute the request profile
+      // We have the lock so gather the request profile from the thread caches.
+      // This also trims the thread tier: buffers of a size a thread has not
+      // asked for since the last reshape are returned to the node pools. When
+      // memory is over target, the caches are emptied so that the node tier
+      // can free the buffers.
+      //
+      numspilled = 0;
+      for (cP = cacheList; cP; cP = cP->next)
+          {cP->cMutex.Lock();
+           for (i = 0; i < slots; i++)
+               {if (cP->numbuf[i] && (!(cP->numreq[i]) || totalo > memtarget))
+                   {numspilled += cP->numbuf[i]; Spill(cP, i);}
+                numreq[i] += cP->numreq[i]; totreq += cP->numreq[i];
+                cP->numreq[i] = 0;
+               }
+           cP->cMutex.UnLock();
+          }
+
+      // Compute the request profile
       //
       if (totreq > slots)
          {requests = (float)totreq;
           buffers  = (float)totbuf;
           for (i = 0; i < slots; i++)
-              {bufprof[i] = (int)(buffers*(((float)bucket[i].numreq)/requests));
-               bucket[i].numreq = 0;
+              {bufprof[i] = (int)(buffers*(((float)numreq[i])/requests));
+               numreq[i] = 0;
               }
           totreq = 0; memhave = totalo;
          } else memhave = 0;
       Reshaper.UnLock();
 
-      // Reshape the buffer pool to agree with the request profile
+      // Reshape each node's pool to agree with its share of the request profile
       //
-      memslot = maxsz; numfreed = 0;
+      memslot = maxsz; numfreed = 0; memfreed = 0;
       for (i = slots-1; i >= 0 && memhave > memtarget; i--)
-          {Reshaper.Lock();
-           while(bucket[i].numbuf > bufprof[i])
-                if ((bp = bucket[i].bnext))
-                   {bucket[i].bnext = bp->next;
-                    delete bp;
-                    bucket[i].numbuf--; numfreed++;
-                    memhave -= memslot; totalo  -= memslot;
-                    totbuf--;
-                   } else {bucket[i].numbuf = 0; break;}
-           Reshaper.UnLock();
+          {nodeprof = (bufprof[i] + numNodes - 1) / numNodes;
+           for (n = 0; n < numNodes; n++)
+               {pP = &nodePool[n];
+                pP->pMutex.Lock();
+                while(pP->numbuf[i] > nodeprof && (bp = pP->bnext[i]))
+                     {pP->bnext[i] = bp->next;
+                      delete bp;
+                      pP->numbuf[i]--; numfreed++;
+                      memhave -= memslot; memfreed += memslot;
+                     }
+                pP->pMutex.UnLock();
+               }
            memslot = memslot>>1;
           }
+      Reshaper.Lock();
+      totalo -= memfreed; totbuf -= numfreed;
+      Reshaper.UnLock();
 
        // All done
        //
        totadj += numfreed;
-       TRACE(MEM, "Pool reshaped; " <<numfreed <<" freed; have " <<(memhave>>10) <<"K; target " <<(memtarget>>10) <<"K");
+       TRACE(MEM, "Pool reshaped; " <<numspilled <<" uncached; " <<numfreed <<" freed; have " <<(memhave>>10) <<"K; target " <<(memtarget>>10) <<"K");
        lastshape = time(0);
        rsinprog = 0;    // No need to lock, we're the only ones now setting it
 
@@ -329,19 +524,122 @@ void XrdBuffManager::Set(int maxmem, int minw)
 int XrdBuffManager::Stats(char *buff, int blen, int do_sync)
 {
     static char statfmt[] = "<stats id=\"buff\"><reqs>%d</reqs>"
-                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>%s</stats>";
-    char xlStats[1024];
-    int nlen;
+                "<mem>%lld</mem><buffs>%d</buffs><adj>%d</adj>"
+                "<hit>%d</hit><miss>%d</miss><spill>%d</spill>%s%s</stats>";
+    XrdBuffCache *cP;
+    char xlStats[1024], hpStats[256];
+    int nlen, reqs, hits, miss, spill;
 
 // If only size wanted, return it
 //
-   if (!buff) return sizeof(statfmt) + 16*4 + xlBuff.Stats(0,0);
+   if (!buff) return sizeof(statfmt) + 16*7 + xlBuff.Stats(0,0)
+                                             + hpArena.Stats(0,0);
+
+// Sum up the counts from each thread cache. We need the lock to walk the list
+// of caches whether or not a sync was requested as threads may go away.
+//
+   Reshaper.Lock();
+   reqs = totreq; hits = numHit; miss = numMiss; spill = numSpill;
+   for (cP = cacheList; cP; cP = cP->next)
+       {for (int i = 0; i < slots; i++) reqs += cP->numreq[i];
+        hits  += cP->numHit;
+        miss  += cP->numMiss;
+        spill += cP->numSpill;
+       }
 
 // Return formatted stats
 //
-   if (do_sync) Reshaper.Lock();
    xlBuff.Stats(xlStats, sizeof(xlStats), do_sync);
-   nlen = snprintf(buff,blen,statfmt,totreq,totalo,totbuf,totadj,xlStats);
-   if (do_sync) Reshaper.UnLock();
+   hpArena.Stats(hpStats, sizeof(hpStats), do_sync);
+   nlen = snprintf(buff, blen, statfmt, reqs, totalo, totbuf, totadj,
+                   hits, miss, spill, xlStats, hpStats);
+   Reshaper.UnLock();
    return nlen;
 }
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                             d r o p C a c h e                              */
+/******************************************************************************/
+
+// This is called when a thread that has a cache ends
+  
+void XrdBuffManager::dropCache(void *cacheP)
+{
+   XrdBuffCache *pP, *cP = static_cast<XrdBuffCache *>(cacheP);
+   XrdBuffManager *bmP = cP->bMgr;
+
+// Remove the cache from the cache list and keep its counts
+//
+   bmP->Reshaper.Lock();
+   if (bmP->cacheList == cP) bmP->cacheList = cP->next;
+      else {pP = bmP->cacheList;
+            while(pP && pP->next != cP) pP = pP->next;
+            if (pP) pP->next = cP->next;
+           }
+   bmP->numHit   += cP->numHit;
+   bmP->numMiss  += cP->numMiss;
+   bmP->numSpill += cP->numSpill;
+   for (int i = 0; i < XRD_BUCKETS; i++) bmP->totreq += cP->numreq[i];
+
+// Return all of the buffers to the node pool
+//
+   cP->cMutex.Lock();
+   for (int i = 0; i < XRD_BUCKETS; i++) bmP->Spill(cP, i);
+   cP->cMutex.UnLock();
+   bmP->Reshaper.UnLock();
+   delete cP;
+}
+
+/******************************************************************************/
+/*                              g e t C a c h e                               */
+/******************************************************************************/
+  
+XrdBuffCache *XrdBuffManager::getCache()
+{
+   XrdBuffCache *cP;
+
+// Return the cache if this thread already has one
+//
+   if ((cP = static_cast<XrdBuffCache *>(pthread_getspecific(cacheKey))))
+      return cP;
+
+// Create a cache tied to the node this thread is running on
+//
+   cP = new XrdBuffCache(this, numaNode(numNodes));
+   pthread_setspecific(cacheKey, cP);
+
+// Add it to the list of caches so that the reshaper can see it
+//
+   Reshaper.Lock();
+   cP->next  = cacheList;
+   cacheList = cP;
+   Reshaper.UnLock();
+   return cP;
+}
+
+/******************************************************************************/
+/*                                 S p i l l                                  */
+/******************************************************************************/
+
+// The caller must hold the cache's mutex
+  
+void XrdBuffManager::Spill(XrdBuffCache *cP, int bindex)
+{
+   XrdBuffPool *pP = &nodePool[cP->node];
+   XrdBuffer *bp;
+
+   if (!(cP->numbuf[bindex])) return;
+
+   pP->pMutex.Lock();
+   while((bp = cP->bnext[bindex]))
+        {cP->bnext[bindex] = bp->next;
+         bp->next = pP->bnext[bindex];
+         pP->bnext[bindex] = bp;
+         pP->numbuf[bindex]++;
+        }
+   pP->pMutex.UnLock();
+   cP->numbuf[bindex] = 0;
+}
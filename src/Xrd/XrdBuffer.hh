@@ -45,17 +45,21 @@ public:
 char *   buff;     // -> buffer
 int      bsize;    // size of this buffer
 
-         XrdBuffer(char *bp, int sz, int ix)
-                      {buff = bp; bsize = sz; bindex = ix; next = 0;}
+         XrdBuffer(char *bp, int sz, int ix, int nx=0)
+                      {buff = bp; bsize = sz; bindex = ix; bnode = nx;
+                       next = 0; inArena = false;
+                      }
 
-        ~XrdBuffer() {if (buff) free(buff);}
+        ~XrdBuffer();
 
          friend class XrdBuffManager;
          friend class XrdBuffXL;
 private:
 
 int        bindex;
+int        bnode;  // NUMA node of the thread that first touched the buffer
 XrdBuffer *next;
+bool       inArena; // Memory came from the huge page arena
 static int pagesz;
 };
   
@@ -65,9 +69,18 @@ static int pagesz;
 
 #define XRD_BUCKETS 12
 #define XRD_BUSHIFT 10
+#define XRD_MAXNODES 64
 
+// Buffers are kept in two tiers. Each thread has a small cache of buffers
+// that it may use without contention. Buffers that do not fit in the cache
+// spill to a pool belonging to the NUMA node of the thread that allocated
+// the buffer. A thread only obtains buffers from its own node's pool so that
+// buffers are not used by threads on a remote node.
+//
 // There should be only one instance of this class per buffer pool.
 //
+class XrdBuffCache;
+class XrdBuffPool;
 class XrdOucTrace;
 class XrdSysError;
   
@@ -97,6 +110,10 @@ int         Stats(char *buff, int blen, int do_sync=0);
 
 private:
 
+static void   dropCache(void *cP);
+XrdBuffCache *getCache();
+void          Spill(XrdBuffCache *cP, int bindex);
+
 XrdOucTrace *XrdTrace;
 XrdSysError *XrdLog;
 
@@ -105,11 +122,15 @@ const int  shift;
 const int  pagsz;
 const int  maxsz;
 
-struct {XrdBuffer *bnext;
-        int         numbuf;
-        int         numreq;
-       } bucket[XRD_BUCKETS];          // 1K to 1<<(szshift+slots-1)M buffers
+XrdBuffPool  *nodePool;                // One per NUMA node
+XrdBuffCache *cacheList;               // All thread caches (Reshaper locked)
+pthread_key_t cacheKey;
+int           numNodes;
+int           cacheMax[XRD_BUCKETS];   // Buffers a thread may cache per bucket
 
+int       numHit;                      // Counts from threads that have ended
+int       numMiss;
+int       numSpill;
 int       totreq;
 int       totbuf;
 long long totalo;
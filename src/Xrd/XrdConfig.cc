@@ -46,6 +46,7 @@
 
 #include "XrdVersion.hh"
 
+#include "Xrd/XrdBuffArena.hh"
 #include "Xrd/XrdBuffXL.hh"
 #include "Xrd/XrdConfig.hh"
 #include "Xrd/XrdInfo.hh"
@@ -91,7 +92,8 @@ extern int ka_Icnt;
 
 namespace XrdGlobal
 {
-extern XrdBuffXL xlBuff;
+extern XrdBuffXL    xlBuff;
+extern XrdBuffArena hpArena;
 }
 
 namespace
@@ -170,8 +172,12 @@ XrdConfig::XrdConfig() : Log(&Logger, "Xrd"), Trace(&Log), Sched(&Log, &Trace),
    ppNet      = 0;
    NetTCPlep  = -1;
    NetADM     = 0;
+   NetShards  = 1;
+   NetPin     = false;
+   NetPoll    = 0;
    coreV      = 1;
    memset(NetTCP, 0, sizeof(NetTCP));
+   memset(NetSHD, 0, sizeof(NetSHD));
 
    Firstcp = Lastcp = 0;
 
@@ -912,6 +918,48 @@ int XrdConfig::setFDL()
    return 0;
 }
 
+/******************************************************************************/
+/*                             s e t S h a r d s                              */
+/******************************************************************************/
+
+void XrdConfig::setShards(int netidx, int opts, int blen)
+{
+   XrdInet **netP, *np = NetTCP[netidx];
+   char buff[64];
+   int i, rc, port = np->Port();
+
+// Allocate the shard table. The first shard is the original network object.
+// Links accepted on shard n are handled by poller n.
+//
+   netP = new XrdInet *[NetShards]();
+   netP[0] = np;
+   np->setPoller(0);
+
+// Bind the remaining shards to the same port. If the original socket did not
+// allow port reuse (e.g. it came from systemd) the port is left unsharded.
+//
+   for (i = 1; i < NetShards; i++)
+       {netP[i] = new XrdInet(&Log, &Trace, Police);
+        netP[i]->setDefaults(opts | XRDNET_NOEMSG, blen);
+        if (myDomain) netP[i]->setDomain(myDomain);
+        if ((rc = netP[i]->Bind(port, "tcp")))
+           {sprintf(buff, "shard port %d; port not sharded", port);
+            Log.Emsg("Config", -rc, buff);
+            while(i >= 1) delete netP[i--];
+            delete [] netP;
+            np->setPoller(-1);
+            return;
+           }
+        netP[i]->setDefaults(opts, blen);
+        netP[i]->setPoller(i);
+       }
+
+// Record the shards
+//
+   NetSHD[netidx] = netP;
+   TRACE(NET, "Port " <<port <<" sharded " <<NetShards <<" ways");
+}
+
 /******************************************************************************/
 /*                                 S e t u p                                  */
 /******************************************************************************/
@@ -957,7 +1005,14 @@ int XrdConfig::Setup(char *dfltp)
    XrdLink::Init(&Log, &Trace, &Sched);
    XrdPoll::Init(&Log, &Trace, &Sched);
    if (!XrdLink::Setup(ProtInfo.ConnMax, ProtInfo.idleWait)
-   ||  !XrdPoll::Setup(ProtInfo.ConnMax)) return 1;
+   ||  !XrdPoll::Setup(ProtInfo.ConnMax, (NetShards > 1 ? NetShards : 0),
+                       NetPin, NetPoll)) return 1;
+
+// When ports are sharded every listening socket must allow port reuse
+//
+   if (NetShards > 1) {Net_Opts |= XRDNET_REUSEPORT;
+                       Wan_Opts |= XRDNET_REUSEPORT;
+                      }
 
 // Modify the AdminPath to account for any instance name. Note that there is
 // a negligible memory leak under ceratin path combinations. Not enough to
@@ -1004,10 +1059,11 @@ int XrdConfig::Setup(char *dfltp)
        if (myDomain) NetWAN->setDomain(myDomain);
        if (NetWAN->BindSD((PortWAN > 0 ? PortWAN : 0), "tcp")) return 1;
        PortWAN  = NetWAN->Port();
+       NetTCP[XrdProtLoad::ProtoMax] = NetWAN;
+       if (NetShards > 1) setShards(XrdProtLoad::ProtoMax, Wan_Opts, Wan_Blen);
        wsz      = NetWAN->WSize();
        Wan_Blen = (wsz < Wan_Blen || !Wan_Blen ? wsz : Wan_Blen);
        TRACE(NET,"WAN port " <<PortWAN <<" wsz=" <<Wan_Blen <<" (" <<wsz <<')');
-       NetTCP[XrdProtLoad::ProtoMax] = NetWAN;
       } else {PortWAN = 0; Wan_Blen = 0;}
 
 // Load the protocols. For each new protocol port number, create a new
@@ -1025,6 +1081,7 @@ int XrdConfig::Setup(char *dfltp)
                 NetTCP[NetTCPlep]->setDefaults(Net_Opts, Net_Blen);
              if (myDomain) NetTCP[NetTCPlep]->setDomain(myDomain);
              if (NetTCP[NetTCPlep]->BindSD(cp->port, "tcp")) return 1;
+             if (NetShards > 1) setShards(NetTCPlep, Net_Opts, Net_Blen);
              ProtInfo.Port   = NetTCP[NetTCPlep]->Port();
              ProtInfo.NetTCP = NetTCP[NetTCPlep];
              wsz             = NetTCP[NetTCPlep]->WSize();
@@ -1202,11 +1259,23 @@ int XrdConfig::xhpath(XrdSysError *eDest, XrdOucStream &Config)
 
 /* Function: xbuf
 
-   Purpose:  To parse the directive: buffers [maxbsz <bsz>] <memsz> [<rint>]
+   Purpose:  To parse the directive: buffers [maxbsz <bsz>]
+                                             [arena {off | [hugetlb] <asz>}]
+                                             <memsz> [<rint>]
 
              <bsz>      maximum size of an individualbuffer. The default is 2m.
                         Specify any value 2m < bsz <= 1g; if specified, it must
                         appear before the <memsz> and <memsz> becomes optional.
+             arena      carve buffers of at least <asz> bytes out of 2m huge
+                        page regions. Buffers smaller than 2m are slices of a
+                        region which are kept for reuse. When huge pages are
+                        not available, buffers are allocated as usual. The
+                        default is off. If specified, it must appear before
+                        the <memsz> and <memsz> becomes optional.
+             hugetlb    map regions from the reserved hugetlb pool, falling
+                        back to transparent huge pages when it is exhausted.
+             <asz>      the minimum buffer size, 64k <= asz <= 2m, rounded up
+                        to a power of two.
              <memsz>    maximum amount of memory devoted to buffers
              <rint>     minimum buffer reshape interval in seconds
 
@@ -1218,6 +1287,7 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
     static const long long maxBSZ = 1024*1024*1024; // 1gb
     int bint = -1;
     long long blim;
+    bool htlb;
     char *val;
 
     if (!(val = Config.GetWord()))
@@ -1232,6 +1302,23 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
         if (!(val = Config.GetWord())) return 0;
        }
 
+    if (!strcmp("arena", val))
+       {if (!(val = Config.GetWord()))
+           {eDest->Emsg("Config", "arena buffer size not specified");
+            return 1;
+           }
+        if ((htlb = !strcmp("hugetlb", val)) && !(val = Config.GetWord()))
+           {eDest->Emsg("Config", "arena buffer size not specified");
+            return 1;
+           }
+        if (!strcmp("off", val) && !htlb) blim = 0;
+           else if (XrdOuca2x::a2sz(*eDest, "arena buffer size", val, &blim,
+                                    XrdBuffArena::minSize,
+                                    XrdBuffArena::hpSize)) return 1;
+        XrdGlobal::hpArena.Init((int)blim, htlb);
+        if (!(val = Config.GetWord())) return 0;
+       }
+
     if (XrdOuca2x::a2sz(*eDest,"buffer limit value",val,&blim,
                        (long long)1024*1024)) return 1;
 
@@ -1252,7 +1339,8 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
    Purpose:  To parse directive: network [wan] [[no]keepalive] [buffsz <blen>]
                                          [kaparms parms] [cache <ct>] [[no]dnr]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
-                                         [[no]rpipa]
+                                         [[no]rpipa] [shards <sn>] [[no]pin]
+                                         [[no]uring] [sqpoll]
 
              <rtype>: split | common | local
 
@@ -1264,6 +1352,18 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
              [no]dnr   do [not] perform a reverse DNS lookup if not needed.
              routes    specifies the network configuration (see reference)
              [no]rpipa do [not] resolve private IP addresses.
+             <sn>      the number of listening sockets bound to each port using
+                       SO_REUSEPORT. Each socket has its own accept thread and
+                       poller. The default is 1 (i.e. ports are not sharded).
+             [no]pin   do [not] bind each shard's accept and poller threads to
+                       its own subset of the cpus. The default is nopin.
+             [no]uring do [not] use io_uring instead of epoll to poll links.
+                       The default is nouring. It is ignored if the platform
+                       does not support io_uring. Links of protocols that allow
+                       it have their data received along with the readiness
+                       event, saving a read system call per request.
+             sqpoll    use io_uring with a kernel thread that consumes poll
+                       requests so that enabling a link needs no system call.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1272,7 +1372,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
 {
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_iswan = 0, V_blen = -1, V_ct = -1, V_assumev4;
-    int  v_rpip = -1;
+    int  v_rpip = -1, V_shards = -1, V_pin = -1, V_uring = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
@@ -1289,6 +1389,13 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"routes",     3, 1, 0,         "routes"},
         {"rpipa",      0, 1, &v_rpip,   "rpipa"},
         {"norpipa",    0, 0, &v_rpip,   "norpipa"},
+        {"pin",        0, 1, &V_pin,    "option"},
+        {"nopin",      0, 0, &V_pin,    "option"},
+        {"shards",     2, 1, &V_shards, "network shards"},
+        {"sqpoll",     0, XrdPoll::pollURing|XrdPoll::pollSQPoll,
+                                        &V_uring,  "option"},
+        {"uring",      0, XrdPoll::pollURing, &V_uring, "option"},
+        {"nouring",    0, 0, &V_uring,  "option"},
         {"wan",        0, 1, &V_iswan,  "option"}
        };
     int numopts = sizeof(ntopts)/sizeof(struct netopts);
@@ -1330,6 +1437,11 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
                           ppNet = 1;
                           break;
                          }
+                      if (ntopts[i].hasarg == 2 && ntopts[i].opval)
+                         {if (XrdOuca2x::a2i(*eDest,ntopts[i].etxt,val,&n,1,256))
+                             return 1;
+                          *ntopts[i].oploc = n;
+                         } else
                       if (ntopts[i].hasarg == 2)
                          {if (XrdOuca2x::a2tm(*eDest,ntopts[i].etxt,val,&n,0))
                              return 1;
@@ -1359,6 +1471,9 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
          Net_Opts |= (V_nodnr ? XRDNET_NORLKUP   : 0);
         }
 
+     if (V_shards > 0) NetShards = V_shards;
+     if (V_pin >= 0) NetPin = V_pin != 0;
+     if (V_uring >= 0) NetPoll = V_uring;
      if (V_ct >= 0) XrdNetAddr::SetCache(V_ct);
      if (v_rpip >= 0) XrdInet::netIF.SetRPIPA(v_rpip != 0);
      if (V_assumev4 >= 0) XrdInet::SetAssumeV4(true);
@@ -1667,6 +1782,7 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
 
    Purpose:  To parse directive: sched [mint <mint>] [maxt <maxt>] [avlt <at>]
                                        [idle <idle>] [stksz <qnt>] [core <cv>]
+                                       [queues {<qn> | cpu}]
 
              <mint>   is the minimum number of threads that we need. Once
                       this number of threads is created, it does not decrease.
@@ -1683,6 +1799,10 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
              <idle>   The time (in time spec) between checks for underused
                       threads. Those found will be terminated. Default is 780.
              <qnt>    The thread stack size in bytes or K, M, or G.
+             <qn>     The number of work queues. When greater than one, each
+                      worker thread has a home queue and steals work from
+                      other queues when its own queue is empty. Specify cpu
+                      to use one queue per online processor. The default is 1.
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -1692,7 +1812,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
     char *val;
     long long lpp;
     int  i, ppp = 0;
-    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1;
+    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1, V_ques = 0;
     struct schedopts {const char *opname; int minv; int *oploc;
                       const char *opmsg;} scopts[] =
        {
@@ -1701,7 +1821,8 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
         {"maxt",       1, &V_maxt, "sched maxt"},
         {"avlt",       1, &V_avlt, "sched avlt"},
         {"core",       1,       0, "sched core"},
-        {"idle",       0, &V_idle, "sched idle"}
+        {"idle",       0, &V_idle, "sched idle"},
+        {"queues",     1, &V_ques, "sched queues"}
        };
     int numopts = sizeof(scopts)/sizeof(struct schedopts);
 
@@ -1734,6 +1855,10 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
                             XrdSysThread::setStackSize((size_t)lpp);
                             break;
                            }
+                   else if (*scopts[i].opname == 'q' && !strcmp("cpu", val))
+                           {if ((ppp = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+                               ppp = 1;
+                           }
                    else if (XrdOuca2x::a2i(*eDest, scopts[i].opmsg, val,
                                      &ppp,scopts[i].minv)) return 1;
                    *scopts[i].oploc = ppp;
@@ -1760,6 +1885,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
 // Establish scheduler options
 //
    Sched.setParms(V_mint, V_maxt, V_avlt, V_idle);
+   if (V_ques) Sched.setQueues(V_ques);
    return 0;
 }
 
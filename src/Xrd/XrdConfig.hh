@@ -59,6 +59,10 @@ int         ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest=0);
 XrdProtocol_Config  ProtInfo;
 XrdInet            *NetADM;
 XrdInet            *NetTCP[XrdProtLoad::ProtoMax+1];
+XrdInet           **NetSHD[XrdProtLoad::ProtoMax+1]; // Sharded NetTCP sockets
+int                 NetShards;    // Number of sockets per port (1 -> unsharded)
+bool                NetPin;       // Bind each shard's threads to a cpu set
+int                 NetPoll;      // XrdPoll options (e.g. use io_uring)
 
 private:
 
@@ -68,6 +72,7 @@ int   getUG(char *parm, uid_t &theUid, gid_t &theGid);
 void  Manifest(const char *pidfn);
 void  setCFG();
 int   setFDL();
+void  setShards(int netidx, int opts, int blen);
 int   Setup(char *dfltp);
 void  Usage(int rc);
 int   xallow(XrdSysError *edest, XrdOucStream &Config);
@@ -57,8 +57,14 @@ XrdLink    *Connect(const char *host, int port, int opts=0, int timeout=-1);
 
 void        Secure(XrdNetSecurity *secp);
 
+// setPoller() directs links accepted on this network to a specific poller.
+// This is used when a port is sharded across several SO_REUSEPORT sockets.
+//
+void        setPoller(int pnum) {pollNum = pnum;}
+
             XrdInet(XrdSysError *erp, XrdOucTrace *tP, XrdNetSecurity *secp=0)
-                      : XrdNet(erp,0), Patrol(secp), XrdTrace(tP) {}
+                      : XrdNet(erp,0), Patrol(secp), XrdTrace(tP),
+                        pollNum(-1) {}
            ~XrdInet() {}
 
 static void SetAssumeV4(bool newVal) {AssumeV4 = newVal;}
@@ -73,6 +79,7 @@ int Listen();
 
 XrdNetSecurity    *Patrol;
 XrdOucTrace       *XrdTrace;
+int                pollNum;
 static const char *TraceID;
 static  bool       AssumeV4;
 };
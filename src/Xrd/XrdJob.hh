@@ -49,10 +49,14 @@ const char *Comment;   // -> Description of work for debugging (static!)
 virtual void  DoIt() = 0;
 
               XrdJob(const char *desc="")
-                    {Comment = desc; NextJob = 0; SchedTime = 0;}
+                    {Comment = desc; NextJob = 0; PrevJob = 0;
+                     SchedTime = 0; TimerSlot = -1;
+                    }
 virtual      ~XrdJob() {}
 
 private:
-time_t      SchedTime; // -> Time job is to be scheduled
+XrdJob     *PrevJob;   // -> Previous job in the timer wheel slot
+long long   SchedTime; // -> Time (milliseconds) job is to be scheduled
+int         TimerSlot; // -> Timer wheel slot holding the job (-1 if none)
 };
 #endif
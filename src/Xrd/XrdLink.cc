@@ -49,6 +49,10 @@
 
 #endif
 
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
 #include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysFD.hh"
@@ -97,6 +101,54 @@ int                idleTicks;
 static const char *TraceID;
 };
   
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+#ifdef __linux__
+namespace
+{
+// Data spliced from a file must pass through a pipe. Each thread keeps its
+// own pipe so that links need not have one each.
+//
+pthread_key_t  pipeKey;
+pthread_once_t pipeOnce = PTHREAD_ONCE_INIT;
+
+void pipeDrop(void *pP)
+{
+   int *pfd = static_cast<int *>(pP);
+   close(pfd[0]); close(pfd[1]);
+   delete [] pfd;
+}
+
+void pipeKeyInit() {pthread_key_create(&pipeKey, pipeDrop);}
+
+int *pipeGet()
+{
+   int *pfd;
+
+   pthread_once(&pipeOnce, pipeKeyInit);
+   if ((pfd = static_cast<int *>(pthread_getspecific(pipeKey)))) return pfd;
+
+   pfd = new int[2];
+   if (pipe2(pfd, O_CLOEXEC)) {delete [] pfd; return 0;}
+#ifdef F_SETPIPE_SZ
+   fcntl(pfd[1], F_SETPIPE_SZ, 1024*1024); // Larger chunks if we may
+#endif
+   pthread_setspecific(pipeKey, pfd);
+   return pfd;
+}
+
+// A pipe that still holds data can't be reused
+//
+void pipeReset(int *pfd)
+{
+   pthread_setspecific(pipeKey, 0);
+   pipeDrop(pfd);
+}
+}
+#endif
+
 /******************************************************************************/
 /*                               S t a t i c s                                */
 /******************************************************************************/
@@ -129,6 +181,8 @@ static const char *TraceID;
        int             XrdLink::LinkTimeOuts  = 0;
        int             XrdLink::LinkStalls    = 0;
        int             XrdLink::LinkSfIntr    = 0;
+       int             XrdLink::LinkSendFile  = 0;
+       int             XrdLink::LinkSplice    = 0;
        int             XrdLink::maxFD         = 0;
        XrdSysMutex     XrdLink::statsMutex;
 
@@ -137,12 +191,6 @@ static const char *TraceID;
        short           XrdLink::killWait= 3;  // Kill then wait
        short           XrdLink::waitKill= 4;  // Wait then kill
 
-// The following values are defined for LinkBat[]. We assume that FREE is 0
-//
-#define XRDLINK_FREE 0x00
-#define XRDLINK_USED 0x01
-#define XRDLINK_IDLE 0x02
-  
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -151,6 +199,8 @@ XrdLink::XrdLink() : XrdJob("connection"), IOSemaphore(0, "link i/o")
 {
   Etext = 0;
   HostName = 0;
+  uState   = 0;
+  rdStash  = 0;
   Reset();
 }
 
@@ -177,11 +227,14 @@ void XrdLink::Reset()
   SfIntr   = 0;
   InUse    = 1;
   Poller   = 0; 
+  PollHint = -1;
   PollEnt  = 0;
   isEnabled= 0;
   isIdle   = 0;
   inQ      = 0;
   isBridged= 0;
+  rdAhead  = 0;
+  rdBeg    = rdEnd = 0;
   BytesOut = BytesIn = BytesOutTot = BytesInTot = 0;
   doPost   = 0;
   LockReads= 0;
@@ -191,6 +244,16 @@ void XrdLink::Reset()
   KillCnt  = 0;
 }
 
+/******************************************************************************/
+/*                            a d d I O S t a t s                             */
+/******************************************************************************/
+
+void XrdLink::addIOStats(long long inbytes, long long outbytes)
+{
+   if (inbytes  > 0) AtomicAdd(BytesIn,  inbytes);
+   if (outbytes > 0) AtomicAdd(BytesOut, outbytes);
+}
+
 /******************************************************************************/
 /*                                 A l l o c                                  */
 /******************************************************************************/
@@ -211,34 +274,40 @@ XrdLink *XrdLink::Alloc(XrdNetAddr &peer, int opts)
        return (XrdLink *)0;
       }
 
-// Make sure that the link slot is available
+// Claim the link slot. Nobody else can use it until we mark it as used.
 //
-   LTMutex.Lock();
-   if (LinkBat[peerFD])
-      {LTMutex.UnLock();
-       XrdLog->Emsg("Link", "attempt to reuse active link");
+   if (!LTClaim(peerFD, XRDLINK_FREE, XRDLINK_INIT))
+      {XrdLog->Emsg("Link", "attempt to reuse active link");
        return (XrdLink *)0;
       }
 
 // Check if we already have a link object in this slot. If not, allocate
-// a quantum of link objects and put them in the table.
+// a quantum of link objects and put them in the table. Only this needs the
+// LTMutex as slots, once set, never change.
 //
    if (!(lp = LinkTab[peerFD]))
-      {unsigned int i;
-       XrdLink **blp, *nlp = new XrdLink[LinkAlloc]();
-       if (!nlp)
-          {LTMutex.UnLock();
-           XrdLog->Emsg("Link", ENOMEM, "create link"); 
-           return (XrdLink *)0;
+      {LTMutex.Lock();
+       if (!(lp = LinkTab[peerFD]))
+          {unsigned int i;
+           XrdLink **blp, *nlp = new XrdLink[LinkAlloc]();
+           if (!nlp)
+              {LTMutex.UnLock();
+               LTClaim(peerFD, XRDLINK_INIT, XRDLINK_FREE);
+               XrdLog->Emsg("Link", ENOMEM, "create link");
+               return (XrdLink *)0;
+              }
+           blp = &LinkTab[peerFD/LinkAlloc*LinkAlloc];
+           for (i = 0; i < LinkAlloc; i++, blp++) *blp = &nlp[i];
+           lp = LinkTab[peerFD];
           }
-       blp = &LinkTab[peerFD/LinkAlloc*LinkAlloc];
-       for (i = 0; i < LinkAlloc; i++, blp++) *blp = &nlp[i];
-       lp = LinkTab[peerFD];
+       LTMutex.UnLock();
       }
-      else lp->Reset();
-   LinkBat[peerFD] = XRDLINK_USED;
-   if (peerFD > LTLast) LTLast = peerFD;
-   LTMutex.UnLock();
+
+// Initialize the link while holding its opMutex. Table scanners lock the
+// link before looking at anything in it.
+//
+   lp->opMutex.Lock();
+   lp->Reset();
 
 // Establish the instance number of this link. This is will prevent us from
 // sending asynchronous responses to the wrong client when the file descriptor
@@ -268,6 +337,12 @@ XrdLink *XrdLink::Alloc(XrdNetAddr &peer, int opts)
 //
    lp->LockReads = (0 != (opts & XRDLINK_RDLOCK));
    lp->KeepFD    = (0 != (opts & XRDLINK_NOCLOSE));
+   lp->opMutex.UnLock();
+
+// Publish the link
+//
+   LTRaise(peerFD);
+   LTClaim(peerFD, XRDLINK_INIT, XRDLINK_USED);
 
 // Update statistics and return the link. We need to actually get the stats
 // mutex even when using atomics because we need to use compound operations.
@@ -390,20 +465,16 @@ int XrdLink::Close(int defer)
                  KillcvP->UnLock(); KillcvP = 0;
                 }
 
-// Remove ourselves from the poll table and then from the Link table. We may
-// not hold on to the opMutex when we acquire the LTMutex. However, the link
-// table needs to be cleaned up prior to actually closing the socket. So, we
-// do some fancy footwork to prevent multiple closes of this link.
+// Remove ourselves from the poll table and then from the Link table. The
+// link table needs to be cleaned up prior to actually closing the socket. So,
+// we do some fancy footwork to prevent multiple closes of this link.
 //
    fd = (FD < 0 ? -FD : FD);
    if (FD != -1)
       {if (Poller) {XrdPoll::Detach(this); Poller = 0;}
        FD = -1;
        opHelper.UnLock();
-       LTMutex.Lock();
-       LinkBat[fd] = XRDLINK_FREE;
-       if (fd == LTLast) while(LTLast && !(LinkBat[LTLast])) LTLast--;
-       LTMutex.UnLock();
+       LTClaim(fd, XRDLINK_USED, XRDLINK_FREE);
       } else opHelper.UnLock();
 
 // Close the file descriptor if it isn't being shared. Do it as the last
@@ -465,41 +536,53 @@ void XrdLink::Enable()
 XrdLink *XrdLink::Find(int &curr, XrdLinkMatch *who)
 {
    XrdLink *lp;
-   const int MaxSeek = 16;
    unsigned int myINS;
-   int i, seeklim = MaxSeek;
+   int i, ltlast = AtomicGet(LTLast);
 
 // Do initialization
 //
-   LTMutex.Lock();
    if (curr >= 0 && LinkTab[curr]) LinkTab[curr]->setRef(-1);
       else curr = -1;
 
-// Find next matching link. Since this may take some time, we periodically
-// release the LTMutex lock which drives up overhead but will still allow
-// other critical operations to occur.
-//
-   for (i = curr+1; i <= LTLast; i++)
-       {if ((lp = LinkTab[i]) && LinkBat[i] && lp->HostName)
-           if (!who 
-           ||   who->Match(lp->ID,lp->Lname-lp->ID-1,lp->HostName,lp->HNlen))
-              {myINS = lp->Instance;
-               LTMutex.UnLock();
-               lp->setRef(1);
-               curr = i;
-               if (myINS == lp->Instance) return lp;
-               LTMutex.Lock();
-              }
-        if (!seeklim--) {LTMutex.UnLock(); seeklim = MaxSeek; LTMutex.Lock();}
+// Find next matching link. We do not lock the table as link objects are never
+// deleted. Instead, we lock each candidate link and make sure it is still in
+// use before looking at it.
+//
+   for (i = curr+1; i <= ltlast; i++)
+       {if (LinkBat[i] != XRDLINK_USED || !(lp = LinkTab[i])) continue;
+        lp->opMutex.Lock();
+        if (LinkBat[i] == XRDLINK_USED && lp->HostName && (!who
+        ||  who->Match(lp->ID,lp->Lname-lp->ID-1,lp->HostName,lp->HNlen)))
+           {myINS = lp->Instance;
+            lp->opMutex.UnLock();
+            lp->setRef(1);
+            curr = i;
+            if (myINS == lp->Instance) return lp;
+           } else lp->opMutex.UnLock();
        }
 
 // Done scanning the table
 //
-    LTMutex.UnLock();
     curr = -1;
     return 0;
 }
 
+/******************************************************************************/
+/* private                      g e t A h e a d                               */
+/******************************************************************************/
+
+// The caller must hold the read lock, if one is needed
+
+int XrdLink::getAhead(char *Buff, int Blen, bool peek)
+{
+   int alen = rdEnd - rdBeg;
+
+   if (alen > Blen) alen = Blen;
+   memcpy(Buff, rdStash+rdBeg, alen);
+   if (!peek) rdBeg += alen;
+   return alen;
+}
+
 /******************************************************************************/
 /*                               g e t N a m e                                */
 /******************************************************************************/
@@ -511,26 +594,22 @@ XrdLink *XrdLink::Find(int &curr, XrdLinkMatch *who)
 int XrdLink::getName(int &curr, char *nbuf, int nbsz, XrdLinkMatch *who)
 {
    XrdLink *lp;
-   const int MaxSeek = 16;
-   int i, ulen = 0, seeklim = MaxSeek;
+   int i, ulen = 0, ltlast = AtomicGet(LTLast);
 
-// Find next matching link. Since this may take some time, we periodically
-// release the LTMutex lock which drives up overhead but will still allow
-// other critical operations to occur.
+// Find next matching link. As in Find(), only the candidate link is locked.
 //
-   LTMutex.Lock();
-   for (i = curr+1; i <= LTLast; i++)
-       {if ((lp = LinkTab[i]) && LinkBat[i] && lp->HostName)
-           if (!who 
-           ||   who->Match(lp->ID,lp->Lname-lp->ID-1,lp->HostName,lp->HNlen))
-              {ulen = lp->Client(nbuf, nbsz);
-               LTMutex.UnLock();
-               curr = i;
-               return ulen;
-              }
-        if (!seeklim--) {LTMutex.UnLock(); seeklim = MaxSeek; LTMutex.Lock();}
+   for (i = curr+1; i <= ltlast; i++)
+       {if (LinkBat[i] != XRDLINK_USED || !(lp = LinkTab[i])) continue;
+        lp->opMutex.Lock();
+        if (LinkBat[i] == XRDLINK_USED && lp->HostName && (!who
+        ||  who->Match(lp->ID,lp->Lname-lp->ID-1,lp->HostName,lp->HNlen)))
+           {ulen = lp->Client(nbuf, nbsz);
+            lp->opMutex.UnLock();
+            curr = i;
+            return ulen;
+           }
+        lp->opMutex.UnLock();
        }
-   LTMutex.UnLock();
 
 // Done scanning the table
 //
@@ -538,6 +617,46 @@ int XrdLink::getName(int &curr, char *nbuf, int nbsz, XrdLinkMatch *who)
    return 0;
 }
 
+/******************************************************************************/
+/* Private:                      L T C l a i m                                */
+/******************************************************************************/
+
+// Atomically change the state of a link table slot. Returns true if the slot
+// was in oldState and has been set to newState; false otherwise.
+//
+bool XrdLink::LTClaim(int fd, char oldState, char newState)
+{
+#ifdef HAVE_ATOMICS
+   return __sync_bool_compare_and_swap(&LinkBat[fd], oldState, newState);
+#else
+   XrdSysMutexHelper ltHelp(LTMutex);
+   if (LinkBat[fd] != oldState) return false;
+   LinkBat[fd] = newState;
+   return true;
+#endif
+}
+
+/******************************************************************************/
+/* Private:                      L T R a i s e                                */
+/******************************************************************************/
+
+// Raise the link table high water mark to include fd. The mark never goes
+// down as it is only used to bound table scans.
+//
+void XrdLink::LTRaise(int fd)
+{
+#ifdef HAVE_ATOMICS
+   int ltlast;
+
+   while((ltlast = LTLast) < fd
+      && !__sync_bool_compare_and_swap(&LTLast, ltlast, fd)) {}
+#else
+   LTMutex.Lock();
+   if (fd > LTLast) LTLast = fd;
+   LTMutex.UnLock();
+#endif
+}
+
 /******************************************************************************/
 /*                                  P e e k                                   */
 /******************************************************************************/
@@ -553,9 +672,22 @@ int XrdLink::Peek(char *Buff, int Blen, int timeout)
 //
    if (LockReads) theMutex.Lock(&rdMutex);
 
-// Wait until we can actually read something
+// Data received ahead by the poller is returned first along with whatever
+// else may be queued. There is no need to wait as we have some data.
 //
    isIdle = 0;
+   if (rdBeg < rdEnd)
+      {retc = getAhead(Buff, Blen, true);
+       if (retc < Blen)
+          {do {mlen = recv(FD, Buff+retc, Blen-retc, MSG_PEEK|MSG_DONTWAIT);}
+              while(mlen < 0 && errno == EINTR);
+           if (mlen > 0) retc += mlen;
+          }
+       return retc;
+      }
+
+// Wait until we can actually read something
+//
    do {retc = poll(&polltab, 1, timeout);} while(retc < 0 && errno == EINTR);
    if (retc != 1)
       {if (retc == 0) return 0;
@@ -595,7 +727,8 @@ int XrdLink::Recv(char *Buff, int Blen)
 //
    if (LockReads) rdMutex.Lock();
    isIdle = 0;
-   do {rlen = read(FD, Buff, Blen);} while(rlen < 0 && errno == EINTR);
+   if (rdBeg < rdEnd) rlen = getAhead(Buff, Blen);
+      else do {rlen = read(FD, Buff, Blen);} while(rlen < 0 && errno == EINTR);
    if (rlen > 0) AtomicAdd(BytesIn, rlen);
    if (LockReads) rdMutex.UnLock();
 
@@ -617,9 +750,16 @@ int XrdLink::Recv(char *Buff, int Blen, int timeout)
 //
    if (LockReads) theMutex.Lock(&rdMutex);
 
-// Wait up to timeout milliseconds for data to arrive
+// Start with any data the poller received ahead
 //
    isIdle = 0;
+   if (rdBeg < rdEnd)
+      {totlen = getAhead(Buff, Blen);
+       Buff += totlen; Blen -= totlen;
+      }
+
+// Wait up to timeout milliseconds for data to arrive
+//
    while(Blen > 0)
         {do {retc = poll(&polltab,1,timeout);} while(retc < 0 && errno == EINTR);
          if (retc != 1)
@@ -666,7 +806,19 @@ int XrdLink::RecvAll(char *Buff, int Blen, int timeout)
 {
    struct pollfd polltab = {FD, POLLIN|POLLRDNORM, 0};
    ssize_t rlen;
-   int     retc;
+   int     retc, alen = 0;
+
+// Data received ahead by the poller counts as data having arrived. So, there
+// is no need to wait for some after taking it.
+//
+   if (rdBeg < rdEnd)
+      {if (LockReads) rdMutex.Lock();
+       alen = getAhead(Buff, Blen);
+       if (LockReads) rdMutex.UnLock();
+       AtomicAdd(BytesIn, alen);
+       if (alen == Blen) return Blen;
+       Buff += alen; Blen -= alen; timeout = -1;
+      }
 
 // Check if timeout specified. Notice that the timeout is the max we will
 // for some data. We will wait forever for all the data. Yeah, it's weird.
@@ -692,7 +844,7 @@ int XrdLink::RecvAll(char *Buff, int Blen, int timeout)
    if (rlen > 0) AtomicAdd(BytesIn, rlen);
    if (LockReads) rdMutex.UnLock();
 
-   if (int(rlen) == Blen) return Blen;
+   if (int(rlen) == Blen) return Blen + alen;
    if (!rlen) {TRACEI(DEBUG, "No RecvAll() data; errno=" <<errno);}
       else if (rlen > 0) XrdLog->Emsg("RecvAll","Premature end from", ID);
               else if (FD >= 0) XrdLog->Emsg("Link",errno,"recieve from",ID);
@@ -876,7 +1028,7 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
    static const int setON = 1, setOFF = 0;
    ssize_t retc = 0, bytesleft;
    off_t myOffset;
-   int i, xfrbytes = 0, uncork = 1, xIntr = 0;
+   int i, xfrbytes = 0, uncork = 1, xIntr = 0, nSF = 0, nSP = 0;
 
 // lock the link
 //
@@ -891,19 +1043,31 @@ do{retc = sendfilev(FD, vecSFP, sfN, &xframt);
        uncork = 0; sfOK = 0;
       }
 
-// Send the header first
+// Send the header first. Should the descriptor not support sendfile() (e.g.
+// a pipe or certain fuse and plugin descriptors) we splice the data instead.
 //
    for (i = 0; i < sfN; sfP++, i++)
        {if (sfP->fdnum < 0) retc = sendData(sfP->buffer, sfP->sendsz);
            else {myOffset = sfP->offset; bytesleft = sfP->sendsz;
-                 while(bytesleft
+                 if (myOffset != XrdOucSFVec::sfPipe)
+                    while(bytesleft
                     && (retc=sendfile(FD,sfP->fdnum,&myOffset,bytesleft)) > 0)
-                      {bytesleft -= retc; xIntr++;}
+                         {bytesleft -= retc; xIntr++;}
+                 if (bytesleft && (myOffset == XrdOucSFVec::sfPipe
+                               || (retc < 0 && (errno == EINVAL
+                                            ||  errno == ENOSYS))))
+                    {retc = sendSplice(sfP->fdnum,
+                              (myOffset == XrdOucSFVec::sfPipe ? 0 : &myOffset),
+                              bytesleft);
+                     nSP++;
+                    } else nSF++;
                 }
         if (retc <  0 && errno == EINTR) continue;
         if (retc <= 0) break;
         xfrbytes += sfP->sendsz;
        }
+   if (nSF) AtomicAdd(LinkSendFile, nSF);
+   if (nSP) AtomicAdd(LinkSplice,   nSP);
 
 // Diagnose any sendfile errors
 //
@@ -952,6 +1116,59 @@ int XrdLink::sendData(const char *Buff, int Blen)
    return retc;
 }
 
+/******************************************************************************/
+/* private                    s e n d S p l i c e                             */
+/******************************************************************************/
+
+// Returns a positive value upon success and is otherwise just like sendfile()
+// The caller must hold the wrMutex. When offP is nil, fd must be a pipe.
+  
+int XrdLink::sendSplice(int fd, off_t *offP, int Blen)
+{
+#ifndef __linux__
+   errno = ENOTSUP;
+   return -1;
+#else
+   static const unsigned int spFlags = SPLICE_F_MOVE | SPLICE_F_MORE;
+   ssize_t inlen, retc = 0;
+   int *pfd;
+
+// A pipe can be spliced directly into the socket
+//
+   if (!offP)
+      {while(Blen > 0)
+            {if ((retc = splice(fd, 0, FD, 0, Blen, spFlags)) <= 0)
+                {if (retc < 0 && errno == EINTR) continue;
+                 return retc;
+                }
+             Blen -= retc;
+            }
+       return 1;
+      }
+
+// Otherwise, the data needs to pass through our pipe. The kernel only moves
+// page references so no data is copied.
+//
+   if (!(pfd = pipeGet())) return -1;
+   while(Blen > 0)
+        {if ((inlen = splice(fd, offP, pfd[1], 0, Blen, spFlags)) <= 0)
+            {if (inlen < 0 && errno == EINTR) continue;
+             return inlen;
+            }
+         Blen -= inlen;
+         while(inlen > 0)
+              {if ((retc = splice(pfd[0], 0, FD, 0, inlen, spFlags)) <= 0)
+                  {if (retc < 0 && errno == EINTR) continue;
+                   pipeReset(pfd);
+                   return retc;
+                  }
+               inlen -= retc;
+              }
+        }
+   return 1;
+#endif
+}
+
 /******************************************************************************/
 /*                              s e t E t e x t                               */
 /******************************************************************************/
@@ -1179,17 +1396,18 @@ int XrdLink::Stats(char *buff, int blen, int do_sync)
    static const char statfmt[] = "<stats id=\"link\"><num>%d</num>"
           "<maxn>%d</maxn><tot>%lld</tot><in>%lld</in><out>%lld</out>"
           "<ctime>%lld</ctime><tmo>%d</tmo><stall>%d</stall>"
-          "<sfps>%d</sfps></stats>";
+          "<sfps>%d</sfps><sf>%d</sf><spl>%d</spl>%s</stats>";
+   char sqStats[256];
    int i, myLTLast;
 
 // Check if actual length wanted
 //
-   if (!buff) return sizeof(statfmt)+17*6;
+   if (!buff) return sizeof(statfmt)+17*8+XrdSendQ::Stats(0, 0);
 
 // We must synchronize the statistical counters
 //
    if (do_sync)
-      {LTMutex.Lock(); myLTLast = LTLast; LTMutex.UnLock();
+      {myLTLast = AtomicGet(LTLast);
        for (i = 0; i <= myLTLast; i++) 
            if (LinkBat[i] == XRDLINK_USED && LinkTab[i]) 
               LinkTab[i]->syncStats();
@@ -1197,6 +1415,7 @@ int XrdLink::Stats(char *buff, int blen, int do_sync)
 
 // Obtain lock on the stats area and format it
 //
+   XrdSendQ::Stats(sqStats, sizeof(sqStats));
    AtomicBeg(statsMutex);
    i = snprintf(buff, blen, statfmt, AtomicGet(LinkCount),
                                      AtomicGet(LinkCountMax),
@@ -1206,7 +1425,9 @@ int XrdLink::Stats(char *buff, int blen, int do_sync)
                                      AtomicGet(LinkConTime),
                                      AtomicGet(LinkTimeOuts),
                                      AtomicGet(LinkStalls),
-                                     AtomicGet(LinkSfIntr));
+                                     AtomicGet(LinkSfIntr),
+                                     AtomicGet(LinkSendFile),
+                                     AtomicGet(LinkSplice), sqStats);
    AtomicEnd(statsMutex);
    return i;
 }
@@ -1364,6 +1585,38 @@ int XrdLink::Terminate(const XrdLink *owner, int fdnum, unsigned int inst)
    return wTime;
 }
 
+/******************************************************************************/
+/*                             W a i t 4 D a t a                              */
+/******************************************************************************/
+
+int XrdLink::Wait4Data(int timeout)
+{
+   struct pollfd polltab = {FD, POLLIN|POLLRDNORM, 0};
+   int retc;
+
+// Data received ahead by the poller is immediately available
+//
+   isIdle = 0;
+   if (rdBeg < rdEnd) return 1;
+
+// Wait up to timeout milliseconds for data to arrive
+//
+   do {retc = poll(&polltab,1,timeout);} while(retc < 0 && errno == EINTR);
+   if (retc != 1)
+      {if (retc == 0) {tardyCnt++; return 0;}
+       return (FD >= 0 ? XrdLog->Emsg("Link", -errno, "poll", ID) : -1);
+      }
+
+// Verify it is safe to read now
+//
+   if (!(polltab.revents & (POLLIN|POLLRDNORM)))
+      {XrdLog->Emsg("Link", XrdPoll::Poll2Text(polltab.revents),
+                           "polling", ID);
+       return -1;
+      }
+   return 1;
+}
+
 /******************************************************************************/
 /*                              i d l e S c a n                               */
 /******************************************************************************/
@@ -1378,9 +1631,7 @@ void XrdLinkScan::idleScan()
 
 // Get the current link high watermark
 //
-   XrdLink::LTMutex.Lock();
-   ltlast = XrdLink::LTLast;
-   XrdLink::LTMutex.UnLock();
+   ltlast = AtomicGet(XrdLink::LTLast);
 
 // Scan across all links looking for idle links. Links are never deallocated
 // so we don't need any special kind of lock for these
@@ -48,6 +48,18 @@
 #define XRDLINK_RDLOCK  0x0001
 #define XRDLINK_NOCLOSE 0x0002
 
+/******************************************************************************/
+/*                   X r d L i n k   S l o t   S t a t e s                    */
+/******************************************************************************/
+
+// The following values are defined for LinkBat[]. We assume that FREE is 0.
+// A slot is INIT while it is being claimed and the link is being initialized.
+//
+#define XRDLINK_FREE 0x00
+#define XRDLINK_USED 0x01
+#define XRDLINK_IDLE 0x02
+#define XRDLINK_INIT 0x04
+
 /******************************************************************************/
 /*                      C l a s s   D e f i n i t i o n                       */
 /******************************************************************************/
@@ -68,6 +80,7 @@ friend class XrdPoll;
 friend class XrdPollPoll;
 friend class XrdPollDev;
 friend class XrdPollE;
+friend class XrdPollU;
 
 //-----------------------------------------------------------------------------
 //! Obtain the address information for this link.
@@ -92,6 +105,16 @@ XrdNetAddrInfo *AddrInfo() {return (XrdNetAddrInfo *)&Addr;}
 
 static XrdLink *Alloc(XrdNetAddr &peer, int opts=0);
 
+//-----------------------------------------------------------------------------
+//! Account for data that a protocol moved over the link's socket by itself
+//! (e.g. kernel TLS) so that the link statistics remain accurate.
+//!
+//! @param  inbytes   the number of bytes received.
+//! @param  outbytes  the number of bytes sent.
+//-----------------------------------------------------------------------------
+
+void          addIOStats(long long inbytes, long long outbytes);
+
 int           Backlog();
 
 void          Bind() {}                // Obsolete
@@ -109,12 +132,12 @@ int           FDnum() {int fd = FD; return (fd < 0 ? -fd : fd);}
 
 static XrdLink *fd2link(int fd)
                 {if (fd < 0) fd = -fd; 
-                 return (fd <= LTLast && LinkBat[fd] ? LinkTab[fd] : 0);
+                 return (fd <= LTLast && LinkBat[fd] == XRDLINK_USED ? LinkTab[fd] : 0);
                 }
 
 static XrdLink *fd2link(int fd, unsigned int inst)
                 {if (fd < 0) fd = -fd; 
-                 if (fd <= LTLast && LinkBat[fd] && LinkTab[fd]
+                 if (fd <= LTLast && LinkBat[fd] == XRDLINK_USED && LinkTab[fd]
                  && LinkTab[fd]->Instance == inst) return LinkTab[fd];
                  return (XrdLink *)0;
                 }
@@ -228,8 +251,25 @@ void          setLocation(XrdNetAddrInfo::LocInfo &loc) {Addr.SetLocation(loc);}
 
 bool          setNB();
 
+//-----------------------------------------------------------------------------
+//! Set the poller that this link should be attached to.
+//!
+//! @param  pnum    the poller number or -1 to let the poller pick one.
+//-----------------------------------------------------------------------------
+inline
+void          setPollHint(int pnum) {PollHint = static_cast<short>(pnum);}
+
 XrdProtocol  *setProtocol(XrdProtocol *pp);
 
+//-----------------------------------------------------------------------------
+//! Allow the poller to receive data along with the link becoming ready. This
+//! is only honored by pollers that can do so (i.e. io_uring) and should only
+//! be set by protocols that read the link solely via Peek(), Recv(), and
+//! RecvAll() and never via the socket itself.
+//-----------------------------------------------------------------------------
+inline
+void          setRecvAhead() {rdAhead = 1;}
+
 void          setRef(int cnt);                          // ASYNC Mode
 
 static int    Setup(int maxfd, int idlewait);
@@ -246,6 +286,19 @@ time_t        timeCon() {return conTime;}
 
 int           UseCnt() {return InUse;}
 
+//-----------------------------------------------------------------------------
+//! Wait for data to arrive on the link without reading it. This is meant for
+//! protocols that must read the link's socket by itself (e.g. kernel TLS).
+//!
+//! @param  timeout   the maximum number of milliseconds to wait.
+//!
+//! @return =1        data is available.
+//!         =0        the timeout expired; it is counted as a tardy read.
+//!         <0        the link failed.
+//-----------------------------------------------------------------------------
+
+int           Wait4Data(int timeout);
+
 void          armBridge() {isBridged = 1;}
 int           hasBridge() {return isBridged;}
 
@@ -254,19 +307,23 @@ int           hasBridge() {return isBridged;}
 
 private:
 
+static bool   LTClaim(int fd, char oldState, char newState);
+static void   LTRaise(int fd);
+int    getAhead(char *Buff, int Blen, bool peek=false);
 void   Reset();
 int    sendData(const char *Buff, int Blen);
+int    sendSplice(int fd, off_t *offP, int Blen);
 
 static XrdSysError  *XrdLog;
 static XrdOucTrace  *XrdTrace;
 static XrdScheduler *XrdSched;
 static XrdInet      *XrdNetTCP;
 
-static XrdSysMutex   LTMutex;    // For the LinkTab only LTMutex->IOMutex allowed
-static XrdLink     **LinkTab;
-static char         *LinkBat;
+static XrdSysMutex   LTMutex;    // For LinkTab allocation only LTMutex->IOMutex
+static XrdLink     **LinkTab;    // Slots are set once and never change
+static char         *LinkBat;    // Slot state, changed only via LTClaim()
 static unsigned int  LinkAlloc;
-static int           LTLast;
+static int           LTLast;     // High water mark, changed only via LTRaise()
 static const char   *TraceID;
 static int           devNull;
 static short         killWait;
@@ -283,6 +340,8 @@ static int          LinkCountMax;
 static int          LinkTimeOuts;
 static int          LinkStalls;
 static int          LinkSfIntr;
+static int          LinkSendFile;   // Segments sent via sendfile()
+static int          LinkSplice;     // Segments sent via splice()
 static int          maxFD;
        long long        BytesIn;
        long long        BytesInTot;
@@ -330,6 +389,12 @@ char                isIdle;
 char                inQ;    // Only used by PollPoll.icc
 char                isBridged;
 char                KillCnt;        // Protected by opMutex!
+short               PollHint;       // Preferred poller or -1 for any
+char                uState;         // Only used by PollU.icc
+char                rdAhead;        // Poller may receive data ahead
+char               *rdStash;        // Data received ahead (only by PollU.icc)
+int                 rdBeg;          // Offset of first unread byte in rdStash
+int                 rdEnd;          // Offset past last byte in rdStash
 static const char   KillMax =   60;
 static const char   KillMsk = 0x7f;
 static const char   KillXwt = 0x80;
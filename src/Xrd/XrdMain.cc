@@ -91,6 +91,7 @@ XrdSysSemaphore  *theSem;
 XrdProtocol      *theProt;
 XrdInet          *theNet;
 int               thePort;
+int               theShard;
 static XrdConfig  Config;
 
 void              DoIt() {XrdLink *newlink;
@@ -101,9 +102,11 @@ void              DoIt() {XrdLink *newlink;
                          }
 
            XrdMain() : XrdJob("main accept"), theSem(0), theProt(0),
-                                              theNet(0), thePort(0) {}
-           XrdMain(XrdInet *nP) : XrdJob("main accept"), theSem(0),
-                                  theProt(0), theNet(nP), thePort(nP->Port()) {}
+                                              theNet(0), thePort(0),
+                                              theShard(0) {}
+           XrdMain(XrdInet *nP, int snum=0) : XrdJob("main accept"),
+                                  theSem(0), theProt(0), theNet(nP),
+                                  thePort(nP->Port()), theShard(snum) {}
           ~XrdMain() {}
 };
 
@@ -124,7 +127,20 @@ void *mainAccept(void *parg)
    Parms->theSem  = &accepted;
    Parms->theProt = (XrdProtocol *)&ProtSelect;
 
-// Simply schedule new accepts
+// When shards are pinned, accepts are done right here on the shard's set of
+// cpus and only the new links are handed off to the scheduler.
+//
+   if (Parms->Config.NetPin && Parms->Config.NetShards > 1)
+      {XrdLink *newlink;
+       if (!XrdSysUtils::BindCPU(Parms->theShard, Parms->Config.NetShards))
+          Parms->Config.ProtInfo.eDest->Emsg("main",errno,"bind accept thread");
+       while(1) if ((newlink = Parms->theNet->Accept()))
+                   {newlink->setProtocol(Parms->theProt);
+                    mySched->Schedule((XrdJob *)newlink);
+                   }
+      }
+
+// Otherwise, simply schedule new accepts
 //
    while(1) {mySched->Schedule((XrdJob *)Parms);
              accepted.Wait();
@@ -189,20 +205,26 @@ int main(int argc, char *argv[])
 
 // At this point we should be able to accept new connections. Spawn a
 // thread for each network except the first. The main thread will handle
-// that network as some implementations require a main active thread.
+// that network as some implementations require a main active thread. Each
+// additional shard of a network gets its own thread as well.
 //
-   for (i = 1; i <= XrdProtLoad::ProtoMax; i++)
+   for (i = 0; i <= XrdProtLoad::ProtoMax; i++)
        if (Main.Config.NetTCP[i])
-          {XrdMain *Parms = new XrdMain(Main.Config.NetTCP[i]);
-           sprintf(buff, "Port %d handler", Parms->thePort);
-           if (Parms->theNet == Main.Config.NetTCP[XrdProtLoad::ProtoMax])
-               Parms->thePort = -(Parms->thePort);
-           if ((retc = XrdSysThread::Run(&tid, mainAccept, (void *)Parms,
-                                         XRDSYSTHREAD_BIND, strdup(buff))))
-              {Main.Config.ProtInfo.eDest->Emsg("main", retc, "create", buff);
-               _exit(3);
+          for (int k = 0; k < Main.Config.NetShards; k++)
+              {if (!i && !k) continue;
+               if (k && !Main.Config.NetSHD[i]) break;
+               XrdMain *Parms = new XrdMain((k ? Main.Config.NetSHD[i][k]
+                                               : Main.Config.NetTCP[i]), k);
+               if (k) sprintf(buff, "Port %d handler %d", Parms->thePort, k);
+                  else sprintf(buff, "Port %d handler", Parms->thePort);
+               if (Main.Config.NetTCP[i]==Main.Config.NetTCP[XrdProtLoad::ProtoMax])
+                   Parms->thePort = -(Parms->thePort);
+               if ((retc = XrdSysThread::Run(&tid, mainAccept, (void *)Parms,
+                                             XRDSYSTHREAD_BIND, strdup(buff))))
+                  {Main.Config.ProtInfo.eDest->Emsg("main", retc, "create", buff);
+                   _exit(3);
+                  }
               }
-          }
 
 // Finally, start accepting connections on the main port
 //
@@ -27,14 +27,17 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <errno.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
   
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysFD.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysUtils.hh"
 #include "Xrd/XrdLink.hh"
 #include "Xrd/XrdProtocol.hh"
 
@@ -46,6 +49,9 @@
 #include "Xrd/XrdPollDev.hh"
 #elif defined( __linux__ )
 #include "Xrd/XrdPollE.hh"
+#ifdef HAVE_IOURING
+#include "Xrd/XrdPollU.hh"
+#endif
 #else
 #include "Xrd/XrdPollPoll.hh"
 #endif
@@ -76,7 +82,8 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
 /*                           G l o b a l   D a t a                            */
 /******************************************************************************/
   
-       XrdPoll   *XrdPoll::Pollers[XRD_NUMPOLLERS] = {0, 0, 0};
+       XrdPoll  **XrdPoll::Pollers    = 0;
+       int        XrdPoll::numPollers = XRD_NUMPOLLERS;
 
        XrdSysMutex  XrdPoll::doingAttach;
 
@@ -85,6 +92,7 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
        XrdOucTrace  *XrdPoll::XrdTrace = 0;
        XrdSysError  *XrdPoll::XrdLog   = 0;
        XrdScheduler *XrdPoll::XrdSched = 0;
+       int           XrdPoll::pollOpts = 0;
 
 /******************************************************************************/
 /*              T h r e a d   S t a r t u p   I n t e r f a c e               */
@@ -93,9 +101,11 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
 struct XrdPollArg
        {XrdPoll      *Poller;
         int            retcode;
+        int            pinErr;
+        bool           pinCPU;
         XrdSysSemaphore PollSync;
 
-        XrdPollArg() : PollSync(0, "poll sync") {}
+        XrdPollArg() : pinErr(0), pinCPU(false), PollSync(0, "poll sync") {}
        ~XrdPollArg()               {}
        };
 
@@ -103,6 +113,9 @@ struct XrdPollArg
 void *XrdStartPolling(void *parg)
 {
      struct XrdPollArg *PArg = (struct XrdPollArg *)parg;
+     if (PArg->pinCPU
+     &&  !XrdSysUtils::BindCPU(PArg->Poller->PID, XrdPoll::numPollers))
+        PArg->pinErr = errno;
      PArg->Poller->Start(&(PArg->PollSync), PArg->retcode);
      return (void *)0;
 }
@@ -142,25 +155,36 @@ int XrdPoll::Attach(XrdLink *lp)
    int i;
    XrdPoll *pp;
 
-// We allow only one attach at a time to simplify the processing
+// A link accepted on a network shard always goes to that shard's poller. This
+// needs no global serialization as only that poller is affected.
 //
-   doingAttach.Lock();
+   if (lp->PollHint >= 0 && lp->PollHint < numPollers)
+      {pp = Pollers[lp->PollHint];
+       if (!pp->Include(lp)) return 0;
+      } else {
 
-// Find a poller with the smallest number of entries
-//
-   pp = Pollers[0];
-   for (i = 1; i < XRD_NUMPOLLERS; i++)
-       if (pp->numAttached > Pollers[i]->numAttached) pp = Pollers[i];
+   // We allow only one attach at a time to simplify the processing
+   //
+       doingAttach.Lock();
 
-// Include this FD into the poll set of the poller
-//
-   if (!pp->Include(lp)) {doingAttach.UnLock(); return 0;}
+   // Find a poller with the smallest number of entries
+   //
+       pp = Pollers[0];
+       for (i = 1; i < numPollers; i++)
+           if (pp->numAttached > Pollers[i]->numAttached) pp = Pollers[i];
+
+   // Include this FD into the poll set of the poller
+   //
+       if (!pp->Include(lp)) {doingAttach.UnLock(); return 0;}
+       doingAttach.UnLock();
+      }
 
 // Complete the link setup
 //
    lp->Poller = pp;
-   pp->numAttached++;
-   doingAttach.UnLock();
+   AtomicBeg(doingAttach);
+   AtomicInc(pp->numAttached);
+   AtomicEnd(doingAttach);
    TRACEI(POLL, "FD " <<lp->FD <<" attached to poller " <<pp->PID <<"; num=" <<pp->numAttached);
    return 1;
 }
@@ -183,11 +207,11 @@ void XrdPoll::Detach(XrdLink *lp)
 
 // Make sure we are consistent
 //
-   doingAttach.Lock();
-   if (!pp->numAttached)
+   AtomicBeg(doingAttach);
+   if (!AtomicGet(pp->numAttached))
       {XrdLog->Emsg("Poll","Underflow detaching", lp->ID); abort();}
-   pp->numAttached--;
-   doingAttach.UnLock();
+   AtomicDec(pp->numAttached);
+   AtomicEnd(doingAttach);
    TRACEI(POLL, "FD " <<lp->FDnum() <<" detached from poller " <<pp->PID
                 <<"; num=" <<pp->numAttached);
 }
@@ -286,19 +310,26 @@ char *XrdPoll::Poll2Text(short events)
 /*                                 S e t u p                                  */
 /******************************************************************************/
   
-int XrdPoll::Setup(int numfd)
+int XrdPoll::Setup(int numfd, int numpoll, bool pin, int popts)
 {
    pthread_t tid;
    int maxfd, retc, i;
    struct XrdPollArg PArg;
 
+// Establish the number of pollers and allocate the poller table
+//
+   if (numpoll > 0) numPollers = numpoll;
+   pollOpts = popts;
+   Pollers = new XrdPoll *[numPollers]();
+   PArg.pinCPU = pin;
+
 // Calculate the number of table entries per poller
 //
-   maxfd  = (numfd / XRD_NUMPOLLERS) + 16;
+   maxfd  = (numfd / numPollers) + 16;
 
 // Verify that we initialized the poller table
 //
-   for (i = 0; i < XRD_NUMPOLLERS; i++)
+   for (i = 0; i < numPollers; i++)
        {if (!(Pollers[i] = newPoller(i, maxfd))) return 0;
         Pollers[i]->PID = i;
 
@@ -312,6 +343,10 @@ int XrdPoll::Setup(int numfd)
            {XrdLog->Emsg("Poll", retc, "create poller thread"); return 0;}
         Pollers[i]->TID = tid;
         PArg.PollSync.Wait();
+        if (PArg.pinErr)
+           {XrdLog->Emsg("Poll", PArg.pinErr, "bind poller to cpu set");
+            PArg.pinErr = 0;
+           }
         if (PArg.retcode)
            {XrdLog->Emsg("Poll", PArg.retcode, "start poller");
             return 0;
@@ -336,13 +371,13 @@ int XrdPoll::Stats(char *buff, int blen, int do_sync)
 
 // Return number of bytes if so wanted
 //
-   if (!buff) return (sizeof(statfmt)+(4*16))*XRD_NUMPOLLERS;
+   if (!buff) return (sizeof(statfmt)+(4*16))*numPollers;
 
 // Get statistics. While we wish we could honor do_sync, doing so would be
 // costly and hardly worth it. So, we do not include code such as:
 //    x = pp->y; if (do_sync) while(x != pp->y) x = pp->y; tot += x;
 //
-   for (i = 0; i < XRD_NUMPOLLERS; i++)
+   for (i = 0; i < numPollers; i++)
        {pp = Pollers[i];
         numatt += pp->numAttached; 
         numen  += pp->numEnabled;
@@ -362,6 +397,9 @@ int XrdPoll::Stats(char *buff, int blen, int do_sync)
 #include "Xrd/XrdPollDev.icc"
 #elif defined( __linux__ )
 #include "Xrd/XrdPollE.icc"
+#ifdef HAVE_IOURING
+#include "Xrd/XrdPollU.icc"
+#endif
 #else
 #include "Xrd/XrdPollPoll.icc"
 #endif
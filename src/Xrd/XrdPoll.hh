@@ -73,9 +73,18 @@ static  void  Init(XrdSysError *eP, XrdOucTrace *tP, XrdScheduler *sP)
 //
 static  char *Poll2Text(short events); // Implementation supplied
 
-// Setup() is called at config time to perform poller configuration
+// Setup() is called at config time to perform poller configuration. When
+// numpoll is positive, that many pollers are started instead of the default.
+// When pin is true, each poller's thread is bound to its own processor set.
+// The popts are poller options, as follows:
 //
-static  int   Setup(int numfd);        // Implementation supplied
+// pollURing  - use io_uring based pollers when the platform supports it.
+// pollSQPoll - in addition, let a kernel thread consume the submission ring.
+//
+static const int pollURing  = 0x0001;
+static const int pollSQPoll = 0x0002;
+
+static  int   Setup(int numfd, int numpoll=0, bool pin=false, int popts=0);
 
 // Start() is called via a thread for each poller that was created
 //
@@ -92,7 +101,8 @@ static  int   Stats(char *buff, int blen, int do_sync=0);
 
 // The following table reference the pollers in effect
 //
-static     XrdPoll   *Pollers[XRD_NUMPOLLERS];
+static     XrdPoll  **Pollers;
+static     int        numPollers;
 
            XrdPoll();
 virtual   ~XrdPoll() {}
@@ -103,6 +113,7 @@ static     const char   *TraceID;                  // For tracing
 static     XrdOucTrace  *XrdTrace;
 static     XrdSysError  *XrdLog;
 static     XrdScheduler *XrdSched;
+static     int           pollOpts;
 
 // Gets the next request on the poll pipe. This is common to all implentations.
 //
@@ -0,0 +1,115 @@
+#ifndef __XRD_POLLU_H__
+#define __XRD_POLLU_H__
+/******************************************************************************/
+/*                                                                            */
+/*                           X r d P o l l U . h h                            */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <poll.h>
+#include <linux/io_uring.h>
+
+#include "Xrd/XrdPoll.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+//-----------------------------------------------------------------------------
+//! XrdPollU is a poller that uses an io_uring instance instead of an epoll
+//! descriptor. Each enable is a one-shot poll request placed in the
+//! submission ring. Requests are submitted in batches when the poller thread
+//! next waits for completions so that under load re-arming a link costs no
+//! system call. With the sqpoll option the kernel consumes the ring on its
+//! own and no submission system calls are needed at all. Links that allow it
+//! (see XrdLink::setRecvAhead()) get a receive request instead of a poll so
+//! that the data arrives along with the completion and the protocol need not
+//! issue a separate read system call for it.
+//-----------------------------------------------------------------------------
+
+class XrdPollU : public XrdPoll
+{
+public:
+
+       void Disable(XrdLink *lp, const char *etxt=0);
+
+       int   Enable(XrdLink *lp);
+
+       void Start(XrdSysSemaphore *syncp, int &rc);
+
+static XrdPoll *newPoller(int numfd, bool sqpoll);
+
+            XrdPollU(int rfd, struct io_uring_params &parms, bool sqpoll);
+           ~XrdPollU();
+
+protected:
+       void  Exclude(XrdLink *lp);
+       int   Include(XrdLink *lp);
+const  char *x2Text(unsigned int evf, char *buff);
+
+private:
+
+bool addPoll(XrdLink *lp);
+bool delPoll(XrdLink *lp);
+void Flush(bool force=false);
+struct io_uring_sqe *getSQE();
+bool mapRings(struct io_uring_params &parms);
+
+static const int uPollEvents = POLLIN | POLLPRI | POLLRDHUP;
+static const int uStashSz    = 2048; // Bytes received ahead for a link
+
+// Link states (i.e. XrdLink::uState) as maintained by this poller
+//
+static const char uIdle = 0;   // No poll request outstanding
+static const char uArmd = 1;   // Poll request outstanding
+static const char uKill = 2;   // Poll request outstanding but being removed
+static const char uRcvd = 3;   // Receive request outstanding
+
+XrdSysCondVar        uCond;    // Serializes the submission ring & link states
+int                  uRingFD;
+bool                 uSQPoll;
+bool                 uRecv;    // Receive requests may be used
+bool                 uWaiting; // Poller thread is waiting for completions
+int                  uPend;    // Submissions not yet passed to the kernel
+
+void                *sqMap;
+size_t               sqMapSz;
+unsigned int        *sqHead;
+unsigned int        *sqTail;
+unsigned int        *sqMask;
+unsigned int        *sqFlags;
+unsigned int        *sqArray;
+unsigned int         sqEntries;
+unsigned int         sqLTail;  // Local copy of the tail
+
+void                *cqMap;
+size_t               cqMapSz;
+unsigned int        *cqHead;
+unsigned int        *cqTail;
+unsigned int        *cqMask;
+struct io_uring_cqe *cqEnts;
+
+struct io_uring_sqe *sqEnts;
+size_t               sqEntsSz;
+};
+#endif
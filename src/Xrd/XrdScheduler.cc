@@ -29,10 +29,13 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdio.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #ifdef __APPLE__
@@ -41,6 +44,7 @@
 
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 
 #define XRD_TRACE XrdTrace->
@@ -52,6 +56,29 @@
 
        const char   *XrdScheduler::TraceID = "Sched";
 
+// Each worker records its home queue as thread specific data so that jobs it
+// schedules go back to its own queue without any global synchronization.
+//
+static pthread_key_t  homeKey;
+static pthread_once_t homeOnce = PTHREAD_ONCE_INIT;
+
+static void homeKeyInit() {pthread_key_create(&homeKey, 0);}
+
+/******************************************************************************/
+/*                         L o c a l   F u n c t i o n s                      */
+/******************************************************************************/
+
+namespace
+{
+long long nowMS()
+{
+   struct timeval tNow;
+
+   gettimeofday(&tNow, 0);
+   return static_cast<long long>(tNow.tv_sec)*1000 + tNow.tv_usec/1000;
+}
+}
+
 /******************************************************************************/
 /*                         L o c a l   C l a s s e s                          */
 /******************************************************************************/
@@ -65,6 +92,20 @@ class XrdSchedulerPID
                         {next = prev; pid = newpid;}
      ~XrdSchedulerPID() {}
      };
+
+class XrdSchedulerQ
+     {public:
+      XrdSysMutex      qMutex;   // Protects this queue
+      XrdJob          *First;    // Pending work
+      XrdJob          *Last;
+      XrdScheduler    *Owner;    // Scheduler owning this queue
+      int              Count;    // Number of jobs in this queue
+      int              Jobs;     // Number of jobs ever placed in this queue
+      char             Pad[64];  // Keeps adjacent queues on separate lines
+
+      XrdSchedulerQ() : First(0), Last(0), Owner(0), Count(0), Jobs(0) {}
+     ~XrdSchedulerQ() {}
+     };
   
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
@@ -95,7 +136,7 @@ void *XrdStartWorking(void *carg)
 XrdScheduler::XrdScheduler(XrdSysError *eP, XrdOucTrace *tP,
                            int minw, int maxw, int maxi)
               : XrdJob("underused thread monitor"),
-                WorkAvail(0, "sched work")
+                WorkAvail(0, "sched work"), TimerRings(0, "sched timer")
 {
     struct rlimit rlim;
 
@@ -114,8 +155,18 @@ XrdScheduler::XrdScheduler(XrdSysError *eP, XrdOucTrace *tP,
     num_TDestroy=  0;
     num_Layoffs =  0;
     num_Limited =  0;
+    num_Steals  =  0;
+    num_Timers  =  0;
+    max_Timers  =  0;
     firstPID    =  0;
-    WorkFirst = WorkLast = TimerQueue = 0;
+    WorkFirst = WorkLast = 0;
+    memset(TimerWheel, 0, sizeof(TimerWheel));
+    twNext      = nowMS()/twTick;
+    twWake      = twNext;
+    WorkQ       =  0;
+    numQueues   =  1;
+    nextQueue   =  0;
+    nextHome    =  0;
 
 // Make sure we are using the maximum number of threads allowed (Linux only)
 //
@@ -176,30 +227,40 @@ XrdScheduler::~XrdScheduler()  // The scheduler is never deleted!
 
 void XrdScheduler::Cancel(XrdJob *jp)
 {
-   XrdJob *p, *pp = 0;
 
-// Lock the queue
+// Lock the timer wheel
 //
-   TimerMutex.Lock();
+   TimerRings.Lock();
 
-// Find the matching job, if any
+// Remove the job from its slot, if it is in the wheel at all
 //
-   p = TimerQueue;
-   while(p && p != jp) {pp = p; p = p->NextJob;}
-
-// Delete the job element
-//
-   if (p)
-      {if (pp) pp->NextJob = p->NextJob;
-          else  TimerQueue = p->NextJob;
+   if (jp->TimerSlot >= 0)
+      {twDel(jp);
        TRACE(SCHED, "time event " <<jp->Comment <<" cancelled");
       }
 
 // All done
 //
-   TimerMutex.UnLock();
+   TimerRings.UnLock();
 }
   
+/******************************************************************************/
+/*                                 D e l a y                                  */
+/******************************************************************************/
+
+void XrdScheduler::Delay(XrdJob *jp, int msec)
+{
+
+// Trace this event
+//
+   if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
+      {TRACE(SCHED, "scheduling " <<jp->Comment <<" in " <<msec <<" msecs");}
+
+// Place the event in the timer wheel
+//
+   twSched(jp, nowMS() + (msec > 0 ? msec : 0));
+}
+
 /******************************************************************************/
 /*                                  D o I t                                   */
 /******************************************************************************/
@@ -323,6 +384,10 @@ void XrdScheduler::Run()
    int waiting;
    XrdJob *jp;
 
+// If we have multiple work queues then use the work stealing dispatcher
+//
+   if (WorkQ) {RunQ(); return;}
+
 // Wait for work then do it (an endless task for a worker thread)
 //
    do {do {DispatchMutex.Lock();          idl_Workers++;DispatchMutex.UnLock();
@@ -364,6 +429,27 @@ void XrdScheduler::Run()
   
 void XrdScheduler::Schedule(XrdJob *jp)
 {
+// If we have multiple work queues, place the job on the caller's home queue
+// or, for non-workers, on the next queue in round robin fashion.
+//
+   if (WorkQ)
+      {XrdSchedulerQ *qP = pickQueue();
+       int qlen;
+       jp->NextJob  = 0;
+       qP->qMutex.Lock();
+       if (qP->First) qP->Last->NextJob = jp;
+          else        qP->First        = jp;
+       qP->Last = jp;
+       qP->Count++; qP->Jobs++;
+       AtomicBeg(SchedMutex);
+       AtomicFAdd(qlen, num_JobsinQ, 1);
+       AtomicEnd(SchedMutex);
+       qP->qMutex.UnLock();
+       if (qlen >= max_QLength) max_QLength = qlen+1;
+       WorkAvail.Post();
+       return;
+      }
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -396,6 +482,27 @@ void XrdScheduler::Schedule(XrdJob *jp)
 void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 {
 
+// If we have multiple work queues then place the whole list on one queue.
+// Idle workers will steal individual jobs from it.
+//
+   if (WorkQ)
+      {XrdSchedulerQ *qP = pickQueue();
+       int qlen;
+       jlast->NextJob = 0;
+       qP->qMutex.Lock();
+       if (qP->First) qP->Last->NextJob = jfirst;
+          else        qP->First        = jfirst;
+       qP->Last = jlast;
+       qP->Count += numjobs; qP->Jobs += numjobs;
+       AtomicBeg(SchedMutex);
+       AtomicFAdd(qlen, num_JobsinQ, numjobs);
+       AtomicEnd(SchedMutex);
+       qP->qMutex.UnLock();
+       if (qlen+numjobs > max_QLength) max_QLength = qlen+numjobs;
+       while(numjobs--) WorkAvail.Post();
+       return;
+      }
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -430,33 +537,15 @@ void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 
 void XrdScheduler::Schedule(XrdJob *jp, time_t atime)
 {
-   XrdJob *pp = 0, *p;
-
-// Cancel this event, if scheduled
-//
-   Cancel(jp);
 
-// Lock the queue
+// Trace this event
 //
    if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
       {TRACE(SCHED, "scheduling " <<jp->Comment <<" in " <<atime-time(0) <<" seconds");}
-   jp->SchedTime = atime;
-   TimerMutex.Lock();
 
-// Find the insertion point for the work element
+// Place the event in the timer wheel
 //
-   p = TimerQueue;
-   while(p && p->SchedTime <= atime) {pp = p; p = p->NextJob;}
-
-// Insert the job element
-//
-   jp->NextJob = p;
-   if (pp)  pp->NextJob = jp;
-      else {TimerQueue = jp; TimerRings.Signal();}
-
-// All done
-//
-   TimerMutex.UnLock();
+   twSched(jp, static_cast<long long>(atime)*1000);
 }
 
 /******************************************************************************/
@@ -505,6 +594,40 @@ void XrdScheduler::setParms(int minw, int maxw, int avlw, int maxi, int once)
    TRACE(SCHED,"Set stk_Workers=" <<stk_Workers <<" max_Workidl=" <<max_Workidl);
 }
 
+/******************************************************************************/
+/*                             s e t Q u e u e s                              */
+/******************************************************************************/
+  
+void XrdScheduler::setQueues(int numq)
+{
+   int i;
+
+// Queues can only be established before any worker has been started
+//
+   SchedMutex.Lock();
+   if (num_Workers || WorkQ)
+      {SchedMutex.UnLock();
+       XrdLog->Emsg("Scheduler", "Work queues can't be changed once started!");
+       return;
+      }
+
+// A single queue is the classic scheduler and needs no additional structures
+//
+   if (numq <= 1) {numQueues = 1; SchedMutex.UnLock(); return;}
+
+// Allocate the queues and record who owns them
+//
+   pthread_once(&homeOnce, homeKeyInit);
+   WorkQ = new XrdSchedulerQ[numq];
+   for (i = 0; i < numq; i++) WorkQ[i].Owner = this;
+   numQueues = numq;
+   SchedMutex.UnLock();
+
+// Debug the info
+//
+   TRACE(SCHED, "Set work queues=" <<numQueues);
+}
+
 /******************************************************************************/
 /*                                 S t a r t                                  */
 /******************************************************************************/
@@ -541,16 +664,18 @@ void XrdScheduler::Start() // Serialized one time call!
 int XrdScheduler::Stats(char *buff, int blen, int do_sync)
 {
     int cnt_Jobs, cnt_JobsinQ, xam_QLength, cnt_Workers, cnt_idl;
-    int cnt_TCreate, cnt_TDestroy, cnt_Limited;
+    int cnt_TCreate, cnt_TDestroy, cnt_Limited, cnt_Steals, i;
+    int cnt_Timers, xam_Timers;
     static char statfmt[] = "<stats id=\"sched\"><jobs>%d</jobs>"
                 "<inq>%d</inq><maxinq>%d</maxinq>"
                 "<threads>%d</threads><idle>%d</idle>"
                 "<tcr>%d</tcr><tde>%d</tde>"
-                "<tlimr>%d</tlimr></stats>";
+                "<tlimr>%d</tlimr><wsq>%d</wsq><steals>%d</steals>"
+                "<tmq>%d</tmq><maxtmq>%d</maxtmq></stats>";
 
 // If only length wanted, do so
 //
-   if (!buff) return sizeof(statfmt) + 16*8;
+   if (!buff) return sizeof(statfmt) + 16*12;
 
 // Get values protected by the Dispatch lock (avoid lock if no sync needed)
 //
@@ -568,13 +693,30 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
    cnt_TCreate = num_TCreate;
    cnt_TDestroy= num_TDestroy;
    cnt_Limited = num_Limited;
+   cnt_Steals  = num_Steals;
    if (do_sync) SchedMutex.UnLock();
 
+// Get values protected by the timer lock (avoid lock if no sync needed)
+//
+   if (do_sync) TimerRings.Lock();
+   cnt_Timers  = num_Timers;
+   xam_Timers  = max_Timers;
+   if (do_sync) TimerRings.UnLock();
+
+// Jobs placed on per-core queues are counted by each queue
+//
+   if (WorkQ)
+      for (i = 0; i < numQueues; i++)
+          {if (do_sync) WorkQ[i].qMutex.Lock();
+           cnt_Jobs += WorkQ[i].Jobs;
+           if (do_sync) WorkQ[i].qMutex.UnLock();
+          }
+
 // Format the stats and return them
 //
    return snprintf(buff, blen, statfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
                    cnt_Workers, cnt_idl, cnt_TCreate, cnt_TDestroy,
-                   cnt_Limited);
+                   cnt_Limited, numQueues, cnt_Steals, cnt_Timers, xam_Timers);
 }
 
 /******************************************************************************/
@@ -583,29 +725,201 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
   
 void XrdScheduler::TimeSched()
 {
-   XrdJob *jp;
-   int wtime;
+   XrdJob *jp, *jFirst, *jLast;
+   long long nowTick, wTick;
+   int idx, numJobs;
 
-// Continuous loop until we find some work here
+// Continuous loop turning the wheel and dispatching jobs that are due
 //
-   do {TimerMutex.Lock();
-       if (TimerQueue) wtime = TimerQueue->SchedTime-time(0);
-          else wtime = 60*60;
-       if (wtime > 0)
-          {TimerMutex.UnLock();
-           TimerRings.Wait(wtime);
-          } else {
-           jp = TimerQueue;
-           TimerQueue = jp->NextJob;
-           Schedule(jp);
-           TimerMutex.UnLock();
+   TimerRings.Lock();
+   do {nowTick = nowMS()/twTick;
+       jFirst = jLast = 0; numJobs = 0;
+
+   // If the wheel is empty there is nothing to turn; otherwise, process each
+   // tick up to now. Higher levels cascade whenever the base level wraps.
+   //
+       if (!num_Timers) twNext = nowTick+1;
+          else while(twNext <= nowTick)
+                    {idx = static_cast<int>(twNext & 255);
+                     if (!idx
+                     &&  !twCascade(256, static_cast<int>((twNext >>  8) & 63))
+                     &&  !twCascade(320, static_cast<int>((twNext >> 14) & 63)))
+                          twCascade(384, static_cast<int>((twNext >> 20) & 63));
+                     while((jp = TimerWheel[idx]))
+                          {twDel(jp);
+                           jp->NextJob = 0;
+                           if (jLast) jLast->NextJob = jp;
+                              else    jFirst         = jp;
+                           jLast = jp; numJobs++;
+                          }
+                     twNext++;
+                    }
+
+   // Find the next tick at which something needs to be done. That's either
+   // a non-empty base slot or a wrap of the base level when higher levels
+   // have jobs that need to cascade down.
+   //
+       if (!num_Timers) wTick = twNext + 60*60*1000/twTick;
+          else {for (wTick = twNext; wTick < twNext+256; wTick++)
+                    {idx = static_cast<int>(wTick & 255);
+                     if (TimerWheel[idx] || !idx) break;
+                    }
+               }
+       twWake = wTick;
+
+   // Dispatch all of the due jobs as a single group (without the lock)
+   //
+       if (numJobs)
+          {TimerRings.UnLock();
+           Schedule(numJobs, jFirst, jLast);
+           TimerRings.Lock();
+           continue;
           }
+
+   // Wait until the next interesting tick or until someone adds an earlier job
+   //
+       if ((wTick = wTick*twTick - nowMS()) > 0)
+          TimerRings.WaitMS(static_cast<int>(wTick));
        } while(1);
 }
 
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
+/******************************************************************************/
+/*                                 t w A d d                                  */
+/******************************************************************************/
+
+// The caller must hold the TimerRings lock.
+//
+void XrdScheduler::twAdd(XrdJob *jp)
+{
+   long long expires = (jp->SchedTime + twTick - 1)/twTick;
+   long long delta   = expires - twNext;
+   int slot;
+
+// Jobs are never run early so their expiration is rounded up to a tick. Jobs
+// that are already due are placed in the next slot to be processed and jobs
+// beyond the wheel's horizon are placed in its last level. They will be
+// cascaded again when that slot is reached.
+//
+   if (delta < 0) {expires = twNext; delta = 0;}
+        if (delta < 256)        slot = static_cast<int>(expires & 255);
+   else if (delta < (1 << 14))  slot = 256 + static_cast<int>((expires >>  8)&63);
+   else if (delta < (1 << 20))  slot = 320 + static_cast<int>((expires >> 14)&63);
+   else {if (delta >= (1 << 26)) expires = twNext + (1 << 26) - 1;
+         slot = 384 + static_cast<int>((expires >> 20)&63);
+        }
+
+// Insert the job at the front of the slot
+//
+   jp->PrevJob = 0;
+   if ((jp->NextJob = TimerWheel[slot])) jp->NextJob->PrevJob = jp;
+   TimerWheel[slot] = jp;
+   jp->TimerSlot = slot;
+   if (++num_Timers > max_Timers) max_Timers = num_Timers;
+}
+
+/******************************************************************************/
+/*                             t w C a s c a d e                              */
+/******************************************************************************/
+
+// The caller must hold the TimerRings lock. Returns the index cascaded.
+//
+int XrdScheduler::twCascade(int slot0, int idx)
+{
+   XrdJob *jp, *jNext;
+
+// Redistribute each job in the slot into the lower levels
+//
+   jp = TimerWheel[slot0+idx];
+   TimerWheel[slot0+idx] = 0;
+   while(jp)
+        {jNext = jp->NextJob;
+         num_Timers--;
+         twAdd(jp);
+         jp = jNext;
+        }
+   return idx;
+}
+
+/******************************************************************************/
+/*                                 t w D e l                                  */
+/******************************************************************************/
+
+// The caller must hold the TimerRings lock.
+//
+void XrdScheduler::twDel(XrdJob *jp)
+{
+   if (jp->PrevJob) jp->PrevJob->NextJob = jp->NextJob;
+      else TimerWheel[jp->TimerSlot]      = jp->NextJob;
+   if (jp->NextJob) jp->NextJob->PrevJob = jp->PrevJob;
+   jp->NextJob = jp->PrevJob = 0;
+   jp->TimerSlot = -1;
+   num_Timers--;
+}
+
+/******************************************************************************/
+/*                               t w S c h e d                                */
+/******************************************************************************/
+
+void XrdScheduler::twSched(XrdJob *jp, long long atMS)
+{
+
+// Replace any pending occurrence of this event with the new one. An empty
+// wheel may not have been turned for a while so we bring it up to date.
+//
+   TimerRings.Lock();
+   if (jp->TimerSlot >= 0) twDel(jp);
+   if (!num_Timers) twNext = nowMS()/twTick;
+   jp->SchedTime = atMS;
+   twAdd(jp);
+
+// Wake up the timer thread only if this event is due before it would wake up
+//
+   atMS = (atMS + twTick - 1)/twTick;
+   if (atMS < twWake) {twWake = atMS; TimerRings.Signal();}
+   TimerRings.UnLock();
+}
+
+/******************************************************************************/
+/*                                g e t J o b                                 */
+/******************************************************************************/
+
+XrdJob *XrdScheduler::getJob(XrdSchedulerQ *homeQ)
+{
+   XrdSchedulerQ *qP;
+   XrdJob *jp;
+   int i, qNum = homeQ - WorkQ;
+
+// Look at our home queue first and then steal from the others. The queue count
+// is peeked at without the lock; we re-check it once the lock is obtained.
+// Since a job is counted before its semaphore is posted, a job must be on
+// some queue as long as the global count says so; keep looking until found.
+//
+   do {for (i = 0; i < numQueues; i++)
+           {qP = &WorkQ[(qNum + i) % numQueues];
+            if (!qP->Count) continue;
+            qP->qMutex.Lock();
+            if ((jp = qP->First))
+               {if (!(qP->First = jp->NextJob)) qP->Last = 0;
+                qP->Count--;
+                AtomicBeg(SchedMutex);
+                AtomicDec(num_JobsinQ);
+                if (i) AtomicInc(num_Steals);
+                AtomicEnd(SchedMutex);
+                qP->qMutex.UnLock();
+                return jp;
+               }
+            qP->qMutex.UnLock();
+           }
+      } while(AtomicGet(num_JobsinQ) > 0 && !sched_yield());
+
+// There is no work at all
+//
+   return 0;
+}
+
 /******************************************************************************/
 /*                           h i r e   W o r k e r                            */
 /******************************************************************************/
@@ -648,6 +962,82 @@ void XrdScheduler::hireWorker(int dotrace)
       } else if (dotrace) TRACE(SCHED, "Now have " <<num_Workers <<" workers" );
 }
  
+/******************************************************************************/
+/*                             p i c k Q u e u e                              */
+/******************************************************************************/
+
+XrdSchedulerQ *XrdScheduler::pickQueue()
+{
+   XrdSchedulerQ *qP = (XrdSchedulerQ *)pthread_getspecific(homeKey);
+   unsigned int qNum;
+
+// Workers keep the jobs they schedule on their own queue. Everyone else
+// spreads jobs across all of the queues.
+//
+   if (qP && qP->Owner == this) return qP;
+   AtomicBeg(SchedMutex);
+   AtomicFAdd(qNum, nextQueue, 1);
+   AtomicEnd(SchedMutex);
+   return &WorkQ[qNum % numQueues];
+}
+
+/******************************************************************************/
+/*                                  R u n Q                                   */
+/******************************************************************************/
+  
+void XrdScheduler::RunQ()
+{
+   XrdSchedulerQ *homeQ;
+   XrdJob *jp;
+   unsigned int qNum;
+   int waiting;
+
+// Assign this worker a home queue. Workers are spread evenly over the queues.
+//
+   AtomicBeg(SchedMutex);
+   AtomicFAdd(qNum, nextHome, 1);
+   AtomicEnd(SchedMutex);
+   homeQ = &WorkQ[qNum % numQueues];
+   pthread_setspecific(homeKey, homeQ);
+
+// Wait for work then do it (an endless task for a worker thread). This is the
+// same as Run() except that the global job queue lock is never taken unless
+// there is no work to be found (i.e. we were posted to terminate).
+//
+   do {do {AtomicBeg(DispatchMutex);
+           AtomicInc(idl_Workers);
+           AtomicEnd(DispatchMutex);
+           WorkAvail.Wait();
+           AtomicBeg(DispatchMutex);
+           AtomicFSub(waiting, idl_Workers, 1);
+           AtomicEnd(DispatchMutex);
+           waiting--;
+           if (!(jp = getJob(homeQ)))
+              {SchedMutex.Lock();
+               if (num_Layoffs > 0)
+                  {num_Layoffs--;
+                   if (waiting)
+                      {num_TDestroy++; num_Workers--;
+                       TRACE(SCHED, "terminating thread; workers=" <<num_Workers);
+                       SchedMutex.UnLock();
+                       pthread_setspecific(homeKey, 0);
+                       return;
+                      }
+                  }
+               SchedMutex.UnLock();
+              }
+          } while(!jp);
+
+    // Check if we should hire a new worker (we always want 1 idle thread)
+    // before running this job.
+    //
+       if (!waiting) hireWorker();
+       if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
+          {TRACE(SCHED, "running " <<jp->Comment <<" inq=" <<num_JobsinQ);}
+       jp->DoIt();
+      } while(1);
+}
+
 /******************************************************************************/
 /*                             t r a c e E x i t                              */
 /******************************************************************************/
@@ -37,6 +37,7 @@
 
 class XrdOucTrace;
 class XrdSchedulerPID;
+class XrdSchedulerQ;
 class XrdSysError;
 
 #define MAX_SCHED_PROCS 30000
@@ -64,8 +65,19 @@ void          Schedule(XrdJob *jp);
 void          Schedule(int num, XrdJob *jfirst, XrdJob *jlast);
 void          Schedule(XrdJob *jp, time_t atime);
 
+// Delay() schedules a job to run after the specified number of milliseconds.
+// Timed jobs are held in a timer wheel whose resolution is twTick msecs.
+//
+void          Delay(XrdJob *jp, int msec);
+
 void          setParms(int minw, int maxw, int avlt, int maxi, int once=0);
 
+// setQueues() establishes the number of work queues. When more than one is
+// used, each worker has a home queue and steals from others when idle. This
+// must be called before Start().
+//
+void          setQueues(int numq);
+
 void          Start();
 
 int           Stats(char *buff, int blen, int do_sync=0);
@@ -79,6 +91,9 @@ int        num_TDestroy;// Number of threads destroyed
 int        num_Jobs;    // Number of jobs scheduled
 int        max_QLength; // Longest queue length we had
 int        num_Limited; // Number of times max was reached
+int        num_Steals;  // Number of jobs taken from a non-home queue
+int        num_Timers;  // Number of jobs waiting in the timer wheel
+int        max_Timers;  // Most jobs we had in the timer wheel
 
 // Constructor and destructor
 //
@@ -107,15 +122,35 @@ XrdJob                *WorkLast;
 XrdSysSemaphore        WorkAvail;
 XrdSysMutex            SchedMutex; // Protects private area
 
-XrdJob                *TimerQueue; // Pending work
-XrdSysCondVar          TimerRings;
-XrdSysMutex            TimerMutex; // Protects scheduler area
+XrdSchedulerQ         *WorkQ;      // Per-core work queues (0 -> use WorkFirst)
+int                    numQueues;  // Number of elements in WorkQ
+unsigned int           nextQueue;  // Queue for the next non-worker Schedule()
+unsigned int           nextHome;   // Home queue for the next new worker
+
+// The timer wheel has a base level of 256 slots, one per tick, followed by
+// three levels of 64 slots each covering 64 times the span of the level below.
+// Jobs cascade down a level as the wheel turns. Due jobs are moved to the
+// work queue as a group.
+//
+static const int       twTick  = 10;     // Milliseconds per wheel tick
+static const int       twSlots = 256+3*64;
+XrdJob                *TimerWheel[twSlots];
+long long              twNext;     // Next tick to be processed
+long long              twWake;     // Tick at which TimeSched() will wake up
+XrdSysCondVar          TimerRings; // Protects the timer wheel
 
 XrdSchedulerPID       *firstPID;
 XrdSysMutex            ReaperMutex;
 
+XrdJob *getJob(XrdSchedulerQ *homeQ);
 void hireWorker(int dotrace=1);
 void Monitor();
+XrdSchedulerQ *pickQueue();
+void RunQ();
+void twAdd(XrdJob *jp);
+int  twCascade(int slot0, int idx);
+void twDel(XrdJob *jp);
+void twSched(XrdJob *jp, long long atMS);
 void traceExit(pid_t pid, int status);
 static const char *TraceID;
 };
@@ -28,7 +28,10 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/uio.h>
@@ -37,9 +40,22 @@
 #include "Xrd/XrdScheduler.hh"
 #include "Xrd/XrdSendQ.hh"
 
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+// The maximum number of queued messages we will hand to a single writev()
+//
+#ifdef IOV_MAX
+#define XRDSENDQ_MAXIOV (IOV_MAX > 1024 ? 1024 : IOV_MAX)
+#else
+#define XRDSENDQ_MAXIOV 16
+#endif
+
 /******************************************************************************/
 /*                         L o c a l   C l a s s e s                          */
 /******************************************************************************/
@@ -73,6 +89,14 @@ unsigned int  XrdSendQ::qWarn = 3;
 unsigned int  XrdSendQ::qMax  = 0xffffffff;
 bool          XrdSendQ::qPerm = false;
 
+XrdSysMutex       XrdSendQ::mSlabMutex;
+XrdSendQ::mBuff  *XrdSendQ::mSlabFree = 0;
+
+XrdSysMutex   XrdSendQ::qStatMutex;
+int           XrdSendQ::qHist[XrdSendQ::qHistSz] = {0};
+int           XrdSendQ::qWrites = 0;
+int           XrdSendQ::qWMsgs  = 0;
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -90,8 +114,9 @@ XrdSendQ::XrdSendQ(XrdLink &lP, XrdSysMutex &mP)
   
 void XrdSendQ::DoIt()
 {
-   mBuff   *theMsg;
-   int      myFD, rc;
+   struct iovec ioV[XRDSENDQ_MAXIOV];
+   mBuff   *theMsg, *lastMsg, *sendMsg;
+   int      myFD, rc, ioN;
    bool     theEnd;
 
 // Obtain the lock
@@ -102,14 +127,26 @@ void XrdSendQ::DoIt()
 //
    if (delQ) {RelMsgs(delQ); delQ = 0;}
 
-// Send all queued messages (we can use a blocking send here)
+// Send all queued messages (we can use a blocking send here). Rather than
+// sending one message at a time we detach as many queued messages as fit in
+// a single writev() so that a backed up queue drains with few system calls.
 //
    while(!terminate && (theMsg = fMsg))
-        {if (!(fMsg = fMsg->next)) lMsg = 0;
-         inQ--; myFD = theFD;
+        {ioN = 0;
+         do {ioV[ioN].iov_base = theMsg->mData;
+             ioV[ioN].iov_len  = theMsg->mLen;
+             lastMsg = theMsg; theMsg = theMsg->next; ioN++;
+            } while(theMsg && ioN < XRDSENDQ_MAXIOV);
+         sendMsg = fMsg; lastMsg->next = 0;
+         if (!(fMsg = theMsg)) lMsg = 0;
+         inQ -= ioN; myFD = theFD;
          wMutex.UnLock();
-         rc = send(myFD, theMsg->mData, theMsg->mLen, 0);
-         free(theMsg);
+         rc = SendV(myFD, ioV, ioN);
+         RelMsgs(sendMsg);
+         AtomicBeg(qStatMutex);
+         AtomicInc(qWrites);
+         AtomicAdd(qWMsgs, ioN);
+         AtomicEnd(qStatMutex);
          wMutex.Lock();
          if (rc < 0) {Scuttle(); break;}
         }
@@ -129,6 +166,35 @@ void XrdSendQ::DoIt()
    if (theEnd) delete this;
 }
   
+/******************************************************************************/
+/* Private:                       G e t M s g                                 */
+/******************************************************************************/
+
+XrdSendQ::mBuff *XrdSendQ::GetMsg(int mlen)
+{
+   mBuff *mP;
+   char  *slab;
+
+// Large messages are simply allocated from the heap
+//
+   if (mlen > mSlabMax) return (mBuff *)malloc(sizeof(mBuff) + mlen);
+
+// Get a block from the free list, carving out a new slab if it is empty
+//
+   mSlabMutex.Lock();
+   if (!(mP = mSlabFree))
+      {if (!(slab = (char *)malloc(mSlabBsz*mSlabNum)))
+          {mSlabMutex.UnLock(); return 0;}
+       for (int i = 0; i < mSlabNum; i++)
+           {mP = (mBuff *)(slab + i*mSlabBsz);
+            mP->next = mSlabFree; mSlabFree = mP;
+           }
+      }
+   mSlabFree = mP->next;
+   mSlabMutex.UnLock();
+   return mP;
+}
+
 /******************************************************************************/
 /* Private:                         Q M s g                                   */
 /******************************************************************************/
@@ -157,6 +223,15 @@ bool XrdSendQ::QMsg(XrdSendQ::mBuff *theMsg)
    lMsg = theMsg;
    inQ++;
 
+// Record the queue depth in the histogram (buckets are powers of 2)
+//
+   {int hX = 0;
+    for (unsigned int qN = inQ >> 1; qN && hX < qHistSz-1; qN >>= 1) hX++;
+    AtomicBeg(qStatMutex);
+    AtomicInc(qHist[hX]);
+    AtomicEnd(qStatMutex);
+   }
+
 // If there is no active thread handling this queue, schedule one
 //
    if (!active)
@@ -186,12 +261,24 @@ bool XrdSendQ::QMsg(XrdSendQ::mBuff *theMsg)
 
 void XrdSendQ::RelMsgs(XrdSendQ::mBuff *mP)
 {
-   mBuff *freeMP;
+   mBuff *freeMP, *fFirst = 0, *fLast = 0;
 
+// Free large messages and collect slab blocks so that we can return them
+// to the free list with a single lock.
+//
    while((freeMP = mP))
         {mP = mP->next;
-         free(freeMP);
+         if (freeMP->mLen > mSlabMax) free(freeMP);
+            else {freeMP->next = fFirst; fFirst = freeMP;
+                  if (!fLast) fLast = freeMP;
+                 }
         }
+
+   if (fFirst)
+      {mSlabMutex.Lock();
+       fLast->next = mSlabFree; mSlabFree = fFirst;
+       mSlabMutex.UnLock();
+      }
 }
 
 /******************************************************************************/
@@ -230,8 +317,7 @@ int XrdSendQ::Send(const char *buff, int blen)
 
 // Allocate buffer for the message
 //
-   if (!(theMsg = (mBuff *)malloc(sizeof(mBuff) + bleft)))
-      {errno = ENOMEM;  return -1;}
+   if (!(theMsg = GetMsg(bleft))) {errno = ENOMEM;  return -1;}
 
 // Copy the unsent message fragment
 //
@@ -275,8 +361,7 @@ int XrdSendQ::Send(const struct iovec *iov, int iovcnt, int iotot)
 
 // Copy the unsent message (for simplicity we will copy the whole iovec stop).
 //
-   if (!(theMsg = (mBuff *)malloc(bmore+sizeof(mBuff))))
-      {errno = ENOMEM;  return -1;}
+   if (!(theMsg = GetMsg(bmore))) {errno = ENOMEM;  return -1;}
 
 // Setup the message length
 //
@@ -302,6 +387,35 @@ int XrdSendQ::Send(const struct iovec *iov, int iovcnt, int iotot)
    return (QMsg(theMsg) ? iotot : 0);
 }
 
+/******************************************************************************/
+/* Private:                        S e n d V                                  */
+/******************************************************************************/
+
+// Called with wMutex unlocked. The socket is in blocking mode here.
+
+int XrdSendQ::SendV(int fd, struct iovec *iov, int iocnt)
+{
+   ssize_t retc;
+
+// Write out the vector, adjusting it as needed when only part was written
+//
+   while(iocnt)
+        {do {retc = writev(fd, iov, iocnt);}
+            while(retc < 0 && errno == EINTR);
+         if (retc < 0) return -1;
+         while(iocnt && retc >= (ssize_t)iov->iov_len)
+              {retc -= iov->iov_len; iov++; iocnt--;}
+         if (retc)
+            {iov->iov_base = (char *)iov->iov_base + retc;
+             iov->iov_len -= retc;
+            }
+        }
+
+// All done
+//
+   return 0;
+}
+
 /******************************************************************************/
 /*                                S e n d N B                                 */
 /******************************************************************************/
@@ -376,6 +490,33 @@ int XrdSendQ::SendNB(const struct iovec *iov, int iocnt, int bytes, int &iovX)
 #endif
 }
   
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdSendQ::Stats(char *buff, int blen)
+{
+   static const char statfmt[] = "<sendq><wv>%d</wv><wm>%d</wm>"
+          "<qd>%d %d %d %d %d %d %d %d</qd></sendq>";
+
+// Check if actual length wanted
+//
+   if (!buff) return sizeof(statfmt)+10*8;
+
+// Format the statistics. The depth histogram counts enqueued messages by the
+// queue length they saw: 1, 2-3, 4-7, ... and 128 or more.
+//
+   AtomicBeg(qStatMutex);
+   blen = snprintf(buff, blen, statfmt, AtomicGet(qWrites),
+                   AtomicGet(qWMsgs),   AtomicGet(qHist[0]),
+                   AtomicGet(qHist[1]), AtomicGet(qHist[2]),
+                   AtomicGet(qHist[3]), AtomicGet(qHist[4]),
+                   AtomicGet(qHist[5]), AtomicGet(qHist[6]),
+                   AtomicGet(qHist[7]));
+   AtomicEnd(qStatMutex);
+   return blen;
+}
+
 /******************************************************************************/
 /*                             T e r m i n a t e                              */
 /******************************************************************************/
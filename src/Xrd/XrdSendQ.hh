@@ -35,9 +35,9 @@
 #include <sys/uio.h>
   
 #include "Xrd/XrdJob.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 class XrdLink;
-class XrdSysMutex;
 
 class XrdSendQ : public XrdJob
 {
@@ -59,6 +59,8 @@ static   void SetQM(unsigned int qmVal) {qMax  = qmVal;}
 
 static   void SetQW(unsigned int qwVal) {qWarn = qwVal;}
 
+static   int  Stats(char *buff, int blen);
+
          void Terminate(XrdLink *lP=0);
 
          XrdSendQ(XrdLink &lP, XrdSysMutex &mP);
@@ -77,9 +79,28 @@ int    mLen;
 char   mData[4]; // Always made long enough
 };
 
+static mBuff *GetMsg(int mlen);
 bool     QMsg(mBuff *theMsg);
-void     RelMsgs(mBuff *mP);
+static void   RelMsgs(mBuff *mP);
 void     Scuttle();
+int      SendV(int fd, struct iovec *iov, int iocnt);
+
+// Small messages are allocated out of slabs of fixed size blocks that are
+// never returned to the system. Larger messages are simply malloc'd.
+//
+static const int    mSlabBsz = 512;
+static const int    mSlabNum = 64;
+static const int    mSlabMax = mSlabBsz - sizeof(mBuff) + 4;
+static XrdSysMutex  mSlabMutex;
+static mBuff       *mSlabFree;
+
+// Statistics: queue depth histogram (by powers of 2) and coalesced writes
+//
+static const int    qHistSz = 8;
+static XrdSysMutex  qStatMutex;
+static int          qHist[qHistSz];
+static int          qWrites;
+static int          qWMsgs;
 
 static XrdScheduler *Sched;
 static XrdSysError  *Say;
@@ -1564,6 +1564,7 @@ XRootDStatus PrintHelp( FileSystem *, Env *,
   printf( "                               i - server identification\n"      );
   printf( "                               z - synchronized statistics\n"    );
   printf( "                               l - connection statistics\n"      );
+  printf( "                               r - request latency statistics\n" );
   printf( "     xattr          <path>   Extended attributes\n\n"            );
 
   printf( "   rm <filename>\n"                                              );
@@ -698,6 +698,7 @@ namespace
 
         XrdCl::DirectoryList *dirlist = new XrdCl::DirectoryList();
         dirlist->SetParentName( response->GetParentName() );
+        dirlist->SetCursor( response->GetCursor() );
         for( auto itr = unique.begin(); itr != unique.end(); ++itr )
         {
           ListEntry *entry = *itr;
@@ -1294,6 +1295,62 @@ namespace XrdCl
     return MessageUtils::WaitForResponse( &handler, response );
   }
 
+  //----------------------------------------------------------------------------
+  // Obtain status information for many paths in one request - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::Stat( const std::vector<std::string> &paths,
+                                 StatFlags::Flags                flags,
+                                 ResponseHandler                *handler,
+                                 uint16_t                        timeout )
+  {
+    if( pPlugIn || pUrl->IsLocalFile() )
+      return XRootDStatus( stError, errNotSupported );
+
+    if( paths.empty() )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    std::vector<std::string>::const_iterator it;
+    std::string                              list;
+    for( it = paths.begin(); it != paths.end(); ++it )
+    {
+      if( it->empty() || it->find( '\n' ) != std::string::npos )
+        return XRootDStatus( stError, errInvalidArgs );
+      list += FilterXrdClCgi( *it );
+      list += "\n";
+    }
+    list.erase( list.length()-1, 1 );
+
+    Message           *msg;
+    ClientStatRequest *req;
+    MessageUtils::CreateRequest( msg, req, list.length() );
+
+    req->requestid  = kXR_statm;
+    req->options    = ( flags & StatFlags::Checksum ) ? kXR_retcks : 0;
+    req->dlen       = list.length();
+    msg->Append( list.c_str(), list.length(), 24 );
+    MessageSendParams params; params.timeout = timeout;
+    MessageUtils::ProcessSendParams( params );
+    XRootDTransport::SetDescription( msg );
+
+    return Send( msg, handler, params );
+  }
+
+  //----------------------------------------------------------------------------
+  // Obtain status information for many paths in one request - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::Stat( const std::vector<std::string>  &paths,
+                                 StatFlags::Flags                 flags,
+                                 BulkStatInfo                   *&response,
+                                 uint16_t                         timeout )
+  {
+    SyncResponseHandler handler;
+    Status st = Stat( paths, flags, &handler, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return MessageUtils::WaitForResponse( &handler, response );
+  }
+
   //----------------------------------------------------------------------------
   // Obtain status information for a path - async
   //----------------------------------------------------------------------------
@@ -1552,6 +1609,67 @@ namespace XrdCl
     return XRootDStatus();
   }
 
+  //----------------------------------------------------------------------------
+  // List a page of entries of a directory - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::DirList( const std::string   &path,
+                                    DirListFlags::Flags  flags,
+                                    uint32_t             pageSize,
+                                    uint32_t             cursor,
+                                    ResponseHandler     *handler,
+                                    uint16_t             timeout )
+  {
+    if( pPlugIn || pUrl->IsLocalFile() )
+      return XRootDStatus( stError, errNotSupported );
+
+    if( flags & ( DirListFlags::Locate | DirListFlags::Recursive ) )
+      return XRootDStatus( stError, errNotSupported );
+
+    std::string fPath = FilterXrdClCgi( path );
+
+    Message           *msg;
+    ClientDirlistRequest *req;
+    MessageUtils::CreateRequest( msg, req, fPath.length() );
+
+    req->requestid  = kXR_dirlist;
+    req->dlen       = fPath.length();
+    req->options[0] = kXR_dpage;
+    req->pgsize     = pageSize;
+    req->pgcursor   = cursor;
+
+    if( flags & DirListFlags::Stat )
+      req->options[0] |= kXR_dstat;
+
+    if( flags & DirListFlags::Merge )
+      handler = new MergeDirListHandler( handler );
+
+    msg->Append( fPath.c_str(), fPath.length(), 24 );
+    MessageSendParams params; params.timeout = timeout;
+    MessageUtils::ProcessSendParams( params );
+    XRootDTransport::SetDescription( msg );
+
+    return Send( msg, handler, params );
+  }
+
+  //----------------------------------------------------------------------------
+  // List a page of entries of a directory - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::DirList( const std::string    &path,
+                                    DirListFlags::Flags   flags,
+                                    uint32_t              pageSize,
+                                    uint32_t              cursor,
+                                    DirectoryList       *&response,
+                                    uint16_t              timeout )
+  {
+    SyncResponseHandler handler;
+    XRootDStatus st = DirList( path, flags, pageSize, cursor, &handler,
+                               timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return MessageUtils::WaitForResponse( &handler, response );
+  }
+
   //----------------------------------------------------------------------------
   // Send info to the server - async
   //----------------------------------------------------------------------------
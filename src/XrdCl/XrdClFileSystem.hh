@@ -163,6 +163,20 @@ namespace XrdCl
   };
   XRDOUC_ENUM_OPERATORS( DirListFlags::Flags )
 
+  //----------------------------------------------------------------------------
+  //! Bulk stat flags
+  //----------------------------------------------------------------------------
+  struct StatFlags
+  {
+    enum Flags
+    {
+      None      = 0, //!< Nothing special
+      Checksum  = 1  //!< Also return the checksum of each file if the server
+                     //!< has it at hand (it is never computed)
+    };
+  };
+  XRDOUC_ENUM_OPERATORS( StatFlags::Flags )
+
   //----------------------------------------------------------------------------
   //! Prepare flags
   //----------------------------------------------------------------------------
@@ -537,6 +551,44 @@ namespace XrdCl
                          uint16_t            timeout = 0 )
                          XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! Obtain status information for many paths in one request - async
+      //!
+      //! @param paths   list of file/directory paths (none may be empty or
+      //!                contain a new line character)
+      //! @param flags   bulk stat flags
+      //! @param handler handler to be notified when the response arrives,
+      //!                the response parameter will hold a BulkStatInfo object
+      //!                with an entry for each path, in the order given, if
+      //!                the procedure is successful
+      //! @param timeout timeout value, if 0 the environment default will
+      //!                be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus Stat( const std::vector<std::string> &paths,
+                         StatFlags::Flags                flags,
+                         ResponseHandler                *handler,
+                         uint16_t                        timeout = 0 )
+                         XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! Obtain status information for many paths in one request - sync
+      //!
+      //! @param paths    list of file/directory paths (none may be empty or
+      //!                 contain a new line character)
+      //! @param flags    bulk stat flags
+      //! @param response the response (to be deleted by the user only if the
+      //!                 procedure is successful)
+      //! @param timeout  timeout value, if 0 the environment default will
+      //!                 be used
+      //! @return         status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus Stat( const std::vector<std::string>  &paths,
+                         StatFlags::Flags                 flags,
+                         BulkStatInfo                   *&response,
+                         uint16_t                         timeout = 0 )
+                         XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Obtain status information for a Virtual File System - async
       //!
@@ -627,6 +679,62 @@ namespace XrdCl
                             uint16_t              timeout = 0 )
                             XRD_WARN_UNUSED_RESULT;
 
+      //------------------------------------------------------------------------
+      //! List a page of entries of a directory - async
+      //!
+      //! Very large directories may be listed a page at a time. The returned
+      //! DirectoryList holds the cursor of the next page (see
+      //! DirectoryList::GetCursor), which is 0 when the listing is complete.
+      //! The cursor may be used with any connection to the same server.
+      //! Servers that do not support paging return the whole listing.
+      //!
+      //! @note The cursor is the position of the next entry. The server
+      //!       rereads all preceding entries for each page, so listing a
+      //!       directory of N entries this way costs O(N*N/pageSize) reads.
+      //!       Should the directory change between pages, entries may be
+      //!       skipped or listed twice.
+      //!
+      //! @param path     directory path
+      //! @param flags    DirListFlags, Locate and Recursive are not supported
+      //! @param pageSize maximum number of entries to return, 0 for all
+      //! @param cursor   0 for the first page, otherwise the cursor returned
+      //!                 with the previous page
+      //! @param handler  handler to be notified when the response arrives,
+      //!                 the response parameter will hold a DirectoryList
+      //!                 object if the procedure is successful
+      //! @param timeout  timeout value, if 0 the environment default will
+      //!                 be used
+      //! @return         status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus DirList( const std::string   &path,
+                            DirListFlags::Flags  flags,
+                            uint32_t             pageSize,
+                            uint32_t             cursor,
+                            ResponseHandler     *handler,
+                            uint16_t             timeout = 0 )
+                            XRD_WARN_UNUSED_RESULT;
+
+      //------------------------------------------------------------------------
+      //! List a page of entries of a directory - sync
+      //!
+      //! @param path     directory path
+      //! @param flags    DirListFlags, Locate and Recursive are not supported
+      //! @param pageSize maximum number of entries to return, 0 for all
+      //! @param cursor   0 for the first page, otherwise the cursor returned
+      //!                 with the previous page
+      //! @param response the response (to be deleted by the user)
+      //! @param timeout  timeout value, if 0 the environment default will
+      //!                 be used
+      //! @return         status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus DirList( const std::string    &path,
+                            DirListFlags::Flags   flags,
+                            uint32_t              pageSize,
+                            uint32_t              cursor,
+                            DirectoryList       *&response,
+                            uint16_t              timeout = 0 )
+                            XRD_WARN_UNUSED_RESULT;
+
       //------------------------------------------------------------------------
       //! Send info to the server (up to 1024 characters)- async
       //!
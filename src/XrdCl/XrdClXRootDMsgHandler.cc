@@ -1343,6 +1343,37 @@ namespace XrdCl
         return Status();
       }
 
+      //------------------------------------------------------------------------
+      // kXR_statm
+      //------------------------------------------------------------------------
+      case kXR_statm:
+      {
+        AnyObject *obj = new AnyObject();
+        log->Dump( XRootDMsg, "[%s] Parsing the response to %s as "
+                   "BulkStatInfo", pUrl.GetHostId().c_str(),
+                   pRequest->GetDescription().c_str() );
+
+        std::string paths( pRequest->GetBuffer(24), req->stat.dlen );
+
+        char *nullBuffer = new char[length+1];
+        nullBuffer[length] = 0;
+        memcpy( nullBuffer, buffer, length );
+
+        BulkStatInfo *data = new BulkStatInfo();
+        if( data->ParseServerResponse( paths, nullBuffer ) == false )
+        {
+          delete data;
+          delete obj;
+          delete [] nullBuffer;
+          return Status( stError, errInvalidResponse );
+        }
+
+        delete [] nullBuffer;
+        obj->Set( data );
+        response = obj;
+        return Status();
+      }
+
       //------------------------------------------------------------------------
       // kXR_protocol
       //------------------------------------------------------------------------
@@ -241,7 +241,7 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   // DirectoryList constructor
   //----------------------------------------------------------------------------
-  DirectoryList::DirectoryList()
+  DirectoryList::DirectoryList(): pCursor( 0 )
   {
   }
 
@@ -277,6 +277,20 @@ namespace XrdCl
     std::vector<std::string>::iterator it;
     Utils::splitString( entries, dat, "\n" );
 
+    //--------------------------------------------------------------------------
+    // A paged listing that is not complete ends with the cursor of the next
+    // page, it starts with a slash so it can't be an entry name
+    //--------------------------------------------------------------------------
+    if( !entries.empty() && !entries.back().empty() &&
+        entries.back()[0] == '/' )
+    {
+      char *result;
+      pCursor = ::strtoul( entries.back().c_str()+1, &result, 10 );
+      if( *result != 0 || !pCursor )
+        return false;
+      entries.pop_back();
+    }
+
     //--------------------------------------------------------------------------
     // Normal response
     //--------------------------------------------------------------------------
@@ -307,4 +321,87 @@ namespace XrdCl
     }
     return true;
   }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  BulkStatInfo::BulkStatInfo()
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  BulkStatInfo::~BulkStatInfo()
+  {
+    for( Iterator it = pEntries.begin(); it != pEntries.end(); ++it )
+      delete *it;
+  }
+
+  //----------------------------------------------------------------------------
+  // Parse the bulk stat response
+  //----------------------------------------------------------------------------
+  bool BulkStatInfo::ParseServerResponse( const std::string &paths,
+                                          const char        *data )
+  {
+    if( !data )
+      return false;
+
+    //--------------------------------------------------------------------------
+    // There is one line in the response for each path that was requested,
+    // in the same order
+    //--------------------------------------------------------------------------
+    std::vector<std::string> pathList;
+    std::vector<std::string> lines;
+    Utils::splitString( pathList, paths, "\n" );
+    Utils::splitString( lines, data, "\n" );
+
+    if( lines.size() != pathList.size() )
+      return false;
+
+    for( size_t i = 0; i < lines.size(); ++i )
+    {
+      std::vector<std::string> chunks;
+      Utils::splitString( chunks, lines[i], " " );
+
+      if( chunks.empty() )
+        return false;
+
+      char *result;
+      uint32_t rc = ::strtol( chunks[0].c_str(), &result, 0 );
+      if( *result != 0 )
+        return false;
+
+      //------------------------------------------------------------------------
+      // The path could not be stat'ed, the line holds just the error code
+      //------------------------------------------------------------------------
+      if( rc )
+      {
+        Add( new Entry( pathList[i], XRootDStatus( stError, errErrorResponse,
+                                                   rc ) ) );
+        continue;
+      }
+
+      //------------------------------------------------------------------------
+      // Stat information, optionally followed by the checksum
+      //------------------------------------------------------------------------
+      if( chunks.size() != 5 && chunks.size() != 7 )
+        return false;
+
+      std::string statStr = chunks[1] + " " + chunks[2] + " " + chunks[3] +
+                            " " + chunks[4];
+      StatInfo *info = new StatInfo();
+      if( !info->ParseServerResponse( statStr.c_str() ) )
+      {
+        delete info;
+        return false;
+      }
+
+      Entry *entry = new Entry( pathList[i], XRootDStatus(), info );
+      if( chunks.size() == 7 )
+        entry->SetChecksum( chunks[5] + " " + chunks[6] );
+      Add( entry );
+    }
+    return true;
+  }
 }
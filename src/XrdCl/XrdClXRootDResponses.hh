@@ -681,6 +681,23 @@ namespace XrdCl
           pParent += "/";
       }
 
+      //------------------------------------------------------------------------
+      //! Get the cursor of the next page of a paged listing, 0 if the listing
+      //! is complete
+      //------------------------------------------------------------------------
+      uint32_t GetCursor() const
+      {
+        return pCursor;
+      }
+
+      //------------------------------------------------------------------------
+      //! Set the cursor of the next page of a paged listing
+      //------------------------------------------------------------------------
+      void SetCursor( uint32_t cursor )
+      {
+        pCursor = cursor;
+      }
+
       //------------------------------------------------------------------------
       //! Parse server response and fill up the object
       //------------------------------------------------------------------------
@@ -690,6 +707,179 @@ namespace XrdCl
     private:
       DirList     pDirList;
       std::string pParent;
+      uint32_t    pCursor;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Status information for a list of paths (bulk stat)
+  //----------------------------------------------------------------------------
+  class BulkStatInfo
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Status information of a single path
+      //------------------------------------------------------------------------
+      class Entry
+      {
+        public:
+          //--------------------------------------------------------------------
+          //! Constructor
+          //--------------------------------------------------------------------
+          Entry( const std::string  &path,
+                 const XRootDStatus &status,
+                 StatInfo           *statInfo = 0 ):
+            pPath( path ),
+            pStatus( status ),
+            pStatInfo( statInfo )
+          {}
+
+          //--------------------------------------------------------------------
+          //! Destructor
+          //--------------------------------------------------------------------
+          ~Entry()
+          {
+            delete pStatInfo;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the path
+          //--------------------------------------------------------------------
+          const std::string &GetPath() const
+          {
+            return pPath;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the status of the stat operation for this path
+          //--------------------------------------------------------------------
+          const XRootDStatus &GetStatus() const
+          {
+            return pStatus;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the stat info object, 0 if the path could not be stat'ed
+          //--------------------------------------------------------------------
+          const StatInfo *GetStatInfo() const
+          {
+            return pStatInfo;
+          }
+
+          //--------------------------------------------------------------------
+          //! Get the checksum as "<type> <value>", empty if not available
+          //--------------------------------------------------------------------
+          const std::string &GetChecksum() const
+          {
+            return pChecksum;
+          }
+
+          //--------------------------------------------------------------------
+          //! Set the checksum
+          //--------------------------------------------------------------------
+          void SetChecksum( const std::string &checksum )
+          {
+            pChecksum = checksum;
+          }
+
+        private:
+          std::string   pPath;
+          XRootDStatus  pStatus;
+          StatInfo     *pStatInfo;
+          std::string   pChecksum;
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      BulkStatInfo();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~BulkStatInfo();
+
+      //------------------------------------------------------------------------
+      //! List of entries
+      //------------------------------------------------------------------------
+      typedef std::vector<Entry*>         EntryList;
+
+      //------------------------------------------------------------------------
+      //! Entry list iterator
+      //------------------------------------------------------------------------
+      typedef EntryList::iterator         Iterator;
+
+      //------------------------------------------------------------------------
+      //! Entry list const iterator
+      //------------------------------------------------------------------------
+      typedef EntryList::const_iterator   ConstIterator;
+
+      //------------------------------------------------------------------------
+      //! Add an entry to the list - takes ownership
+      //------------------------------------------------------------------------
+      void Add( Entry *entry )
+      {
+        pEntries.push_back( entry );
+      }
+
+      //------------------------------------------------------------------------
+      //! Get an entry at given index
+      //------------------------------------------------------------------------
+      Entry *At( uint32_t index )
+      {
+        return pEntries[index];
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the begin iterator
+      //------------------------------------------------------------------------
+      Iterator Begin()
+      {
+        return pEntries.begin();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the begin iterator
+      //------------------------------------------------------------------------
+      ConstIterator Begin() const
+      {
+        return pEntries.begin();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the end iterator
+      //------------------------------------------------------------------------
+      Iterator End()
+      {
+        return pEntries.end();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the end iterator
+      //------------------------------------------------------------------------
+      ConstIterator End() const
+      {
+        return pEntries.end();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the number of entries
+      //------------------------------------------------------------------------
+      uint32_t GetSize() const
+      {
+        return pEntries.size();
+      }
+
+      //------------------------------------------------------------------------
+      //! Parse server response and fill up the object
+      //!
+      //! @param paths newline separated list of the paths that were requested
+      //! @param data  the server response
+      //------------------------------------------------------------------------
+      bool ParseServerResponse( const std::string &paths,
+                                const char        *data );
+
+    private:
+      EntryList pEntries;
   };
 
   //----------------------------------------------------------------------------
@@ -826,6 +826,14 @@ namespace XrdCl
         req->mkdir.mode = htons( req->mkdir.mode );
         break;
 
+      //------------------------------------------------------------------------
+      // kXR_dirlist
+      //------------------------------------------------------------------------
+      case kXR_dirlist:
+        req->dirlist.pgsize   = htonl( req->dirlist.pgsize );
+        req->dirlist.pgcursor = htonl( req->dirlist.pgcursor );
+        break;
+
       //------------------------------------------------------------------------
       // kXR_chmod
       //------------------------------------------------------------------------
@@ -2208,6 +2216,28 @@ namespace XrdCl
         break;
       }
 
+      //------------------------------------------------------------------------
+      // kXR_statm
+      //------------------------------------------------------------------------
+      case kXR_statm:
+      {
+        ClientStatRequest *sreq = (ClientStatRequest *)msg->GetBuffer();
+        o << "kXR_statm (";
+        char *fn = GetDataAsString( msg );
+        uint32_t count = 1;
+        for( char *cursor = fn; *cursor; ++cursor )
+          if( *cursor == '\n' ) ++count;
+        o << "paths: " << count << ", ";
+        delete [] fn;
+        o << "flags: ";
+        if( sreq->options & kXR_retcks )
+          o << "kXR_retcks";
+        else
+          o << "none";
+        o << ")";
+        break;
+      }
+
       //------------------------------------------------------------------------
       // kXR_read
       //------------------------------------------------------------------------
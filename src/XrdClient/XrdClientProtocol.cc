@@ -429,8 +429,17 @@ void smartPrintClientHeader(ClientRequest* hdr)
 
    case kXR_dirlist:
       fprintf(stderr, "%40s0 repeated %d times\n", 
-             "ClientHeader.dirlist.reserved = ",
-             (kXR_int32)sizeof(hdr->dirlist.reserved));
+             "ClientHeader.dirlist.reserved1 = ",
+             (kXR_int32)sizeof(hdr->dirlist.reserved1));
+      fprintf(stderr, "%40s%d \n",
+             "ClientHeader.dirlist.pgsize = ",
+             hdr->dirlist.pgsize);
+      fprintf(stderr, "%40s%d \n",
+             "ClientHeader.dirlist.pgcursor = ",
+             hdr->dirlist.pgcursor);
+      fprintf(stderr, "%40s0 repeated %d times\n",
+             "ClientHeader.dirlist.reserved2 = ",
+             (kXR_int32)sizeof(hdr->dirlist.reserved2));
       break;
    case kXR_locate:
       fprintf(stderr, "  ClientHeader.locate.options= 0x%.2x 0x%.2x \n", 
@@ -19,10 +19,13 @@ add_library(
   XrdFileCache/XrdFileCache.cc              XrdFileCache/XrdFileCache.hh
   XrdFileCache/XrdFileCacheConfiguration.cc
   XrdFileCache/XrdFileCachePurge.cc
+  XrdFileCache/XrdFileCachePurgeIndex.cc    XrdFileCache/XrdFileCachePurgeIndex.hh
   XrdFileCache/XrdFileCacheFile.cc          XrdFileCache/XrdFileCacheFile.hh
   XrdFileCache/XrdFileCacheVRead.cc
+  XrdFileCache/XrdFileCacheAccessModel.cc   XrdFileCache/XrdFileCacheAccessModel.hh
   XrdFileCache/XrdFileCacheStats.hh
   XrdFileCache/XrdFileCacheInfo.cc          XrdFileCache/XrdFileCacheInfo.hh
+  XrdFileCache/XrdFileCacheInfoIndex.cc     XrdFileCache/XrdFileCacheInfoIndex.hh
   XrdFileCache/XrdFileCacheIO.cc            XrdFileCache/XrdFileCacheIO.hh
   XrdFileCache/XrdFileCacheIOEntireFile.cc  XrdFileCache/XrdFileCacheIOEntireFile.hh
   XrdFileCache/XrdFileCacheIOFileBlock.cc   XrdFileCache/XrdFileCacheIOFileBlock.hh
@@ -67,7 +70,8 @@ set_target_properties(
 add_executable(
   xrdpfc_print
   XrdFileCache/XrdFileCachePrint.hh  XrdFileCache/XrdFileCachePrint.cc
-  XrdFileCache/XrdFileCacheInfo.hh  XrdFileCache/XrdFileCacheInfo.cc)
+  XrdFileCache/XrdFileCacheInfo.hh  XrdFileCache/XrdFileCacheInfo.cc
+  XrdFileCache/XrdFileCacheInfoIndex.hh  XrdFileCache/XrdFileCacheInfoIndex.cc)
 
 target_link_libraries(
   xrdpfc_print
@@ -49,10 +49,9 @@ void *CacheDirCleanupThread(void* cache_void)
    return NULL;
 }
 
-void *ProcessWriteTaskThread(void* c)
+void *ProcessWriteTaskThread(void* q)
 {
-   Cache *cache = static_cast<Cache*>(c);
-   cache->ProcessWriteTasks();
+   Cache::GetInstance().ProcessWriteTasks((int)(long) q);
    return NULL;
 }
 
@@ -80,9 +79,6 @@ XrdOucCache2 *XrdOucGetCache2(XrdSysLogger *logger,
    }
    err.Emsg("Retrieve", "Success - returning a factory.");
 
-   pthread_t tid1;
-   XrdSysThread::Run(&tid1, ProcessWriteTaskThread, (void*)(&factory), 0, "XrdFileCache WriteTasks ");
-
    pthread_t tid2;
    XrdSysThread::Run(&tid2, PrefetchThread, (void*)(&factory), 0, "XrdFileCache Prefetch ");
 
@@ -147,7 +143,9 @@ Cache::Cache() : XrdOucCache(),
    m_log(0, "XrdFileCache_"),
    m_trace(0),
    m_traceID("Manager"),
+   m_infoIndex(0),
    m_prefetch_condVar(0),
+   m_prefetch_active(0),
    m_RAMblocks_used(0),
    m_isClient(false)
 {
@@ -189,62 +187,123 @@ int Cache::isAttached()
    return true;
 }
 
+//______________________________________________________________________________
+int
+Cache::GetWriteQueue(dev_t dev)
+{
+   XrdSysMutexHelper lock(&m_writeQs_mutex);
+
+   for (size_t i = 0; i < m_writeQs.size(); ++i)
+   {
+      if (m_writeQs[i]->dev == dev) return i;
+   }
+
+   int qidx = m_writeQs.size();
+   m_writeQs.push_back(new WriteQ(dev));
+
+   TRACE(Info, "Cache::GetWriteQueue() starting " << m_configuration.m_wqueue_thrds << " writer threads for device " << dev);
+   for (int i = 0; i < m_configuration.m_wqueue_thrds; ++i)
+   {
+      pthread_t tid;
+      XrdSysThread::Run(&tid, ProcessWriteTaskThread, (void*)(long) qidx, 0, "XrdFileCache WriteTasks ");
+   }
+   return qidx;
+}
+
+//______________________________________________________________________________
+Cache::WriteQ&
+Cache::get_write_queue(int qidx)
+{
+   XrdSysMutexHelper lock(&m_writeQs_mutex);
+   return *m_writeQs[qidx];
+}
+
 //______________________________________________________________________________
 void
 Cache::AddWriteTask(Block* b, bool fromRead)
 {
    TRACE(Dump, "Cache::AddWriteTask() bOff=%ld " <<  b->m_offset);
-   m_writeQ.condVar.Lock();
+   WriteQ &wq = get_write_queue(b->m_file->GetWriteQueue());
+   wq.condVar.Lock();
    if (fromRead)
-      m_writeQ.queue.push_back(b);
+      wq.queue.push_back(b);
    else
-      m_writeQ.queue.push_front(b);
-   m_writeQ.size++;
-   m_writeQ.condVar.Signal();
-   m_writeQ.condVar.UnLock();
+      wq.queue.push_front(b);
+   wq.size++;
+   wq.condVar.Signal();
+   wq.condVar.UnLock();
 }
 
 //______________________________________________________________________________
 void Cache::RemoveWriteQEntriesFor(File *iFile)
 {
-   m_writeQ.condVar.Lock();
-   std::list<Block*>::iterator i = m_writeQ.queue.begin();
-   while (i != m_writeQ.queue.end())
+   if (iFile->GetWriteQueue() < 0) return;
+
+   WriteQ &wq = get_write_queue(iFile->GetWriteQueue());
+   wq.condVar.Lock();
+   std::list<Block*>::iterator i = wq.queue.begin();
+   while (i != wq.queue.end())
    {
       if ((*i)->m_file == iFile)
       {
          TRACE(Dump, "Cache::Remove entries for " <<  (void*)(*i) << " path " <<  iFile->lPath());
          std::list<Block*>::iterator j = i++;
          iFile->BlockRemovedFromWriteQ(*j);
-         m_writeQ.queue.erase(j);
-         --m_writeQ.size;
+         wq.queue.erase(j);
+         --wq.size;
       }
       else
       {
          ++i;
       }
    }
-   m_writeQ.condVar.UnLock();
+   wq.condVar.UnLock();
 }
 
 //______________________________________________________________________________
 void
-Cache::ProcessWriteTasks()
+Cache::ProcessWriteTasks(int qidx)
 {
+   WriteQ &wq = get_write_queue(qidx);
+   std::list<Block*> blks;
+
    while (true)
    {
-      m_writeQ.condVar.Lock();
-      while (m_writeQ.queue.empty())
+      wq.condVar.Lock();
+      while (wq.queue.empty())
       {
-         m_writeQ.condVar.Wait();
+         wq.condVar.Wait();
       }
-      Block* block = m_writeQ.queue.front();
-      m_writeQ.queue.pop_front();
-      m_writeQ.size--;
+      Block* block = wq.queue.front();
+      wq.queue.pop_front();
+      wq.size--;
       TRACE(Dump, "Cache::ProcessWriteTasks  for %p " <<  (void*)(block) << " path " << block->m_file->lPath());
-      m_writeQ.condVar.UnLock();
+      blks.push_back(block);
+
+      // Take along queued blocks of the same file that directly follow this
+      // one so that they get written with a single call.
+      long long next = block->m_offset + block->get_size();
+      bool      found = true;
+      while (found && (int) blks.size() < m_configuration.m_wqueue_blocks)
+      {
+         found = false;
+         for (std::list<Block*>::iterator i = wq.queue.begin(); i != wq.queue.end(); ++i)
+         {
+            if ((*i)->m_file == block->m_file && (*i)->m_offset == next)
+            {
+               next += (*i)->get_size();
+               blks.push_back(*i);
+               wq.queue.erase(i);
+               wq.size--;
+               found = true;
+               break;
+            }
+         }
+      }
+      wq.condVar.UnLock();
 
-      block->m_file->WriteBlockToDisk(block);
+      block->m_file->WriteBlocksToDisk(blks);
+      blks.clear();
    }
 }
 
@@ -265,8 +324,14 @@ Cache::RequestRAMBlock()
 void
 Cache::RAMBlockReleased()
 {
-   XrdSysMutexHelper lock(&m_RAMblock_mutex);
+   m_RAMblock_mutex.Lock();
    m_RAMblocks_used--;
+   m_RAMblock_mutex.UnLock();
+
+   // The prefetcher may be waiting for RAM to become available
+   m_prefetch_condVar.Lock();
+   m_prefetch_condVar.Signal();
+   m_prefetch_condVar.UnLock();
 }
 
 
@@ -395,6 +460,7 @@ void Cache::dec_ref_cnt(File* f)
    {
       ActiveMap_i it = m_active.find(f->GetLocalPath());
       m_active.erase(it);
+      if (f->isOpen()) m_purgeIndex.Update(f->GetLocalPath(), f->RefInfo(), time(0));
       delete f;
    }
    m_active_mutex.UnLock();
@@ -463,18 +529,46 @@ Cache::DeRegisterPrefetchFile(File* file)
 File*
 Cache::GetNextFileToPrefetch()
 {
+   // Wait until there is a file to prefetch, the number of requests in
+   // flight is below the limit and RAM is not nearly used up.
+   const int limitRAM = int( m_configuration.m_NRamBuffers * 0.7 );
+
    m_prefetch_condVar.Lock();
-   while (m_prefetchList.empty())
+   while (true)
    {
+      if ( ! m_prefetchList.empty() && m_prefetch_active < m_configuration.m_prefetch_inflight)
+      {
+         m_RAMblock_mutex.Lock();
+         bool doPrefetch = (m_RAMblocks_used < limitRAM);
+         m_RAMblock_mutex.UnLock();
+         if (doPrefetch) break;
+      }
       m_prefetch_condVar.Wait();
    }
 
-   //  std::sort(m_prefetchList.begin(), m_prefetchList.end(), myobject);
+   // Pick a file with probability proportional to its prefetch score and
+   // to the number of recent client requests. Files that have not proven
+   // useful yet keep a small chance of being picked.
+   time_t now = time(0);
+   size_t l   = m_prefetchList.size();
+   std::vector<float> weight(l);
+   float sum = 0;
+   for (size_t i = 0; i < l; ++i)
+   {
+      File *f = m_prefetchList[i];
+      weight[i] = (0.1f + f->GetPrefetchScore()) * (1 + f->GetPrefetchDemand(now));
+      sum += weight[i];
+   }
 
-   size_t l = m_prefetchList.size();
-   int idx = rand() % l;
+   float  r   = sum * (rand() / (RAND_MAX + 1.0f));
+   size_t idx = 0;
+   while (idx < l - 1 && r >= weight[idx])
+   {
+      r -= weight[idx++];
+   }
    File* f = m_prefetchList[idx];
 
+   ++m_prefetch_active;
    m_prefetch_condVar.UnLock();
    return f;
 }
@@ -495,11 +589,11 @@ Cache::Prepare(const char *url, int oflags, mode_t mode)
    std::string curl(url);
    XrdCl::URL xx(curl);
    std::string spath = xx.GetPath();
+   bool inIndex = m_infoIndex && m_infoIndex->Has(spath);
    spath += ".cinfo";
 
    struct stat buf;
-   int res = m_output_fs->Stat(spath.c_str(), &buf);
-   if (res == 0)
+   if (inIndex || m_output_fs->Stat(spath.c_str(), &buf) == 0)
    {
       TRACE( Dump, "Cache::Prefetch defer open " << spath);
       return 1;
@@ -522,6 +616,17 @@ int Cache::Stat(const char *curl, struct stat &sbuff)
 {
    XrdCl::URL url(curl);
    std::string name = url.GetPath();
+
+   if (m_infoIndex)
+   {
+      Info info(m_trace, 0);
+      if (info.Read(*m_infoIndex, name) && m_output_fs->Stat(name.c_str(), &sbuff) == XrdOssOK)
+      {
+         sbuff.st_size = info.GetFileSize();
+         return 0;
+      }
+   }
+
    name += ".cinfo";
 
    if (m_output_fs->Stat(name.c_str(), &sbuff) == XrdOssOK)
@@ -558,22 +663,25 @@ int Cache::Stat(const char *curl, struct stat &sbuff)
 void
 Cache::Prefetch()
 {
-   int limitRAM = int( Cache::GetInstance().RefConfiguration().m_NRamBuffers * 0.7 );
+   // Block requests are asynchronous so this one thread keeps up to
+   // m_prefetch_inflight of them outstanding.
    while (true)
    {
-      m_RAMblock_mutex.Lock();
-      bool doPrefetch = (m_RAMblocks_used < limitRAM);
-      m_RAMblock_mutex.UnLock();
-
-      if (doPrefetch)
-      {
-         File* f = GetNextFileToPrefetch();
-         f->Prefetch();
-      }
-      else
+      File* f = GetNextFileToPrefetch();
+      if ( ! f->Prefetch())
       {
-         XrdSysTimer::Wait(5);
+         PrefetchBlockDone();
       }
    }
 }
+
+//______________________________________________________________________________
+void
+Cache::PrefetchBlockDone()
+{
+   m_prefetch_condVar.Lock();
+   --m_prefetch_active;
+   m_prefetch_condVar.Signal();
+   m_prefetch_condVar.UnLock();
+}
 //______________________________________________________________________________
@@ -19,6 +19,8 @@
 //----------------------------------------------------------------------------------
 #include <string>
 #include <list>
+#include <vector>
+#include <sys/types.h>
 
 #include "Xrd/XrdScheduler.hh"
 #include "XrdVersion.hh"
@@ -28,6 +30,8 @@
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdFileCacheFile.hh"
 #include "XrdFileCacheDecision.hh"
+#include "XrdFileCachePurgeIndex.hh"
+#include "XrdFileCacheInfoIndex.hh"
 
 class XrdOucStream;
 class XrdSysError;
@@ -56,12 +60,17 @@ struct Configuration
       m_diskUsageLWM(-1),
       m_diskUsageHWM(-1),
       m_purgeInterval(300),
+      m_purgePolicy(PurgeIndex::kGDSF),
+      m_infoIndexSlots(0),
       m_bufferSize(1024*1024),
       m_RamAbsAvailable(0),
       m_NRamBuffers(-1),
       m_prefetch_max_blocks(10),
+      m_prefetch_inflight(32),
       m_hdfsbsize(128*1024*1024),
-      m_flushCnt(100)
+      m_flushCnt(100),
+      m_wqueue_thrds(1),
+      m_wqueue_blocks(16)
    {}
 
    bool m_hdfsmode;                     //!< flag for enabling block-level operation
@@ -73,14 +82,20 @@ struct Configuration
    long long m_diskUsageLWM;            //!< cache purge low water mark
    long long m_diskUsageHWM;            //!< cache purge high water mark
    int       m_purgeInterval;           //!< sleep interval between cache purges
+   PurgeIndex::Policy_e m_purgePolicy;  //!< order in which files are purged
+   int       m_infoIndexSlots;          //!< slots of the info index, 0 to use cinfo files
 
    long long m_bufferSize;              //!< prefetch buffer size, default 1MB
    long long m_RamAbsAvailable;         //!< available from configuration
    int       m_NRamBuffers;             //!< number of total in-memory cache blocks, cached
    size_t    m_prefetch_max_blocks;     //!< maximum number of blocks to prefetch per file
+   int       m_prefetch_inflight;       //!< maximum number of prefetch requests in flight for all files
 
    long long m_hdfsbsize;               //!< used with m_hdfsmode, default 128MB
    long long m_flushCnt;                //!< nuber of unsynced blcoks on disk before flush is called
+
+   int       m_wqueue_thrds;            //!< number of disk writer threads per device
+   int       m_wqueue_blocks;           //!< maximum number of consecutive blocks written in one call
 };
 
 struct TmpConfiguration
@@ -170,6 +185,11 @@ public:
    //---------------------------------------------------------------------
    void CacheDirCleanup();
 
+   //---------------------------------------------------------------------
+   //! Rebuild the purge index from the cinfo files in the cache.
+   //---------------------------------------------------------------------
+   bool ScanCacheDir();
+
    //---------------------------------------------------------------------
    //! Add downloaded block in write queue.
    //---------------------------------------------------------------------
@@ -181,10 +201,16 @@ public:
    //---------------------------------------------------------------------
    void RemoveWriteQEntriesFor(File *f);
 
+   //---------------------------------------------------------------------
+   //! \brief Return index of the write queue serving the given device.
+   //! The queue and its writer threads are created on first use.
+   //---------------------------------------------------------------------
+   int GetWriteQueue(dev_t dev);
+
    //---------------------------------------------------------------------
    //! Separate task which writes blocks from ram to disk.
    //---------------------------------------------------------------------
-   void ProcessWriteTasks();
+   void ProcessWriteTasks(int qidx);
 
    bool RequestRAMBlock();
 
@@ -197,8 +223,18 @@ public:
 
    void Prefetch();
 
+   //---------------------------------------------------------------------
+   //! Called when a prefetch block request has completed.
+   //---------------------------------------------------------------------
+   void PrefetchBlockDone();
+
    XrdOss* GetOss() const { return m_output_fs; }
 
+   //---------------------------------------------------------------------
+   //! Info index used instead of cinfo files, 0 when not enabled.
+   //---------------------------------------------------------------------
+   InfoIndex* GetInfoIndex() const { return m_infoIndex; }
+
    bool HaveActiveFileWithLocalPath(std::string);
    
    File* GetFile(const std::string&, IO*, long long off = 0, long long filesize = 0);
@@ -227,6 +263,7 @@ private:
 
    XrdOucCacheStats  m_stats;           //!<
    XrdOss           *m_output_fs;       //!< disk cache file system
+   InfoIndex        *m_infoIndex;       //!< shared store of file states, optional
 
    std::vector<XrdFileCache::Decision*> m_decisionpoints;       //!< decision plugins
 
@@ -235,6 +272,7 @@ private:
    Configuration m_configuration;           //!< configurable parameters
 
    XrdSysCondVar m_prefetch_condVar;        //!< central lock for this class
+   int           m_prefetch_active;         //!< prefetch block requests in flight
 
    XrdSysMutex m_RAMblock_mutex;            //!< central lock for this class
    int         m_RAMblocks_used;
@@ -242,13 +280,17 @@ private:
 
    struct WriteQ
    {
-      WriteQ() : condVar(0), size(0) {}
+      WriteQ(dev_t d) : condVar(0), size(0), dev(d) {}
       XrdSysCondVar     condVar;      //!< write list condVar
       size_t            size;         //!< cache size of a container
       std::list<Block*> queue;        //!< container
+      dev_t             dev;          //!< device of the data files
    };
 
-   WriteQ m_writeQ;
+   std::vector<WriteQ*> m_writeQs;         //!< one write queue per device
+   XrdSysMutex          m_writeQs_mutex;
+
+   WriteQ& get_write_queue(int qidx);
 
    // active map
    typedef std::map<std::string, File*> ActiveMap_t;
@@ -262,6 +304,8 @@ private:
 
    void schedule_file_sync(File*, bool ref_cnt_already_set);
 
+   PurgeIndex   m_purgeIndex;               //!< cached files in purge order
+
    // prefetching
    typedef std::vector<File*>  PrefetchList;
    PrefetchList m_prefetchList;
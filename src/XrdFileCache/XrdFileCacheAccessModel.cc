@@ -0,0 +1,194 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdFileCacheAccessModel.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+   // Counters saturate so that a long history can still be overturned.
+   const int   s_maxCnt            = 64;
+   // Vector reads must touch at least this fraction of the blocks they span
+   // for prefetching of whole blocks around them to pay off.
+   const float s_minClusterDensity = 0.5f;
+
+   inline void inc_cnt(int& c) { if (c < s_maxCnt) ++c; }
+}
+
+//______________________________________________________________________________
+
+AccessModel::AccessModel() :
+   m_nRequests(0),
+   m_lastFirst(-1),
+   m_lastLast(-1),
+   m_seqCnt(0),
+   m_stride(0),
+   m_strideCnt(0),
+   m_clusterFirst(-1),
+   m_clusterLast(-1),
+   m_clusterDensity(0),
+   m_clusterCnt(0),
+   m_lastWasVec(false),
+   m_pattern(kUnknown)
+{}
+
+//______________________________________________________________________________
+
+void AccessModel::RegisterRead(int first, int last)
+{
+   if (m_nRequests > 0 && ! m_lastWasVec)
+   {
+      if (first >= m_lastFirst && first <= m_lastLast + 1)
+      {
+         inc_cnt(m_seqCnt);
+         m_strideCnt = 0;
+      }
+      else
+      {
+         m_seqCnt = 0;
+         const int stride = first - m_lastFirst;
+         if (stride == m_stride)
+         {
+            inc_cnt(m_strideCnt);
+         }
+         else
+         {
+            m_stride    = stride;
+            m_strideCnt = 0;
+         }
+      }
+   }
+   else
+   {
+      m_seqCnt = m_strideCnt = 0;
+   }
+
+   m_lastFirst  = first;
+   m_lastLast   = last;
+   m_lastWasVec = false;
+   ++m_nRequests;
+
+   update_pattern();
+}
+
+//______________________________________________________________________________
+
+void AccessModel::RegisterReadV(const std::vector<int>& blocks)
+{
+   if (blocks.empty()) return;
+
+   const int first = blocks.front();
+   const int last  = blocks.back();
+
+   if (m_nRequests > 0 && m_lastWasVec && first > m_clusterFirst && last > m_clusterLast)
+      inc_cnt(m_clusterCnt);
+   else
+      m_clusterCnt = 0;
+
+   m_clusterFirst   = first;
+   m_clusterLast    = last;
+   m_clusterDensity = float(blocks.size()) / (last - first + 1);
+
+   m_lastFirst  = first;
+   m_lastLast   = last;
+   m_seqCnt     = m_strideCnt = 0;
+   m_lastWasVec = true;
+   ++m_nRequests;
+
+   update_pattern();
+}
+
+//______________________________________________________________________________
+
+void AccessModel::update_pattern()
+{
+   if (m_lastWasVec)
+   {
+      if (m_clusterCnt >= 1 && m_clusterDensity >= s_minClusterDensity)
+         m_pattern = kClustered;
+      else
+         m_pattern = (m_nRequests < 2) ? kUnknown : kRandom;
+   }
+   else if (m_seqCnt >= 1)
+   {
+      m_pattern = kSequential;
+   }
+   else if (m_strideCnt >= 2)
+   {
+      m_pattern = kStrided;
+   }
+   else
+   {
+      m_pattern = (m_nRequests < 3) ? kUnknown : kRandom;
+   }
+}
+
+//______________________________________________________________________________
+
+bool AccessModel::Predict(std::vector<int>& blocks, int n) const
+{
+   blocks.clear();
+
+   switch (m_pattern)
+   {
+      case kSequential:
+      {
+         for (int i = 1; i <= n; ++i)
+            blocks.push_back(m_lastLast + i);
+         break;
+      }
+      case kStrided:
+      {
+         const int span = m_lastLast - m_lastFirst + 1;
+         for (int k = 1; k <= n && (int) blocks.size() < n; ++k)
+         {
+            const int base = m_lastFirst + k * m_stride;
+            if (base < 0) break;
+            for (int j = 0; j < span && (int) blocks.size() < n; ++j)
+               blocks.push_back(base + j);
+         }
+         break;
+      }
+      case kClustered:
+      {
+         const int span = m_clusterLast - m_clusterFirst + 1;
+         for (int i = 1; i <= n && i <= span; ++i)
+            blocks.push_back(m_clusterLast + i);
+         break;
+      }
+      default:
+         return false;
+   }
+
+   return true;
+}
+
+//______________________________________________________________________________
+
+const char* AccessModel::PatternName(Pattern_e p)
+{
+   switch (p)
+   {
+      case kSequential: return "sequential";
+      case kStrided:    return "strided";
+      case kClustered:  return "clustered";
+      case kRandom:     return "random";
+      default:          return "unknown";
+   }
+}
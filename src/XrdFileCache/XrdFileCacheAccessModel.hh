@@ -0,0 +1,81 @@
+#ifndef __XRDFILECACHE_ACCESSMODEL_HH__
+#define __XRDFILECACHE_ACCESSMODEL_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <vector>
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! Client access pattern of a cached file, in units of file blocks.
+//! Learns from the offsets of reads and vector reads and predicts which
+//! blocks are going to be requested next. Not thread safe, the owning File
+//! calls it with its download lock held.
+//----------------------------------------------------------------------------
+class AccessModel
+{
+public:
+   enum Pattern_e { kUnknown, kSequential, kStrided, kClustered, kRandom };
+
+   AccessModel();
+
+   //----------------------------------------------------------------------
+   //! Register a read spanning blocks first to last.
+   //----------------------------------------------------------------------
+   void RegisterRead(int first, int last);
+
+   //----------------------------------------------------------------------
+   //! Register a vector read touching the given blocks.
+   //! @param blocks indices of touched blocks, sorted, without duplicates
+   //----------------------------------------------------------------------
+   void RegisterReadV(const std::vector<int>& blocks);
+
+   //----------------------------------------------------------------------
+   //! \brief Predict blocks to be read next, most urgent first.
+   //!
+   //! @param blocks output, cleared first
+   //! @param n      maximum number of blocks to return
+   //!
+   //! @return false when there is no usable pattern
+   //----------------------------------------------------------------------
+   bool Predict(std::vector<int>& blocks, int n) const;
+
+   Pattern_e GetPattern() const { return m_pattern; }
+
+   static const char* PatternName(Pattern_e p);
+
+private:
+   void update_pattern();
+
+   int       m_nRequests;     //!< number of registered requests
+   int       m_lastFirst;     //!< first block of last read
+   int       m_lastLast;      //!< last block of last read
+   int       m_seqCnt;        //!< consecutive reads continuing the previous one
+   int       m_stride;        //!< distance between the first blocks of the last two reads
+   int       m_strideCnt;     //!< consecutive reads confirming m_stride
+   int       m_clusterFirst;  //!< first block of last vector read
+   int       m_clusterLast;   //!< last block of last vector read
+   float     m_clusterDensity;//!< fraction of blocks in cluster range that were touched
+   int       m_clusterCnt;    //!< consecutive vector reads moving forward through the file
+   bool      m_lastWasVec;    //!< last request was a vector read
+   Pattern_e m_pattern;
+};
+}
+
+#endif
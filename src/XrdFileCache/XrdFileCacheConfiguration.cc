@@ -265,26 +265,37 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
       float rg =  (m_configuration.m_RamAbsAvailable)/float(1024*1024*1024);
       loff = snprintf(buff, sizeof(buff), "Config effective %s pfc configuration:\n"
                       "       pfc.blocksize %lld\n"
-                      "       pfc.prefetch %zu\n"
+                      "       pfc.prefetch %zu inflight %d\n"
                       "       pfc.ram %.fg\n"
                       "       pfc.diskusage %lld %lld sleep %d\n"
+                      "       pfc.purgepolicy %s\n"
                       "       pfc.spaces %s %s\n"
                       "       pfc.trace %d\n"
-                      "       pfc.flush %lld",
+                      "       pfc.flush %lld\n"
+                      "       pfc.writequeue %d %d",
                       config_filename,
                       m_configuration.m_bufferSize,
                       m_configuration.m_prefetch_max_blocks,
+                      m_configuration.m_prefetch_inflight,
                       rg,
                       m_configuration.m_diskUsageLWM,
                       m_configuration.m_diskUsageHWM,
                       m_configuration.m_purgeInterval,
+                      PurgeIndex::PolicyName(m_configuration.m_purgePolicy),
                       m_configuration.m_data_space.c_str(),
                       m_configuration.m_meta_space.c_str(),
                       m_trace->What,
-                      m_configuration.m_flushCnt);
+                      m_configuration.m_flushCnt,
+                      m_configuration.m_wqueue_thrds,
+                      m_configuration.m_wqueue_blocks);
 
 
 
+      if (m_configuration.m_infoIndexSlots > 0)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "\n       pfc.infoindex %d", m_configuration.m_infoIndexSlots);
+      }
+
       if (m_configuration.m_hdfsmode)
       {
          char buff2[512];
@@ -307,6 +318,19 @@ bool Cache::Config(XrdSysLogger *logger, const char *config_filename, const char
       m_log.Say( buff);
    }
 
+   if (retval && m_configuration.m_infoIndexSlots > 0)
+   {
+      m_infoIndex = new InfoIndex(m_trace);
+      if ( ! m_infoIndex->Open(m_output_fs, m_configuration.m_username, m_configuration.m_meta_space,
+                               InfoIndex::m_indexName, m_configuration.m_infoIndexSlots))
+      {
+         TRACE(Error, "Cache::Config() can't open info index");
+         delete m_infoIndex;
+         m_infoIndex = 0;
+         retval = false;
+      }
+   }
+
    m_log.Say("------ File Caching Proxy interface initialization ", retval ? "completed" : "failed");
 
    if (ofsCfg) delete ofsCfg;
@@ -344,6 +368,25 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
          }
       }
    }
+   else if ( part == "purgepolicy" )
+   {
+      const char *p = config.GetWord();
+      if      (p && ! strcmp(p, "lru"))  m_configuration.m_purgePolicy = PurgeIndex::kLRU;
+      else if (p && ! strcmp(p, "lru2")) m_configuration.m_purgePolicy = PurgeIndex::kLRU2;
+      else if (p && ! strcmp(p, "gdsf")) m_configuration.m_purgePolicy = PurgeIndex::kGDSF;
+      else
+      {
+         m_log.Emsg("Config", "Error: purgepolicy must be lru, lru2 or gdsf.");
+         return false;
+      }
+   }
+   else if ( part == "infoindex" )
+   {
+      if (XrdOuca2x::a2i(m_log, "Error getting number of info index slots", config.GetWord(), &m_configuration.m_infoIndexSlots, 0, 1 << 28))
+      {
+         return false;
+      }
+   }
    else if  ( part == "blocksize" )
    {
       long long minBSize = 64 * 1024;
@@ -374,6 +417,14 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
             m_log.Emsg("Config", "Prefetch is disabled");
             m_configuration.m_prefetch_max_blocks = 0;
          }
+         const char *p2 = config.GetWord();
+         if (p2 && strcmp(p2, "inflight") == 0)
+         {
+            if (XrdOuca2x::a2i(m_log, "Error getting prefetch requests in flight", config.GetWord(), &m_configuration.m_prefetch_inflight, 1, 4096))
+            {
+               return false;
+            }
+         }
       }
       else
       {
@@ -440,6 +491,18 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
    {
       tmpc.m_flushRaw = config.GetWord();
    }
+   else if ( part == "writequeue" )
+   {
+      if (XrdOuca2x::a2i(m_log, "Error getting number of writer threads", config.GetWord(), &m_configuration.m_wqueue_thrds, 1, 64))
+      {
+         return false;
+      }
+      const char *p = config.GetWord();
+      if (p && XrdOuca2x::a2i(m_log, "Error getting maximum blocks per write", p, &m_configuration.m_wqueue_blocks, 1, 1024))
+      {
+         return false;
+      }
+   }
    else
    {
       m_log.Emsg("Cache::ConfigParameters() unmatched pfc parameter", part.c_str());
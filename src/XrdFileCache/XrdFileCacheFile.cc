@@ -24,6 +24,7 @@
 #include <sstream>
 #include <fcntl.h>
 #include <assert.h>
+#include <algorithm>
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdCl/XrdClFile.hh"
@@ -33,6 +34,7 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
 #include "XrdFileCache.hh"
+#include "XrdFileCacheInfoIndex.hh"
 
 
 using namespace XrdFileCache;
@@ -41,6 +43,12 @@ namespace
 {
 const int PREFETCH_MAX_ATTEMPTS = 10;
 
+// Prefetch score: number of prefetched blocks to judge it on, history length
+// and the score above which whole file prefetch continues without a pattern.
+const int   s_prefetchMinSamples  = 16;
+const int   s_prefetchScoreWindow = 256;
+const float s_prefetchFillScore   = 0.5f;
+
 
 
 Cache* cache() { return &Cache::GetInstance(); }
@@ -56,10 +64,12 @@ File::File(IO *io, const std::string& path, long long iOffset, long long iFileSi
    m_io(io),
    m_output(0),
    m_infoFile(0),
+   m_infoIndex(0),
    m_cfi(Cache::GetInstance().GetTrace(), Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks > 0),
    m_filename(path),
    m_offset(iOffset),
    m_fileSize(iFileSize),
+   m_writeQ(-1),
    m_non_flushed_cnt(0),
    m_in_sync(false),
    m_downloadCond(0),
@@ -67,6 +77,8 @@ File::File(IO *io, const std::string& path, long long iOffset, long long iFileSi
    m_prefetchReadCnt(0),
    m_prefetchHitCnt(0),
    m_prefetchScore(1),
+   m_prefetchDemand(0),
+   m_prefetchDemandTime(0),
    m_detachTimeIsLogged(false)
 {
    Open();
@@ -246,44 +258,53 @@ bool File::Open()
       return false;
    }
 
-   // Create the info file
-   std::string ifn = m_filename + Info::m_infoExtension;
-
-   struct stat infoStat;
-   bool fileExisted = (myOss.Stat(ifn.c_str(), &infoStat) == XrdOssOK);
+   // Blocks are written by the writer threads of the data file's device
+   struct stat dataStat;
+   m_writeQ = cache()->GetWriteQueue(m_output->Fstat(&dataStat) == XrdOssOK ? dataStat.st_dev : 0);
 
-   myEnv.Put("oss.asize", "64k"); // TODO: Calculate? Get it from configuration? Do not know length of access lists ...
-   myEnv.Put("oss.cgroup", Cache::GetInstance().RefConfiguration().m_meta_space.c_str());
-   if (myOss.Create(myUser, ifn.c_str(), 0600, myEnv, XRDOSS_mkpath) != XrdOssOK)
+   // The state of the file is kept in the info index if it is enabled,
+   // otherwise in a cinfo file next to the data file.
+   if ( ! open_info_index())
    {
-      TRACEF(Error, "File::Open() Create failed for info file " << ifn
-                                                                << ", err=" << strerror(errno));
-      delete m_output; m_output = 0;
-      return false;
-   }
+      // Create the info file
+      std::string ifn = m_filename + Info::m_infoExtension;
 
-   m_infoFile = myOss.newFile(myUser);
-   if (m_infoFile->Open(ifn.c_str(), O_RDWR, 0600, myEnv) != XrdOssOK)
-   {
-      TRACEF(Error, "File::Open() Open failed for info file " << ifn << ", err=" << strerror(errno));
+      struct stat infoStat;
+      bool fileExisted = (myOss.Stat(ifn.c_str(), &infoStat) == XrdOssOK);
 
-      delete m_infoFile; m_infoFile = 0;
-      delete m_output;   m_output   = 0;
-      return false;
-   }
+      myEnv.Put("oss.asize", "64k"); // TODO: Calculate? Get it from configuration? Do not know length of access lists ...
+      myEnv.Put("oss.cgroup", Cache::GetInstance().RefConfiguration().m_meta_space.c_str());
+      if (myOss.Create(myUser, ifn.c_str(), 0600, myEnv, XRDOSS_mkpath) != XrdOssOK)
+      {
+         TRACEF(Error, "File::Open() Create failed for info file " << ifn
+                                                                   << ", err=" << strerror(errno));
+         delete m_output; m_output = 0;
+         return false;
+      }
 
-   if (fileExisted && m_cfi.Read(m_infoFile, ifn))
-   {
-      TRACEF(Debug, "Read existing info file.");
-   }
-   else
-   {
-      m_cfi.SetBufferSize(Cache::GetInstance().RefConfiguration().m_bufferSize);
-      m_cfi.SetFileSize(m_fileSize);
-      m_cfi.Write(m_infoFile);
-      m_infoFile->Fsync();
-      int ss = (m_fileSize - 1)/m_cfi.GetBufferSize() + 1;
-      TRACEF(Debug, "Creating new file info, data size = " <<  m_fileSize << " num blocks = "  << ss);
+      m_infoFile = myOss.newFile(myUser);
+      if (m_infoFile->Open(ifn.c_str(), O_RDWR, 0600, myEnv) != XrdOssOK)
+      {
+         TRACEF(Error, "File::Open() Open failed for info file " << ifn << ", err=" << strerror(errno));
+
+         delete m_infoFile; m_infoFile = 0;
+         delete m_output;   m_output   = 0;
+         return false;
+      }
+
+      if (fileExisted && m_cfi.Read(m_infoFile, ifn))
+      {
+         TRACEF(Debug, "Read existing info file.");
+      }
+      else
+      {
+         m_cfi.SetBufferSize(Cache::GetInstance().RefConfiguration().m_bufferSize);
+         m_cfi.SetFileSize(m_fileSize);
+         m_cfi.Write(m_infoFile);
+         m_infoFile->Fsync();
+         int ss = (m_fileSize - 1)/m_cfi.GetBufferSize() + 1;
+         TRACEF(Debug, "Creating new file info, data size = " <<  m_fileSize << " num blocks = "  << ss);
+      }
    }
 
    m_cfi.WriteIOStatAttach();
@@ -297,6 +318,40 @@ bool File::Open()
 }
 
 
+//------------------------------------------------------------------------------
+
+bool File::open_info_index()
+{
+   // Returns true if the info index holds the state of this file.
+
+   InfoIndex *index = cache()->GetInfoIndex();
+   if ( ! index) return false;
+
+   if (m_cfi.Read(*index, m_filename))
+   {
+      TRACEF(Debug, "Read existing info from index.");
+   }
+   else
+   {
+      // Files cached before the index was enabled keep their cinfo file.
+      std::string ifn = m_filename + Info::m_infoExtension;
+      struct stat infoStat;
+      if (Cache::GetInstance().GetOss()->Stat(ifn.c_str(), &infoStat) == XrdOssOK)
+         return false;
+
+      m_cfi.SetBufferSize(Cache::GetInstance().RefConfiguration().m_bufferSize);
+      m_cfi.SetFileSize(m_fileSize);
+      if ( ! m_cfi.Write(*index, m_filename))
+         return false;
+
+      TRACEF(Debug, "Creating new file info in index, data size = " <<  m_fileSize << " num blocks = "  << m_cfi.GetSizeInBits());
+   }
+
+   m_infoIndex = index;
+   return true;
+}
+
+
 //==============================================================================
 // Read and helpers
 //==============================================================================
@@ -474,6 +529,8 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
 
    m_downloadCond.Lock();
 
+   note_demand();
+
    const int idx_first = iUserOff / BS;
    const int idx_last  = (iUserOff + iUserSize - 1) / BS;
 
@@ -524,6 +581,9 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
       }
    }
 
+   m_accessModel.RegisterRead(idx_first, idx_last);
+   resume_prefetch();
+
    m_downloadCond.UnLock();
 
    if ( ! preProcOK)
@@ -577,7 +637,6 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
    }
 
    // Third, loop over blocks that are available or incoming
-   int prefetchHitsRam = 0;
    while ( ! blks_to_process.empty() && bytes_read >= 0)
    {
       BlockList_t finished;
@@ -624,8 +683,6 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
             memcpy(&iUserBuff[user_off], &((*bi)->m_buff[off_in_block]), size_to_copy);
             bytes_read += size_to_copy;
             loc_stats.m_BytesRam += size_to_copy;
-            if ((*bi)->m_prefetch)
-               prefetchHitsRam++;
          }
          else // it has failed ... krap up.
          {
@@ -675,20 +732,24 @@ int File::Read(char* iUserBuff, long long iUserOff, int iUserSize)
       // blks_to_process can be non-empty, if we're exiting with an error.
       std::copy(blks_to_process.begin(), blks_to_process.end(), std::back_inserter(blks_processed));
 
+      // update prefetch score, before blocks can get released
+      int prefetchHits = 0;
       for (BlockList_i bi = blks_processed.begin(); bi != blks_processed.end(); ++bi)
       {
-         TRACEF(Dump, "File::Read() dec_ref_count " << (void*)(*bi) << " idx = " << (int)((*bi)->m_offset/BufferSize()));
-         dec_ref_count(*bi);
+         if (take_prefetch_hit(*bi)) ++prefetchHits;
       }
-
-      // update prefetch score
-      m_prefetchHitCnt += prefetchHitsRam;
       for (IntList_i d = blks_on_disk.begin(); d !=  blks_on_disk.end(); ++d)
       {
-         if (m_cfi.TestPrefetchBit(offsetIdx(*d)))
-            m_prefetchHitCnt++;
+         if (take_prefetch_hit(*d)) ++prefetchHits;
+      }
+      add_prefetch_hits(prefetchHits);
+      loc_stats.m_BlocksPrefetchHit += prefetchHits;
+
+      for (BlockList_i bi = blks_processed.begin(); bi != blks_processed.end(); ++bi)
+      {
+         TRACEF(Dump, "File::Read() dec_ref_count " << (void*)(*bi) << " idx = " << (int)((*bi)->m_offset/BufferSize()));
+         dec_ref_count(*bi);
       }
-      m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
    }
 
    m_stats.AddStats(loc_stats);
@@ -729,6 +790,57 @@ void File::WriteBlockToDisk(Block* b)
 
    // set bit fetched
    TRACEF(Dump, "File::WriteToDisk() success set bit for block " <<  b->m_offset << " size " <<  size);
+   mark_block_written(b);
+}
+
+//------------------------------------------------------------------------------
+
+void File::WriteBlocksToDisk(std::list<Block*>& blks)
+{
+   if (blks.size() == 1)
+   {
+      WriteBlockToDisk(blks.front());
+      return;
+   }
+
+   // write all block buffers into the disk file with one vector write
+   std::vector<XrdOucIOVec> iov(blks.size());
+   long long total = 0;
+   int       n     = 0;
+   for (BlockList_i i = blks.begin(); i != blks.end(); ++i, ++n)
+   {
+      long long offset = (*i)->m_offset - m_offset;
+      long long size   = (offset + m_cfi.GetBufferSize()) > m_fileSize ? (m_fileSize - offset) : m_cfi.GetBufferSize();
+      iov[n].offset = offset;
+      iov[n].size   = size;
+      iov[n].info   = 0;
+      iov[n].data   = (*i)->get_buff();
+      total += size;
+   }
+
+   ssize_t retval = m_output->WriteV(&iov[0], n);
+   if (retval != total)
+   {
+      TRACEF(Warning, "File::WriteBlocksToDisk() vector write of " << n << " blocks from offset " << blks.front()->m_offset
+             << " returned " << retval << ", writing blocks one at a time");
+      for (BlockList_i i = blks.begin(); i != blks.end(); ++i)
+      {
+         WriteBlockToDisk(*i);
+      }
+      return;
+   }
+
+   TRACEF(Dump, "File::WriteBlocksToDisk() wrote " << n << " blocks from offset " << blks.front()->m_offset << " size " << total);
+   for (BlockList_i i = blks.begin(); i != blks.end(); ++i)
+   {
+      mark_block_written(*i);
+   }
+}
+
+//------------------------------------------------------------------------------
+
+void File::mark_block_written(Block* b)
+{
    int pfIdx =  (b->m_offset - m_offset)/m_cfi.GetBufferSize();
 
    bool schedule_sync = false;
@@ -775,8 +887,15 @@ void File::Sync()
    TRACEF(Dump, "File::Sync()");
    m_output->Fsync();
 
-   m_cfi.Write(m_infoFile);
-   m_infoFile->Fsync();
+   if (m_infoIndex)
+   {
+      m_cfi.Write(*m_infoIndex, m_filename);
+   }
+   else
+   {
+      m_cfi.Write(m_infoFile);
+      m_infoFile->Fsync();
+   }
 
    int written_while_in_sync;
    {
@@ -843,6 +962,8 @@ void File::free_block(Block* b)
 
 void File::ProcessBlockResponse(Block* b, int res)
 {
+   bool prefetch = b->m_prefetch;
+
    m_downloadCond.Lock();
 
    TRACEF(Dump, "File::ProcessBlockResponse " << (void*)b << "  " << b->m_offset/BufferSize());
@@ -865,6 +986,8 @@ void File::ProcessBlockResponse(Block* b, int res)
    m_downloadCond.Broadcast();
 
    m_downloadCond.UnLock();
+
+   if (prefetch) cache()->PrefetchBlockDone();
 }
 
 long long File::BufferSize()
@@ -889,54 +1012,160 @@ int File::offsetIdx(int iIdx)
 
 //------------------------------------------------------------------------------
 
-void File::Prefetch()
+bool File::Prefetch()
 {
    // Check that block is not on disk and not in RAM.
    // TODO: Could prefetch several blocks at once!
 
    BlockList_t blks;
+   Stats       loc_stats;
 
    TRACEF(Dump, "File::Prefetch enter to check download status");
    {
       XrdSysCondVarHelper _lck(m_downloadCond);
 
       if (m_prefetchState != kOn)
-         return;
+         return false;
 
-      for (int f = 0; f < m_cfi.GetSizeInBits(); ++f)
+      int  f        = -1;
+      bool complete = false;
+
+      std::vector<int> candidates;
+      if (m_cfi.IsComplete())
+      {
+         // Every block is on disk, there is nothing left to prefetch.
+         complete = true;
+      }
+      else if (m_accessModel.Predict(candidates, Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks))
+      {
+         // Follow the clients.
+         f = next_prefetch_block(candidates, prefetch_depth());
+      }
+      else if (m_prefetchReadCnt < s_prefetchMinSamples || m_prefetchScore >= s_prefetchFillScore)
       {
-         if ( ! m_cfi.TestBit(f))
+         // No usable pattern: fill the file from the start for as long as
+         // the prefetched blocks are getting read.
+         complete = true;
+         for (int i = 0; i < m_cfi.GetSizeInBits(); ++i)
          {
-            f += m_offset/m_cfi.GetBufferSize();
-            BlockMap_i bi = m_block_map.find(f);
-            if (bi == m_block_map.end())
+            if ( ! m_cfi.TestBit(i))
             {
-               TRACEF(Dump, "File::Prefetch take block " << f);
-               cache()->RequestRAMBlock();
-               blks.push_back( PrepareBlockRequest(f, true) );
-               m_prefetchReadCnt++;
-               m_prefetchScore = float(m_prefetchHitCnt)/m_prefetchReadCnt;
-               break;
+               int bi = i + m_offset/m_cfi.GetBufferSize();
+               if (m_block_map.find(bi) == m_block_map.end())
+               {
+                  f = bi;
+                  break;
+               }
+               complete = false;
             }
          }
       }
-   }
 
+      if (f >= 0)
+      {
+         TRACEF(Dump, "File::Prefetch take block " << f);
+         cache()->RequestRAMBlock();
+         blks.push_back( PrepareBlockRequest(f, true) );
+         m_prefetchReadCnt++;
+         add_prefetch_hits(0);
+         loc_stats.m_BlocksPrefetched++;
+      }
+      else if (complete)
+      {
+         TRACEF(Dump, "File::Prefetch no free block found ");
+         m_prefetchState = kComplete;
+      }
+      else
+      {
+         TRACEF(Dump, "File::Prefetch going idle, access pattern " << AccessModel::PatternName(m_accessModel.GetPattern())
+                       << ", prefetch score " << m_prefetchScore);
+         m_prefetchState = kIdle;
+      }
+   }
 
    if ( ! blks.empty())
    {
+      m_stats.AddStats(loc_stats);
       ProcessBlockRequests(blks);
+      return true;
    }
    else
    {
-      TRACEF(Dump, "File::Prefetch no free block found ");
-      m_downloadCond.Lock();
-      m_prefetchState = kComplete;
-      m_downloadCond.UnLock();
       cache()->DeRegisterPrefetchFile(this);
+      return false;
+   }
+}
+
+int File::prefetch_depth() const
+{
+   // Must be called w/ m_downloadCond locked.
+   // Look ahead less when prefetched blocks are not getting read, but always
+   // keep probing one block so that the score can recover.
+   const int max_depth = Cache::GetInstance().RefConfiguration().m_prefetch_max_blocks;
+   if (m_prefetchReadCnt < s_prefetchMinSamples) return max_depth;
+   return std::max(1, int(max_depth * m_prefetchScore + 0.5f));
+}
+
+int File::next_prefetch_block(const std::vector<int>& candidates, int depth)
+{
+   // Must be called w/ m_downloadCond locked.
+   // Returns the first of the first depth candidates that is neither cached nor requested.
+   const int first_idx = m_offset/m_cfi.GetBufferSize();
+   const int last_idx  = first_idx + m_cfi.GetSizeInBits() - 1;
+
+   for (int i = 0; i < (int) candidates.size() && i < depth; ++i)
+   {
+      const int f = candidates[i];
+      if (f < first_idx || f > last_idx) break;
+      if ( ! m_cfi.TestBit(offsetIdx(f)) && m_block_map.find(f) == m_block_map.end())
+         return f;
    }
+   return -1;
 }
 
+void File::resume_prefetch()
+{
+   // Must be called w/ m_downloadCond locked.
+   // Prefetching went idle waiting for more reads, let it look again.
+   if (m_prefetchState == kIdle)
+   {
+      m_prefetchState = kOn;
+      cache()->RegisterPrefetchFile(this);
+   }
+}
+
+bool File::take_prefetch_hit(Block* b)
+{
+   // Must be called w/ m_downloadCond locked.
+   // A prefetched block counts as a hit only the first time it is read.
+   if ( ! b->m_prefetch || ! b->is_finished() || ! b->is_ok()) return false;
+
+   b->m_prefetch = false;
+   m_cfi.ClearBitPrefetch(offsetIdx(b->m_offset/m_cfi.GetBufferSize()));
+   return true;
+}
+
+bool File::take_prefetch_hit(int idx)
+{
+   // Must be called w/ m_downloadCond locked.
+   if ( ! m_cfi.TestPrefetchBit(offsetIdx(idx))) return false;
+
+   m_cfi.ClearBitPrefetch(offsetIdx(idx));
+   return true;
+}
+
+void File::add_prefetch_hits(int n)
+{
+   // Must be called w/ m_downloadCond locked.
+   // Older history is aged out so that the score follows changes in access.
+   m_prefetchHitCnt += n;
+   if (m_prefetchReadCnt >= s_prefetchScoreWindow)
+   {
+      m_prefetchReadCnt /= 2;
+      m_prefetchHitCnt  /= 2;
+   }
+   m_prefetchScore = m_prefetchReadCnt ? std::min(1.0f, float(m_prefetchHitCnt)/m_prefetchReadCnt) : 1;
+}
 
 //------------------------------------------------------------------------------
 
@@ -945,6 +1174,26 @@ float File::GetPrefetchScore() const
    return m_prefetchScore;
 }
 
+int File::GetPrefetchDemand(time_t now) const
+{
+   // Read without lock, a stale value only skews the prefetch choice
+   int dt = now - m_prefetchDemandTime;
+   if (dt <= 0) return m_prefetchDemand;
+   return dt < 31 ? m_prefetchDemand >> dt : 0;
+}
+
+void File::note_demand()
+{
+   // Must be called w/ m_downloadCond locked.
+   time_t now = time(0);
+   if (now != m_prefetchDemandTime)
+   {
+      m_prefetchDemand     = GetPrefetchDemand(now);
+      m_prefetchDemandTime = now;
+   }
+   if (m_prefetchDemand < (1 << 20)) ++m_prefetchDemand;
+}
+
 XrdSysTrace* File::GetTrace()
 {
    return Cache::GetInstance().GetTrace();
@@ -26,9 +26,12 @@
 
 #include "XrdFileCacheInfo.hh"
 #include "XrdFileCacheStats.hh"
+#include "XrdFileCacheAccessModel.hh"
 
 #include <string>
+#include <list>
 #include <map>
+#include <vector>
 
 class XrdJob;
 class XrdOucIOVec;
@@ -43,6 +46,7 @@ namespace XrdFileCache
 class BlockResponseHandler;
 class DirectResponseHandler;
 class IO;
+class InfoIndex;
 
 struct ReadVBlockListRAM;
 struct ReadVChunkListRAM;
@@ -177,13 +181,36 @@ public:
    //----------------------------------------------------------------------
    Stats& GetStats() { return m_stats; }
 
+   //----------------------------------------------------------------------
+   //! Reference to download status and access statistics.
+   //----------------------------------------------------------------------
+   const Info& RefInfo() const { return m_cfi; }
+
    void ProcessBlockResponse(Block* b, int res);
    void WriteBlockToDisk(Block* b);
 
-   void Prefetch();
+   //----------------------------------------------------------------------
+   //! \brief Write blocks that follow each other in the file with a single
+   //! vector write. Called from the cache's write queue threads.
+   //----------------------------------------------------------------------
+   void WriteBlocksToDisk(std::list<Block*>& blks);
+
+   //! Index of the cache write queue for the data file, -1 if not open
+   int GetWriteQueue() const { return m_writeQ; }
+
+   //----------------------------------------------------------------------
+   //! \brief Request the next block that clients are expected to read.
+   //! Blocks are chosen from the access pattern of the file, the file goes
+   //! idle until the next client read if no block is worth prefetching.
+   //! @return true if a block request was issued.
+   //----------------------------------------------------------------------
+   bool Prefetch();
 
    float GetPrefetchScore() const;
 
+   //! Number of recent client requests, halved for every second passed
+   int GetPrefetchDemand(time_t now) const;
+
    //! Log path
    const char* lPath() const;
 
@@ -202,7 +229,7 @@ public:
    int dec_ref_cnt() { return --m_ref_cnt; }
 
 private:
-   enum PrefetchState_e { kOff=-1, kOn, kHold, kStopped, kComplete };
+   enum PrefetchState_e { kOff=-1, kOn, kHold, kStopped, kComplete, kIdle };
 
    int            m_ref_cnt;            //!< number of references from IO or sync
    
@@ -211,11 +238,13 @@ private:
    IO            *m_io;                 //!< original data source
    XrdOssDF      *m_output;             //!< file handle for data file on disk
    XrdOssDF      *m_infoFile;           //!< file handle for data-info file on disk
+   InfoIndex     *m_infoIndex;          //!< info index holding m_cfi, used instead of m_infoFile
    Info           m_cfi;                //!< download status of file blocks and access statistics
 
    std::string    m_filename;           //!< filename of data file on disk
    long long      m_offset;             //!< offset of cached file for block-based operation
    long long      m_fileSize;           //!< size of cached disk file for block-based operation
+   int            m_writeQ;             //!< cache write queue for the data file
 
    // fsync
    std::vector<int>  m_writes_during_sync;
@@ -241,12 +270,18 @@ private:
    PrefetchState_e m_prefetchState;
 
    int   m_prefetchReadCnt;
-   int   m_prefetchHitCnt;
+   int   m_prefetchHitCnt;             //!< prefetched blocks that were read, each counted once
    float m_prefetchScore;              //cached
+   AccessModel m_accessModel;          //!< client access pattern, drives block choice in Prefetch()
+   int    m_prefetchDemand;            //!< recent client requests, see GetPrefetchDemand()
+   time_t m_prefetchDemandTime;        //!< time m_prefetchDemand was last updated
    
    bool  m_detachTimeIsLogged;
 
    static const char *m_traceID;
+
+   bool open_info_index();
+
    bool overlap(int blk,               // block to query
                 long long blk_size,    //
                 long long req_off,     // offset of user request
@@ -281,6 +316,17 @@ private:
    long long BufferSize();
    void AppendIOStatToFileInfo();
 
+   void mark_block_written(Block*);
+
+   void note_demand();
+
+   void resume_prefetch();
+   bool take_prefetch_hit(Block*);
+   bool take_prefetch_hit(int idx);
+   void add_prefetch_hits(int n);
+   int  prefetch_depth() const;
+   int  next_prefetch_block(const std::vector<int>& candidates, int depth);
+
    void inc_ref_count(Block*);
    void dec_ref_count(Block*);
    void free_block(Block*);
@@ -84,7 +84,20 @@ int IOEntireFile::initCachedStat(const char* path)
    int res = -1;
    struct stat tmpStat;
 
-   if (m_cache.GetOss()->Stat(path, &tmpStat) == XrdOssOK)
+   InfoIndex *index = m_cache.GetInfoIndex();
+   if (index)
+   {
+      std::string dataPath(path, strlen(path) - strlen(Info::m_infoExtension));
+      Info info(m_cache.GetTrace());
+      if (info.Read(*index, dataPath) && m_cache.GetOss()->Stat(dataPath.c_str(), &tmpStat) == XrdOssOK)
+      {
+         tmpStat.st_size = info.GetFileSize();
+         TRACEIO(Info, "IOEntireFile::initCachedStat successfuly read size from info index = " << tmpStat.st_size);
+         res = 0;
+      }
+   }
+
+   if (res && m_cache.GetOss()->Stat(path, &tmpStat) == XrdOssOK)
    {
       XrdOssDF* infoFile = m_cache.GetOss()->newFile(Cache::GetInstance().RefConfiguration().m_username.c_str());
       XrdOucEnv myEnv;
@@ -21,7 +21,9 @@
 #include <time.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <sys/stat.h>
+#include <algorithm>
 
 #include "XrdOss/XrdOss.hh"
 #include "XrdCks/XrdCksCalcmd5.hh"
@@ -30,6 +32,7 @@
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdFileCacheInfo.hh"
+#include "XrdFileCacheInfoIndex.hh"
 #include "XrdFileCache.hh"
 #include "XrdFileCacheStats.hh"
 #include "XrdFileCacheTrace.hh"
@@ -99,7 +102,7 @@ using namespace XrdFileCache;
 
 const char*  Info::m_infoExtension  = ".cinfo";
 const char*  Info::m_traceID        = "Cinfo";
-const int    Info::m_defaultVersion = 2;
+const int    Info::m_defaultVersion = 3;
 const size_t Info::m_maxNumAccess   = 20;
 
 //------------------------------------------------------------------------------
@@ -228,7 +231,15 @@ bool Info::Read(XrdOssDF* fp, const std::string &fname)
    m_store.m_astats.resize(vs);
    for (std::vector<AStat>::iterator it = m_store.m_astats.begin(); it != m_store.m_astats.end(); ++it)
    {
-      if (r.Read(*it, sizeof(AStat))) return false;
+      if (abs(m_store.m_version) == 2)
+      {
+         // V2 access statistics have no prefetch counts
+         if (r.ReadRaw(&(*it), offsetof(AStat, BlocksPrefetched))) return false;
+      }
+      else
+      {
+         if (r.Read(*it)) return false;
+      }
    }
 
 
@@ -353,12 +364,71 @@ bool Info::Write(XrdOssDF* fp, const std::string &fname)
 
 //------------------------------------------------------------------------------
 
+bool Info::Read(InfoIndex &index, const std::string &fname)
+{
+   InfoIndex::Record r;
+   if ( ! index.Get(fname, r)) return false;
+
+   m_store.m_version    = r.m_version;
+   m_store.m_bufferSize = r.m_bufferSize;
+   SetFileSize(r.m_fileSize);
+   if (GetSizeInBits() != r.m_nBits)
+   {
+      TRACE(Error, "Info::Read() " << fname << " number of blocks in index does not match file size");
+      return false;
+   }
+
+   memcpy(m_store.m_buff_synced, r.m_bits, GetSizeInBytes());
+   memcpy(m_buff_written, m_store.m_buff_synced, GetSizeInBytes());
+   m_complete = ! IsAnythingEmptyInRng(0, m_sizeInBits);
+
+   m_store.m_creationTime = r.m_creationTime;
+   m_store.m_accessCnt    = r.m_accessCnt;
+   m_store.m_astats.assign(r.m_astats, r.m_astats + r.m_nAStats);
+
+   TRACE(Dump, "Info::Read() " << fname << " from index, complete " << m_complete << " access_cnt " << m_store.m_accessCnt);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool Info::Write(InfoIndex &index, const std::string &fname)
+{
+   if ( ! index.Fits(fname, m_sizeInBits)) return false;
+
+   InfoIndex::Record r = InfoIndex::Record();
+
+   m_store.m_version = m_defaultVersion;
+   r.m_version       = m_store.m_version;
+   r.m_nBits         = m_sizeInBits;
+   r.m_bufferSize    = m_store.m_bufferSize;
+   r.m_fileSize      = m_store.m_fileSize;
+   r.m_creationTime  = m_store.m_creationTime;
+   r.m_accessCnt     = m_store.m_accessCnt;
+   memcpy(r.m_bits, m_store.m_buff_synced, GetSizeInBytes());
+
+   size_t n = std::min(m_store.m_astats.size(), (size_t) InfoIndex::kMaxAStats);
+   std::copy(m_store.m_astats.end() - n, m_store.m_astats.end(), r.m_astats);
+   r.m_nAStats = n;
+
+   if ( ! index.Put(fname, r))
+   {
+      TRACE(Warning, "Info::Write() " << fname << " could not be stored in index");
+      return false;
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+
 void Info::WriteIOStatDetach(Stats& s)
 {
    m_store.m_astats.back().DetachTime  = time(0);
    m_store.m_astats.back().BytesDisk   = s.m_BytesDisk;
    m_store.m_astats.back().BytesRam    = s.m_BytesRam;
    m_store.m_astats.back().BytesMissed = s.m_BytesMissed;
+   m_store.m_astats.back().BlocksPrefetched  = s.m_BlocksPrefetched;
+   m_store.m_astats.back().BlocksPrefetchHit = s.m_BlocksPrefetchHit;
 }
 
 void Info::WriteIOStatAttach()
@@ -376,9 +446,9 @@ void Info::WriteIOStatAttach()
 
 bool Info::GetLatestDetachTime(time_t& t) const
 {
-   if (! m_store.m_accessCnt) return false;
+   if (m_store.m_astats.empty()) return false;
 
-   size_t entry = std::min(m_store.m_accessCnt, m_maxNumAccess) - 1;
-   t =  m_store.m_astats[entry].DetachTime;
+   // cinfo files keep up to m_maxNumAccess statistics, the info index less
+   t = m_store.m_astats.back().DetachTime;
    return true;
 }
@@ -40,6 +40,7 @@ class Log;
 namespace XrdFileCache
 {
 class Stats;
+class InfoIndex;
 
 //----------------------------------------------------------------------------
 //! Status of cached file. Can be read from and written into a binary file.
@@ -55,8 +56,11 @@ public:
       long long BytesDisk;        //! read from disk
       long long BytesRam;         //! read from ram
       long long BytesMissed;      //! read remote client
+      int       BlocksPrefetched; //! blocks requested by prefetch
+      int       BlocksPrefetchHit;//! prefetched blocks read by clients
 
-      AStat() : AttachTime(0), DetachTime(0), BytesDisk(0), BytesRam(0), BytesMissed(0) {}
+      AStat() : AttachTime(0), DetachTime(0), BytesDisk(0), BytesRam(0), BytesMissed(0),
+                BlocksPrefetched(0), BlocksPrefetchHit(0) {}
    };
 
    struct Store {
@@ -103,6 +107,12 @@ public:
    //---------------------------------------------------------------------
    void SetBitPrefetch(int i);
 
+   //! \brief Forget that block was prefetched, e.g. once it has been read
+   //!
+   //! @param i block index
+   //---------------------------------------------------------------------
+   void ClearBitPrefetch(int i);
+
    void SetBufferSize(long long);
    
    void SetFileSize(long long);
@@ -130,6 +140,21 @@ public:
    //---------------------------------------------------------------------
    bool Write(XrdOssDF* fp, const std::string &fname = "<unknown>");
 
+   //---------------------------------------------------------------------
+   //! \brief Load content of file fname from the info index
+   //!
+   //! @return false if the file is not in the index
+   //---------------------------------------------------------------------
+   bool Read(InfoIndex &index, const std::string &fname);
+
+   //---------------------------------------------------------------------
+   //! \brief Store content of file fname in the info index. Only the
+   //! latest InfoIndex::kMaxAStats access statistics are kept.
+   //!
+   //! @return false if the file does not fit in the index
+   //---------------------------------------------------------------------
+   bool Write(InfoIndex &index, const std::string &fname);
+
    //---------------------------------------------------------------------
    //! Disable allocating, writing, and reading of downlaod status
    //---------------------------------------------------------------------
@@ -356,6 +381,18 @@ inline void Info::SetBitPrefetch(int i)
 }
 
 
+inline void Info::ClearBitPrefetch(int i)
+{
+   if (!m_buff_prefetch) return;
+
+   const int cn = i/8;
+   assert(cn < GetSizeInBytes());
+
+   const int off = i - cn*8;
+   m_buff_prefetch[cn] &= ~cfiBIT(off);
+}
+
+
 inline long long Info::GetBufferSize() const
 {
    return m_store.m_bufferSize;
@@ -0,0 +1,431 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucSxeq.hh"
+#include "XrdCks/XrdCksCalccrc32.hh"
+#include "XrdSys/XrdSysTrace.hh"
+#include "XrdFileCacheInfoIndex.hh"
+#include "XrdFileCacheTrace.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+// The header page is followed by the slots, each slot holds two records.
+const size_t s_headerSize = 4096;
+const size_t s_slotSize   = 4096;
+const size_t s_recordSize = s_slotSize / 2;
+const int    s_version    = 1;
+const char   s_magic[8]   = { 'X', 'R', 'D', 'P', 'F', 'C', 'I', 'I' };
+
+// Slots searched for a file before giving up
+const int    s_maxProbe   = 32;
+
+struct Header
+{
+   char m_magic[8];
+   int  m_version;
+   int  m_nSlots;
+   int  m_slotSize;
+   int  m_recordSize;
+   int  m_recordBytes;
+   int  m_maxPath;
+   int  m_maxAStats;
+   int  m_maxBlocks;
+};
+
+static_assert(sizeof(InfoIndex::Record) <= s_recordSize, "InfoIndex::Record does not fit in a slot");
+}
+
+const char *InfoIndex::m_indexName = "/.xrdpfc_info_index";
+const char *InfoIndex::m_traceID   = "InfoIndex";
+
+//______________________________________________________________________________
+
+InfoIndex::InfoIndex(XrdSysTrace* trace) :
+   m_trace(trace),
+   m_fp(0),
+   m_map(0),
+   m_mapSize(0),
+   m_nSlots(0)
+{}
+
+InfoIndex::~InfoIndex()
+{
+   close();
+}
+
+//______________________________________________________________________________
+
+void InfoIndex::close()
+{
+   if (m_map)
+   {
+      munmap(m_map, m_mapSize);
+      m_map = 0;
+   }
+   if (m_fp)
+   {
+      m_fp->Close();
+      delete m_fp;
+      m_fp = 0;
+   }
+   m_nSlots = 0;
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::Open(XrdOss *oss, const std::string &user, const std::string &space,
+                     const char *path, int nSlots, bool readOnly)
+{
+   XrdOucEnv   env;
+   struct stat st;
+   int         fd = -1;
+
+   env.Put("oss.cgroup", space.c_str());
+
+   if ( ! readOnly && oss->Stat(path, &st) != XrdOssOK &&
+        oss->Create(user.c_str(), path, 0600, env, XRDOSS_mkpath) != XrdOssOK)
+   {
+      TRACE(Error, "InfoIndex::Open() can't create " << path << " err " << strerror(errno));
+      return false;
+   }
+
+   m_fp = oss->newFile(user.c_str());
+   if (m_fp->Open(path, readOnly ? O_RDONLY : O_RDWR, 0600, env) != XrdOssOK ||
+       m_fp->Fstat(&st) != XrdOssOK || (fd = m_fp->getFD()) < 0)
+   {
+      TRACE(Error, "InfoIndex::Open() can't open " << path << ", the index must be on a local file system");
+      close();
+      return false;
+   }
+
+   if ( ! readOnly && XrdOucSxeq::Serialize(fd, XrdOucSxeq::noWait))
+   {
+      TRACE(Error, "InfoIndex::Open() " << path << " is used by another process");
+      close();
+      return false;
+   }
+
+   // A new or never initialized index gets the requested number of slots.
+   bool init = false;
+   if ( ! readOnly)
+   {
+      Header h;
+      if (st.st_size < (off_t) s_headerSize || m_fp->Read(&h, 0, sizeof(Header)) != (ssize_t) sizeof(Header) ||
+          h.m_magic[0] == 0)
+      {
+         st.st_size = s_headerSize + (off_t) nSlots * s_slotSize;
+         if (m_fp->Ftruncate(st.st_size) != XrdOssOK)
+         {
+            TRACE(Error, "InfoIndex::Open() can't resize " << path);
+            close();
+            return false;
+         }
+         init = true;
+      }
+   }
+
+   if (st.st_size < (off_t) s_headerSize)
+   {
+      TRACE(Error, "InfoIndex::Open() " << path << " is not an index");
+      close();
+      return false;
+   }
+
+   m_mapSize = st.st_size;
+   void *map = mmap(0, m_mapSize, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (map == MAP_FAILED)
+   {
+      TRACE(Error, "InfoIndex::Open() can't map " << path << " err " << strerror(errno));
+      close();
+      return false;
+   }
+   m_map = (char*) map;
+
+   Header &h = *reinterpret_cast<Header*>(m_map);
+   if (init)
+   {
+      // Slots are zero, which marks them free, the header is written last.
+      h.m_version     = s_version;
+      h.m_nSlots      = nSlots;
+      h.m_slotSize    = s_slotSize;
+      h.m_recordSize  = s_recordSize;
+      h.m_recordBytes = sizeof(Record);
+      h.m_maxPath     = kMaxPath;
+      h.m_maxAStats   = kMaxAStats;
+      h.m_maxBlocks   = kMaxBlocks;
+      memcpy(h.m_magic, s_magic, sizeof(s_magic));
+      msync(m_map, s_headerSize, MS_SYNC);
+      TRACE(Info, "InfoIndex::Open() created " << path << " with " << nSlots << " slots");
+   }
+
+   if (memcmp(h.m_magic, s_magic, sizeof(s_magic)) || h.m_version != s_version ||
+       h.m_slotSize != (int) s_slotSize || h.m_recordSize != (int) s_recordSize ||
+       h.m_recordBytes != (int) sizeof(Record) || h.m_maxPath != kMaxPath ||
+       h.m_maxAStats != kMaxAStats || h.m_maxBlocks != kMaxBlocks ||
+       h.m_nSlots <= 0 || s_headerSize + (size_t) h.m_nSlots * s_slotSize > m_mapSize)
+   {
+      TRACE(Error, "InfoIndex::Open() " << path << " has an incompatible layout");
+      close();
+      return false;
+   }
+
+   m_nSlots = h.m_nSlots;
+   if ( ! init && ! readOnly && m_nSlots != nSlots)
+   {
+      TRACE(Warning, "InfoIndex::Open() " << path << " keeps its " << m_nSlots << " slots");
+   }
+
+   TRACE(Debug, "InfoIndex::Open() " << path << " mapped, " << m_nSlots << " slots");
+   return true;
+}
+
+//______________________________________________________________________________
+
+unsigned long long InfoIndex::hash(const std::string &path)
+{
+   // FNV-1a
+   unsigned long long h = 14695981039346656037ull;
+   for (std::string::const_iterator i = path.begin(); i != path.end(); ++i)
+   {
+      h ^= (unsigned char) *i;
+      h *= 1099511628211ull;
+   }
+   return h;
+}
+
+//______________________________________________________________________________
+
+unsigned int InfoIndex::crc(const Record &r)
+{
+   // Only the used parts of path, access statistics and bits are covered.
+   XrdCksCalccrc32 calc;
+   const char *beg = reinterpret_cast<const char*>(&r.m_state);
+   calc.Update(beg, offsetof(Record, m_path) - offsetof(Record, m_state));
+   calc.Update(r.m_path, r.m_pathLen);
+   calc.Update(reinterpret_cast<const char*>(r.m_astats), r.m_nAStats * sizeof(Info::AStat));
+   calc.Update(reinterpret_cast<const char*>(r.m_bits), (r.m_nBits + 7) / 8);
+
+   unsigned int res;
+   memcpy(&res, calc.Final(), sizeof(res));
+   return res;
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::valid(const Record &r)
+{
+   if (r.m_state != kUsed && r.m_state != kRemoved) return false;
+
+   if (r.m_pathLen < 0 || r.m_pathLen > kMaxPath || r.m_nAStats < 0 || r.m_nAStats > kMaxAStats ||
+       r.m_nBits < 0 || r.m_nBits > kMaxBlocks)
+      return false;
+
+   return crc(r) == r.m_crc;
+}
+
+//______________________________________________________________________________
+
+const InfoIndex::Record* InfoIndex::current(int slot) const
+{
+   const char   *s    = m_map + s_headerSize + (size_t) slot * s_slotSize;
+   const Record *best = 0;
+   for (int c = 0; c < 2; ++c)
+   {
+      const Record *r = reinterpret_cast<const Record*>(s + c * s_recordSize);
+      if (valid(*r) && ( ! best || r->m_gen > best->m_gen)) best = r;
+   }
+   return best;
+}
+
+//______________________________________________________________________________
+
+int InfoIndex::find(const std::string &path, unsigned long long h) const
+{
+   int slot = h % m_nSlots;
+   for (int i = 0; i < s_maxProbe && i < m_nSlots; ++i, slot = (slot + 1) % m_nSlots)
+   {
+      const Record *r = current(slot);
+
+      // a slot that has never been used ends the search
+      if ( ! r) break;
+
+      if (r->m_state == kUsed && r->m_hash == h && r->m_pathLen == (int) path.size() &&
+          ! memcmp(r->m_path, path.data(), path.size()))
+         return slot;
+   }
+   return -1;
+}
+
+//______________________________________________________________________________
+
+void InfoIndex::write(int slot, Record &r)
+{
+   // Overwrite the older copy, the newer one stays valid until this is done.
+   char         *s   = m_map + s_headerSize + (size_t) slot * s_slotSize;
+   const Record *cur = current(slot);
+   int           c   = (cur == reinterpret_cast<Record*>(s)) ? 1 : 0;
+
+   r.m_gen = cur ? cur->m_gen + 1 : 1;
+   r.m_crc = crc(r);
+   memcpy(s + c * s_recordSize, &r, sizeof(Record));
+}
+
+//______________________________________________________________________________
+
+void InfoIndex::flush(int slot)
+{
+   static const size_t pageSize = sysconf(_SC_PAGESIZE);
+
+   size_t off = s_headerSize + (size_t) slot * s_slotSize;
+   size_t beg = off - off % pageSize;
+   if (msync(m_map + beg, off + s_slotSize - beg, MS_SYNC))
+   {
+      TRACE(Error, "InfoIndex::flush() msync failed for slot " << slot << " err " << strerror(errno));
+   }
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::Fits(const std::string &path, int nBlocks) const
+{
+   return m_map && path.size() <= (size_t) kMaxPath && nBlocks <= kMaxBlocks;
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::Get(const std::string &path, Record &r) const
+{
+   if ( ! m_map) return false;
+
+   unsigned long long h = hash(path);
+
+   XrdSysMutexHelper lock(&m_mutex);
+   int slot = find(path, h);
+   if (slot < 0) return false;
+
+   memcpy(&r, current(slot), sizeof(Record));
+   return true;
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::Has(const std::string &path) const
+{
+   if ( ! m_map) return false;
+
+   unsigned long long h = hash(path);
+
+   XrdSysMutexHelper lock(&m_mutex);
+   return find(path, h) >= 0;
+}
+
+//______________________________________________________________________________
+
+bool InfoIndex::Put(const std::string &path, Record &r)
+{
+   if ( ! Fits(path, r.m_nBits) || r.m_nAStats < 0 || r.m_nAStats > kMaxAStats) return false;
+
+   unsigned long long h = hash(path);
+   int                slot;
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+
+      slot = find(path, h);
+      if (slot < 0)
+      {
+         // take the first unused or removed slot
+         int s = h % m_nSlots;
+         for (int i = 0; i < s_maxProbe && i < m_nSlots; ++i, s = (s + 1) % m_nSlots)
+         {
+            const Record *cur = current(s);
+            if ( ! cur || cur->m_state == kRemoved)
+            {
+               slot = s;
+               break;
+            }
+         }
+      }
+      if (slot < 0)
+      {
+         TRACE(Warning, "InfoIndex::Put() no free slot for " << path);
+         return false;
+      }
+
+      r.m_state   = kUsed;
+      r.m_hash    = h;
+      r.m_pathLen = path.size();
+      memcpy(r.m_path, path.data(), path.size());
+      write(slot, r);
+   }
+
+   // Updates of a file are serialized by its File object, so the slot can
+   // be flushed without holding the lock.
+   flush(slot);
+   return true;
+}
+
+//______________________________________________________________________________
+
+void InfoIndex::Remove(const std::string &path)
+{
+   if ( ! m_map) return;
+
+   unsigned long long h = hash(path);
+   int                slot;
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+
+      slot = find(path, h);
+      if (slot < 0) return;
+
+      // keep the hash so that the slot still continues the search
+      Record r = Record();
+      r.m_state = kRemoved;
+      r.m_hash  = h;
+      write(slot, r);
+   }
+   flush(slot);
+}
+
+//______________________________________________________________________________
+
+void InfoIndex::GetPaths(std::vector<std::string> &paths) const
+{
+   paths.clear();
+   if ( ! m_map) return;
+
+   XrdSysMutexHelper lock(&m_mutex);
+   for (int slot = 0; slot < m_nSlots; ++slot)
+   {
+      const Record *r = current(slot);
+      if (r && r->m_state == kUsed)
+         paths.push_back(std::string(r->m_path, r->m_pathLen));
+   }
+}
@@ -0,0 +1,159 @@
+#ifndef __XRDFILECACHE_INFOINDEX_HH__
+#define __XRDFILECACHE_INFOINDEX_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdFileCacheInfo.hh"
+
+class XrdOss;
+class XrdOssDF;
+class XrdSysTrace;
+
+namespace XrdFileCache
+{
+//----------------------------------------------------------------------------
+//! Shared, memory mapped store of the download status and access statistics
+//! of cached files, used instead of per file cinfo files.
+//!
+//! The index file starts with a header page followed by fixed size slots.
+//! A file is placed in the first free slot after the one selected by the hash
+//! of its path. Each slot holds two copies of the file record, an update
+//! overwrites the older copy and is flushed to disk before returning. The
+//! copy with the highest generation and a valid CRC is used, so a crash in
+//! the middle of an update leaves the previous state of the file.
+//----------------------------------------------------------------------------
+class InfoIndex
+{
+public:
+   enum { kMaxPath = 512, kMaxAStats = 8, kMaxBlocks = 8192 };
+
+   //! State of a file as stored in a slot
+   struct Record
+   {
+      unsigned int       m_crc;           //!< CRC of the used part of the record
+      int                m_state;         //!< free, used or removed
+      unsigned long long m_hash;          //!< hash of the path
+      unsigned long long m_gen;           //!< generation, the newer copy is valid
+      int                m_version;       //!< info version
+      int                m_nBits;         //!< number of blocks
+      long long          m_bufferSize;    //!< block size
+      long long          m_fileSize;      //!< file size
+      long long          m_creationTime;  //!< time the file was first cached
+      long long          m_accessCnt;     //!< number of accesses
+      int                m_nAStats;       //!< number of stored access statistics
+      int                m_pathLen;       //!< length of m_path
+      char               m_path[kMaxPath];
+      Info::AStat        m_astats[kMaxAStats];
+      unsigned char      m_bits[kMaxBlocks / 8];
+   };
+
+   InfoIndex(XrdSysTrace* trace);
+
+   ~InfoIndex();
+
+   //---------------------------------------------------------------------
+   //! \brief Open or create the index file and map it into memory.
+   //!
+   //! @param oss      file system of the cache, must give access to the
+   //!                 file descriptor of the index file
+   //! @param user     oss user
+   //! @param space    oss space of the index file
+   //! @param path     index file path
+   //! @param nSlots   number of slots of a new index
+   //! @param readOnly map for reading only, as done by xrdpfc_print
+   //!
+   //! @return true on success
+   //---------------------------------------------------------------------
+   bool Open(XrdOss *oss, const std::string &user, const std::string &space,
+             const char *path, int nSlots, bool readOnly = false);
+
+   //---------------------------------------------------------------------
+   //! Check if a file with given path and number of blocks can be stored.
+   //---------------------------------------------------------------------
+   bool Fits(const std::string &path, int nBlocks) const;
+
+   //---------------------------------------------------------------------
+   //! \brief Get the record of a file.
+   //! @return false if the file is not in the index
+   //---------------------------------------------------------------------
+   bool Get(const std::string &path, Record &r) const;
+
+   //---------------------------------------------------------------------
+   //! \brief Store the record of a file and flush it to disk.
+   //!
+   //! Only the data members of r starting at m_version need to be set.
+   //! @return false if the file does not fit or there is no free slot
+   //---------------------------------------------------------------------
+   bool Put(const std::string &path, Record &r);
+
+   //---------------------------------------------------------------------
+   //! Remove a file from the index.
+   //---------------------------------------------------------------------
+   void Remove(const std::string &path);
+
+   //---------------------------------------------------------------------
+   //! Check if a file is in the index.
+   //---------------------------------------------------------------------
+   bool Has(const std::string &path) const;
+
+   //---------------------------------------------------------------------
+   //! Get paths of all files in the index.
+   //---------------------------------------------------------------------
+   void GetPaths(std::vector<std::string> &paths) const;
+
+   int GetNSlots() const { return m_nSlots; }
+
+   XrdSysTrace* GetTrace() const { return m_trace; }
+
+   static const char *m_indexName;  //!< index path in the cache
+
+private:
+   enum State_e { kFree = 0, kUsed, kRemoved };
+
+   static unsigned long long hash(const std::string &path);
+
+   static unsigned int crc(const Record &r);
+
+   static bool valid(const Record &r);
+
+   const Record* current(int slot) const;
+
+   int  find(const std::string &path, unsigned long long h) const;
+
+   void write(int slot, Record &r);
+
+   void flush(int slot);
+
+   void close();
+
+   static const char  *m_traceID;
+
+   XrdSysTrace        *m_trace;
+   mutable XrdSysMutex m_mutex;
+   XrdOssDF           *m_fp;        //!< index file
+   char               *m_map;       //!< mapped index file
+   size_t              m_mapSize;
+   int                 m_nSlots;
+};
+}
+
+#endif
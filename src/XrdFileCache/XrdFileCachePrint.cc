@@ -27,13 +27,18 @@
 #include "XrdOfs/XrdOfsConfigPI.hh"
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdFileCacheInfo.hh"
+#include "XrdFileCacheInfoIndex.hh"
 #include "XrdOss/XrdOss.hh"
 
 using namespace XrdFileCache;
 
 Print::Print(XrdOss* oss, bool v, const char* path) : m_oss(oss), m_verbose(v), m_ossUser("nobody")
 {
-   if (isInfoFile(path))
+   if (isIndexFile(path))
+   {
+      printIndex(std::string(path));
+   }
+   else if (isInfoFile(path))
    {
       printFile(std::string(path));
    }
@@ -49,6 +54,13 @@ Print::Print(XrdOss* oss, bool v, const char* path) : m_oss(oss), m_verbose(v),
 }
 
 
+bool Print::isIndexFile(const char* path) {
+   const char *name = InfoIndex::m_indexName + 1;
+   size_t      len  = strlen(path);
+   return len >= strlen(name) && ! strcmp(&path[len - strlen(name)], name);
+}
+
+
 bool Print::isInfoFile(const char* path) {
    if (strncmp(&path[strlen(path)-6], ".cinfo", 6)) {
       printf("%s is not cinfo file.\n\n", path);
@@ -72,6 +84,39 @@ void Print::printFile(const std::string& path)
       return;
    }
 
+   printInfo(cfi);
+   delete fh;
+}
+
+
+void Print::printIndex(const std::string& path)
+{
+   printf("printing %s ...\n", path.c_str());
+
+   XrdSysTrace tr(""); tr.What = 2;
+   InfoIndex index(&tr);
+   if ( ! index.Open(m_oss, m_ossUser, "", path.c_str(), 0, true))
+   {
+      return;
+   }
+
+   std::vector<std::string> paths;
+   index.GetPaths(paths);
+   printf("%zu files in %d slots\n\n", paths.size(), index.GetNSlots());
+
+   for (std::vector<std::string>::iterator i = paths.begin(); i != paths.end(); ++i)
+   {
+      Info cfi(&tr);
+      if ( ! cfi.Read(index, *i)) continue;
+
+      printf("printing %s ...\n", i->c_str());
+      printInfo(cfi);
+   }
+}
+
+
+void Print::printInfo(Info& cfi)
+{
 
    int cntd = 0;
    for (int i = 0; i < cfi.GetSizeInBits(); ++i)
@@ -111,7 +156,7 @@ void Print::printFile(const std::string& path)
    }
 
    // printf("\nlatest access statistics:\n");
-   size_t startIdx = cfi.GetAccessCnt() < cfi.GetMaxNumAccess() ? 0 : cfi.GetAccessCnt() - cfi.GetMaxNumAccess();
+   size_t startIdx = cfi.GetAccessCnt() - store.m_astats.size();
    for (std::vector<Info::AStat>::const_iterator it = store.m_astats.begin(); it != store.m_astats.end(); ++it)
    {
       printf("access %zu: ", startIdx++);
@@ -136,10 +181,12 @@ void Print::printFile(const std::string& path)
          snprintf(ot, 500, "%02d:%02d:%02d", hours, min, sec);
       }
 
-      printf("%s, duration %s, bytesDisk=%lld, bytesRAM=%lld, bytesMissed=%lld\n", as, ot, it->BytesDisk, it->BytesRam, it->BytesMissed);
+      printf("%s, duration %s, bytesDisk=%lld, bytesRAM=%lld, bytesMissed=%lld", as, ot, it->BytesDisk, it->BytesRam, it->BytesMissed);
+      if (cfi.GetVersion() >= 3)
+         printf(", blocksPrefetched=%d, prefetchHits=%d", it->BlocksPrefetched, it->BlocksPrefetchHit);
+      printf("\n");
    }
 
-   delete fh;
    printf("\n");
 }
 
@@ -23,6 +23,8 @@ class XrdOssDF;
 
 namespace XrdFileCache
 {
+class Info;
+
 class Print {
 public:
    //------------------------------------------------------------------------
@@ -41,11 +43,26 @@ private:
    //---------------------------------------------------------------------
    bool isInfoFile(const char* path);
 
+   //---------------------------------------------------------------------
+   //! Check file is the info index
+   //---------------------------------------------------------------------
+   bool isIndexFile(const char* path);
+
    //---------------------------------------------------------------------
    //! Print information in meta-data file
    //---------------------------------------------------------------------
    void printFile(const std::string& path);
 
+   //---------------------------------------------------------------------
+   //! Print information of all files in the info index
+   //---------------------------------------------------------------------
+   void printIndex(const std::string& path);
+
+   //---------------------------------------------------------------------
+   //! Print download status and access statistics
+   //---------------------------------------------------------------------
+   void printInfo(Info& cfi);
+
    //---------------------------------------------------------------------
    //! Print information in meta-data file recursivly
    //---------------------------------------------------------------------
@@ -9,53 +9,13 @@ using namespace XrdFileCache;
 
 namespace
 {
-class FPurgeState
-{
-public:
-   struct FS
-   {
-      std::string path;
-      long long nByte;
-      FS(const char* p, long long n) : path(p), nByte(n) {}
-   };
-
-   typedef std::multimap<time_t, FS> map_t;
-   typedef map_t::iterator map_i;
-   map_t fmap;
-   
-   FPurgeState(long long iNByteReq) : nByteReq(iNByteReq), nByteAccum(0) {}
-
-   void checkFile (time_t iTime, const char* iPath,  long long iNByte)
-   {
-      if (nByteAccum < nByteReq || iTime < fmap.rbegin()->first)
-      {
-         fmap.insert(std::pair<const time_t, FS> (iTime, FS(iPath, iNByte)));
-         nByteAccum += iNByte;
-
-         // remove newest files from map if necessary
-         while (nByteAccum > nByteReq)
-         {
-            time_t nt = fmap.begin()->first;
-            std::pair<map_i, map_i> ret = fmap.equal_range(nt);
-            for (map_i it2 = ret.first; it2 != ret.second; ++it2)
-               nByteAccum -= it2->second.nByte;
-            fmap.erase(ret.first, ret.second);
-         }
-      }
-   }
-
-private:
-   long long nByteReq;
-   long long nByteAccum;
-};
-
 XrdSysTrace* GetTrace()
 {
    // needed for logging macros
    return Cache::GetInstance().GetTrace();
 }
 
-void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState& purgeState)
+void FillIndexRecurse( XrdOssDF* iOssDF, const std::string& path, PurgeIndex& purgeIndex)
 {
    char buff[256];
    XrdOucEnv env;
@@ -87,17 +47,18 @@ void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState&
             Info cinfo(Cache::GetInstance().GetTrace());
             if (fh->Open(np.c_str(), O_RDONLY, 0600, env) == XrdOssOK && cinfo.Read(fh, np))
             {
+               std::string dataPath = np.substr(0, np.size() - InfoExtLen);
                time_t accessTime;
                if (cinfo.GetLatestDetachTime(accessTime))
                {
-                  TRACE(Dump, "FillFileMapRecurse() checking " << buff << " accessTime  " << accessTime);
-                  purgeState.checkFile(accessTime, np.c_str(), cinfo.GetNDownloadedBytes());
+                  TRACE(Dump, "FillIndexRecurse() checking " << buff << " accessTime  " << accessTime);
+                  purgeIndex.Update(dataPath, cinfo, accessTime);
                }
                else
                {
                   // cinfo file does not contain any known accesses, use stat.mtime instead.
 
-                  TRACE(Debug, "FillFileMapRecurse() could not get access time for " << np << ", trying stat");
+                  TRACE(Debug, "FillIndexRecurse() could not get access time for " << np << ", trying stat");
 
                   XrdOss* oss = Cache::GetInstance().GetOss();
                   struct stat fstat;
@@ -105,14 +66,14 @@ void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState&
                   if (oss->Stat(np.c_str(), &fstat) == XrdOssOK)
                   {
                      accessTime = fstat.st_mtime;
-                     TRACE(Dump, "FillFileMapRecurse() have access time for " << np << " via stat: " << accessTime);
-                     purgeState.checkFile(accessTime, np.c_str(), cinfo.GetNDownloadedBytes());
+                     TRACE(Dump, "FillIndexRecurse() have access time for " << np << " via stat: " << accessTime);
+                     purgeIndex.Update(dataPath, cinfo, accessTime);
                   }
                   else
                   {
                      // This really shouldn't happen ... but if it does remove cinfo and the data file right away.
 
-                     TRACE(Warning, "FillFileMapRecurse() could not get access time for " << np
+                     TRACE(Warning, "FillIndexRecurse() could not get access time for " << np
                                                                                           << "; purging.");
                      oss->Unlink(np.c_str());
                      np = np.substr(0, np.size() - strlen(XrdFileCache::Info::m_infoExtension));
@@ -122,7 +83,7 @@ void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState&
             }
             else
             {
-               TRACE(Warning, "FillFileMapRecurse() can't open or read " << np << ", err " << strerror(errno)
+               TRACE(Warning, "FillIndexRecurse() can't open or read " << np << ", err " << strerror(errno)
                                                                          << "; purging.");
                XrdOss* oss = Cache::GetInstance().GetOss();
                oss->Unlink(np.c_str());
@@ -132,7 +93,7 @@ void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState&
          }
          else if (dh->Opendir(np.c_str(), env) == XrdOssOK)
          {
-            FillFileMapRecurse(dh, np, purgeState);
+            FillIndexRecurse(dh, np, purgeIndex);
          }
 
          delete dh; dh = 0;
@@ -141,14 +102,77 @@ void FillFileMapRecurse( XrdOssDF* iOssDF, const std::string& path, FPurgeState&
    }
 }
 }
-void Cache::CacheDirCleanup()
+//______________________________________________________________________________
+
+bool Cache::ScanCacheDir()
 {
    XrdOucEnv env;
+   XrdOssDF* dh = m_output_fs->newDir(m_configuration.m_username.c_str());
+   bool      ok = (dh->Opendir("", env) == XrdOssOK);
+
+   if (ok)
+   {
+      // The index is built aside and swapped in as files released meanwhile
+      // keep updating the one in use.
+      PurgeIndex scan;
+
+      TRACE(Info, "Cache::ScanCacheDir() rebuilding purge index");
+      m_purgeIndex.BeginRebuild(scan);
+      FillIndexRecurse(dh, "", scan);
+
+      // Files kept in the info index have no cinfo file.
+      if (m_infoIndex)
+      {
+         std::vector<std::string> paths;
+         m_infoIndex->GetPaths(paths);
+         for (std::vector<std::string>::iterator i = paths.begin(); i != paths.end(); ++i)
+         {
+            Info cinfo(m_trace);
+            time_t accessTime;
+            if ( ! cinfo.Read(*m_infoIndex, *i)) continue;
+            if ( ! cinfo.GetLatestDetachTime(accessTime)) accessTime = cinfo.RefStoredData().m_creationTime;
+            scan.Update(*i, cinfo, accessTime);
+         }
+      }
+      m_purgeIndex.EndRebuild(scan);
+      TRACE(Info, "Cache::ScanCacheDir() purge index has " << m_purgeIndex.Size() << " files");
+   }
+   else
+   {
+      TRACE(Error, "Cache::ScanCacheDir() can't open cache root directory");
+   }
+   dh->Close();
+   delete dh;
+   return ok;
+}
+
+//______________________________________________________________________________
+
+void Cache::CacheDirCleanup()
+{
    XrdOss*      oss = Cache::GetInstance().GetOss();
    XrdOssVSInfo sP;
 
+   // Should the index not cover the volume to remove, e.g. because the rest
+   // is in use, a scan each cycle would not help. So rescan at most once
+   // every so many cycles.
+   const int rescanCycles = 10;
+   int       scanAge      = rescanCycles;
+
+   m_purgeIndex.SetPolicy(m_configuration.m_purgePolicy);
+
+   // The purge index is read from its checkpoint and the cache is only
+   // scanned if there is none or when the index turns out to be incomplete.
+   if ( ! m_purgeIndex.Load(oss, m_configuration.m_username, PurgeIndex::m_checkpointName))
+   {
+      ScanCacheDir();
+      scanAge = 0;
+   }
+
    while (1)
    {
+      ++scanAge;
+
       // get amount of space to erase
       long long bytesToRemove = 0;
       if (oss->StatVS(&sP, m_configuration.m_data_space.c_str(), 1) < 0)
@@ -169,51 +193,67 @@ void Cache::CacheDirCleanup()
 
       if (bytesToRemove > 0)
       {
-         // make a sorted map of file patch by access time
-         XrdOssDF* dh = oss->newDir(m_configuration.m_username.c_str());
-         if (dh->Opendir("", env) == XrdOssOK)
+         // pick files in purge policy order, prepare 20% more volume than required
+         PurgeIndex::Selection_t files;
+         long long nByteReq = bytesToRemove * 5 / 4;
+         if (m_purgeIndex.Select(nByteReq, files) < bytesToRemove)
          {
-            FPurgeState purgeState(bytesToRemove * 5 / 4); // prepare 20% more volume than required
-
-            FillFileMapRecurse(dh, "", purgeState);
-
-            // loop over map and remove files with highest value of access time
-            struct stat fstat;
-            for (FPurgeState::map_i it = purgeState.fmap.begin(); it != purgeState.fmap.end(); ++it)
+            if (scanAge > rescanCycles)
             {
+               TRACE(Info, "Cache::CacheDirCleanup() purge index does not cover the required volume, rescanning");
+               ScanCacheDir();
+               scanAge = 0;
+               m_purgeIndex.Select(nByteReq, files);
+            }
+            else
+            {
+               TRACE(Debug, "Cache::CacheDirCleanup() purge index does not cover the required volume, last scan " << scanAge << " cycles ago");
+            }
+         }
 
-               std::string infoPath = it->second.path;
-               std::string dataPath = infoPath.substr(0, infoPath.size() - strlen(XrdFileCache::Info::m_infoExtension));
+         struct stat fstat;
+         for (PurgeIndex::Selection_t::iterator it = files.begin(); it != files.end(); ++it)
+         {
+            std::string dataPath = it->first;
+            std::string infoPath = dataPath + XrdFileCache::Info::m_infoExtension;
 
-               if (HaveActiveFileWithLocalPath(dataPath))
-                  continue;
+            if (HaveActiveFileWithLocalPath(dataPath))
+               continue;
 
-               // remove info file
-               if (oss->Stat(infoPath.c_str(), &fstat) == XrdOssOK)
-               {
-                  // cinfo file can be on another oss.space, do not subtract for now.
-                  // bytesToRemove -= fstat.st_size;
-                  oss->Unlink(infoPath.c_str());
-                  TRACE(Info, "Cache::CacheDirCleanup() removed file:" <<  infoPath <<  " size: " << fstat.st_size);
-               }
-
-               // remove data file
-               if (oss->Stat(dataPath.c_str(), &fstat) == XrdOssOK)
-               {
-                  bytesToRemove -= it->second.nByte;
+            // remove info file
+            if (oss->Stat(infoPath.c_str(), &fstat) == XrdOssOK)
+            {
+               // cinfo file can be on another oss.space, do not subtract for now.
+               // bytesToRemove -= fstat.st_size;
+               oss->Unlink(infoPath.c_str());
+               TRACE(Info, "Cache::CacheDirCleanup() removed file:" <<  infoPath <<  " size: " << fstat.st_size);
+            }
+            if (m_infoIndex)
+            {
+               m_infoIndex->Remove(dataPath);
+            }
 
-                  oss->Unlink(dataPath.c_str());
-                  TRACE(Info, "Cache::CacheDirCleanup() removed file: %s " << dataPath << " size " << it->second.nByte);
-               }
+            // remove data file
+            if (oss->Stat(dataPath.c_str(), &fstat) == XrdOssOK)
+            {
+               bytesToRemove -= it->second;
 
-               if (bytesToRemove <= 0)
-                  break;
+               oss->Unlink(dataPath.c_str());
+               TRACE(Info, "Cache::CacheDirCleanup() removed file: %s " << dataPath << " size " << it->second);
+               m_purgeIndex.Evicted(dataPath);
+            }
+            else
+            {
+               m_purgeIndex.Remove(dataPath);
             }
+
+            if (bytesToRemove <= 0)
+               break;
          }
-         dh->Close();
-         delete dh; dh = 0;
       }
 
+      m_purgeIndex.Save(oss, m_configuration.m_username, m_configuration.m_meta_space, PurgeIndex::m_checkpointName);
+
       sleep(m_configuration.m_purgeInterval);
    }
 }
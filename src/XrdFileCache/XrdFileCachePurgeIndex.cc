@@ -0,0 +1,397 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+#include "XrdOss/XrdOss.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdSys/XrdSysTrace.hh"
+#include "XrdFileCachePurgeIndex.hh"
+#include "XrdFileCacheInfo.hh"
+#include "XrdFileCache.hh"
+#include "XrdFileCacheTrace.hh"
+
+using namespace XrdFileCache;
+
+namespace
+{
+// Checkpoint layout: magic, version, GDSF inflation, number of entries, the
+// entries (path length, path, Record) and the number of entries once more.
+const char s_magic[8] = { 'X', 'R', 'D', 'P', 'F', 'C', 'I', 'X' };
+const int  s_version  = 1;
+
+struct Record
+{
+   long long nBytes;
+   long long lastAccess;
+   long long prevAccess;
+   long long nAccess;
+   double    base;
+};
+
+template<typename T> void put(std::string &buf, const T &v)
+{
+   buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template<typename T> bool get(const std::vector<char> &buf, size_t &off, T &v)
+{
+   if (off + sizeof(T) > buf.size()) return false;
+   memcpy(&v, &buf[off], sizeof(T));
+   off += sizeof(T);
+   return true;
+}
+}
+
+const char *PurgeIndex::m_checkpointName = "/.xrdpfc_purge_index";
+const char *PurgeIndex::m_traceID        = "PurgeIndex";
+
+//______________________________________________________________________________
+
+PurgeIndex::PurgeIndex() :
+   m_inflation(0),
+   m_policy(kGDSF),
+   m_dirty(false),
+   m_rebuilding(false)
+{}
+
+//______________________________________________________________________________
+
+XrdSysTrace* PurgeIndex::GetTrace() const
+{
+   // needed for logging macros
+   return Cache::GetInstance().GetTrace();
+}
+
+//______________________________________________________________________________
+
+const char* PurgeIndex::PolicyName(Policy_e p)
+{
+   switch (p)
+   {
+      case kLRU:  return "lru";
+      case kLRU2: return "lru2";
+      default:    return "gdsf";
+   }
+}
+
+//______________________________________________________________________________
+
+double PurgeIndex::value(const Entry &e) const
+{
+   // Files with the lowest value are removed first.
+   switch (m_policy)
+   {
+      case kLRU:  return e.lastAccess;
+      case kLRU2: return e.prevAccess;
+      default:    return e.base + e.nAccess / std::max(e.nBytes / 1048576.0, 1.0);
+   }
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Update(const std::string &path, const Info &info, time_t atime)
+{
+   const Info::Store &store = info.RefStoredData();
+
+   Entry e;
+   e.nBytes     = info.GetNDownloadedBytes();
+   e.nAccess    = store.m_accessCnt;
+   e.lastAccess = atime;
+
+   // Use the latest two recorded accesses, closed or not.
+   int n = 0;
+   for (std::vector<Info::AStat>::const_reverse_iterator it = store.m_astats.rbegin(); it != store.m_astats.rend() && n < 2; ++it, ++n)
+   {
+      time_t t = it->DetachTime ? it->DetachTime : it->AttachTime;
+      if (n == 0) { if (t) e.lastAccess = t; }
+      else        e.prevAccess = t;
+   }
+
+   XrdSysMutexHelper lock(&m_mutex);
+   e.base        = m_inflation;
+   m_files[path] = e;
+   m_dirty       = true;
+   if (m_rebuilding) m_updated.insert(path);
+}
+
+//______________________________________________________________________________
+
+long long PurgeIndex::Select(long long nBytes, Selection_t &files) const
+{
+   // Keep the lowest valued files whose sizes add up to nBytes. Ties are
+   // broken by access time.
+   typedef std::pair<double, time_t>        Key_t;
+   typedef std::multimap<Key_t, Map_ci>     Sel_t;
+
+   Sel_t     sel;
+   long long nSel = 0;
+
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+
+      for (Map_ci it = m_files.begin(); it != m_files.end(); ++it)
+      {
+         Key_t key(value(it->second), it->second.lastAccess);
+         if (nSel < nBytes || key < sel.rbegin()->first)
+         {
+            sel.insert(std::make_pair(key, it));
+            nSel += it->second.nBytes;
+
+            // drop the highest valued files that are not needed any more
+            while ( ! sel.empty())
+            {
+               Sel_t::iterator last = --sel.end();
+               if (nSel - last->second->second.nBytes < nBytes) break;
+               nSel -= last->second->second.nBytes;
+               sel.erase(last);
+            }
+         }
+      }
+
+      files.clear();
+      files.reserve(sel.size());
+      for (Sel_t::iterator it = sel.begin(); it != sel.end(); ++it)
+         files.push_back(std::make_pair(it->second->first, it->second->second.nBytes));
+   }
+
+   return nSel;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Evicted(const std::string &path)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+
+   Map_t::iterator it = m_files.find(path);
+   if (it == m_files.end()) return;
+
+   if (m_policy == kGDSF)
+      m_inflation = std::max(m_inflation, value(it->second));
+
+   m_files.erase(it);
+   m_dirty = true;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::Remove(const std::string &path)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   if (m_files.erase(path)) m_dirty = true;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::BeginRebuild(PurgeIndex &scan)
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   m_rebuilding = true;
+   m_updated.clear();
+
+   scan.m_policy    = m_policy;
+   scan.m_inflation = m_inflation;
+}
+
+//______________________________________________________________________________
+
+void PurgeIndex::EndRebuild(PurgeIndex &scan)
+{
+   // A file released during the scan may have been read before its cinfo
+   // was written, so the entry kept here is the more recent one.
+   XrdSysMutexHelper lock(&m_mutex);
+   XrdSysMutexHelper scanLock(&scan.m_mutex);
+
+   for (Set_t::iterator it = m_updated.begin(); it != m_updated.end(); ++it)
+   {
+      Map_t::iterator fi = m_files.find(*it);
+      if (fi != m_files.end()) scan.m_files[*it] = fi->second;
+   }
+   m_files.swap(scan.m_files);
+   scan.m_files.clear();
+
+   m_updated.clear();
+   m_rebuilding = false;
+   m_dirty      = true;
+}
+
+//______________________________________________________________________________
+
+size_t PurgeIndex::Size() const
+{
+   XrdSysMutexHelper lock(&m_mutex);
+   return m_files.size();
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::Load(XrdOss *oss, const std::string &user, const char *path)
+{
+   XrdOucEnv env;
+   struct stat st;
+
+   XrdOssDF *fp = oss->newFile(user.c_str());
+   if (fp->Open(path, O_RDONLY, 0600, env) != XrdOssOK || fp->Fstat(&st) != XrdOssOK)
+   {
+      TRACE(Info, "PurgeIndex::Load() no checkpoint " << path);
+      delete fp;
+      return false;
+   }
+
+   std::vector<char> buf(st.st_size);
+   ssize_t ret = st.st_size ? fp->Read(&buf[0], 0, st.st_size) : 0;
+   fp->Close();
+   delete fp;
+
+   if (ret != st.st_size)
+   {
+      TRACE(Warning, "PurgeIndex::Load() failed reading " << path << " err " << strerror(errno));
+      return false;
+   }
+
+   size_t    off = 0;
+   char      magic[sizeof(s_magic)];
+   int       version;
+   double    inflation;
+   long long n, n_end;
+
+   if ( ! get(buf, off, magic) || memcmp(magic, s_magic, sizeof(s_magic)) ||
+        ! get(buf, off, version) || version != s_version ||
+        ! get(buf, off, inflation) || ! get(buf, off, n) || n < 0)
+   {
+      TRACE(Warning, "PurgeIndex::Load() bad checkpoint header in " << path);
+      return false;
+   }
+
+   Map_t files;
+   for (long long i = 0; i < n; ++i)
+   {
+      int    len;
+      Record r;
+      if ( ! get(buf, off, len) || len <= 0 || off + len > buf.size())
+      {
+         TRACE(Warning, "PurgeIndex::Load() truncated checkpoint " << path);
+         return false;
+      }
+      std::string p(&buf[off], len);
+      off += len;
+      if ( ! get(buf, off, r))
+      {
+         TRACE(Warning, "PurgeIndex::Load() truncated checkpoint " << path);
+         return false;
+      }
+
+      Entry &e     = files[p];
+      e.nBytes     = r.nBytes;
+      e.lastAccess = r.lastAccess;
+      e.prevAccess = r.prevAccess;
+      e.nAccess    = r.nAccess;
+      e.base       = r.base;
+   }
+
+   if ( ! get(buf, off, n_end) || n_end != n)
+   {
+      TRACE(Warning, "PurgeIndex::Load() truncated checkpoint " << path);
+      return false;
+   }
+
+   XrdSysMutexHelper lock(&m_mutex);
+   m_files.swap(files);
+   m_inflation = inflation;
+   m_dirty     = false;
+
+   TRACE(Info, "PurgeIndex::Load() read " << m_files.size() << " files from " << path);
+   return true;
+}
+
+//______________________________________________________________________________
+
+bool PurgeIndex::Save(XrdOss *oss, const std::string &user, const std::string &space, const char *path)
+{
+   std::string buf;
+   size_t      nFiles;
+
+   {
+      XrdSysMutexHelper lock(&m_mutex);
+
+      if ( ! m_dirty) return true;
+
+      long long n = m_files.size();
+      put(buf, s_magic);
+      put(buf, s_version);
+      put(buf, m_inflation);
+      put(buf, n);
+      for (Map_ci it = m_files.begin(); it != m_files.end(); ++it)
+      {
+         int    len = it->first.size();
+         Record r;
+         r.nBytes     = it->second.nBytes;
+         r.lastAccess = it->second.lastAccess;
+         r.prevAccess = it->second.prevAccess;
+         r.nAccess    = it->second.nAccess;
+         r.base       = it->second.base;
+
+         put(buf, len);
+         buf.append(it->first);
+         put(buf, r);
+      }
+      put(buf, n);
+
+      nFiles  = m_files.size();
+      m_dirty = false;
+   }
+
+   // Write a new checkpoint next to the old one and move it into place.
+   std::string tmp = std::string(path) + ".new";
+   XrdOucEnv   env;
+   env.Put("oss.cgroup", space.c_str());
+
+   oss->Unlink(tmp.c_str());
+   bool ok = (oss->Create(user.c_str(), tmp.c_str(), 0600, env, XRDOSS_mkpath) == XrdOssOK);
+
+   XrdOssDF *fp = oss->newFile(user.c_str());
+   if (ok && fp->Open(tmp.c_str(), O_RDWR, 0600, env) == XrdOssOK)
+   {
+      ok = (fp->Write(buf.data(), 0, buf.size()) == (ssize_t) buf.size()) && fp->Fsync() == XrdOssOK;
+      fp->Close();
+   }
+   else
+   {
+      ok = false;
+   }
+   delete fp;
+
+   if (ok) ok = (oss->Rename(tmp.c_str(), path) == XrdOssOK);
+
+   if ( ! ok)
+   {
+      TRACE(Error, "PurgeIndex::Save() failed writing " << path << " err " << strerror(errno));
+      oss->Unlink(tmp.c_str());
+      XrdSysMutexHelper lock(&m_mutex);
+      m_dirty = true;
+      return false;
+   }
+
+   TRACE(Debug, "PurgeIndex::Save() wrote " << nFiles << " files to " << path);
+   return true;
+}
@@ -0,0 +1,145 @@
+#ifndef __XRDFILECACHE_PURGEINDEX_HH__
+#define __XRDFILECACHE_PURGEINDEX_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2014 by Board of Trustees of the Leland Stanford, Jr., University
+// Author: Alja Mrak-Tadel, Matevz Tadel, Brian Bockelman
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include <time.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdOss;
+class XrdSysTrace;
+
+namespace XrdFileCache
+{
+class Info;
+
+//----------------------------------------------------------------------------
+//! In-memory index of cached files from which the purge picks files to
+//! remove. It is built by a scan of the cinfo files, kept up to date when
+//! files are released and checkpointed into the cache so that restarts do
+//! not need a scan.
+//----------------------------------------------------------------------------
+class PurgeIndex
+{
+public:
+   //! Order of removal
+   enum Policy_e
+   {
+      kLRU,   //!< least recently accessed first
+      kLRU2,  //!< oldest second to last access first (LRU-K with K=2)
+      kGDSF   //!< Greedy-Dual-Size-Frequency, large and rarely used files first
+   };
+
+   struct Entry
+   {
+      long long nBytes;      //!< bytes on disk
+      time_t    lastAccess;  //!< latest access
+      time_t    prevAccess;  //!< access before the latest one, 0 if none
+      long long nAccess;     //!< number of accesses
+      double    base;        //!< GDSF inflation value when last accessed
+
+      Entry() : nBytes(0), lastAccess(0), prevAccess(0), nAccess(0), base(0) {}
+   };
+
+   //! Files selected for removal: data file path and bytes
+   typedef std::vector<std::pair<std::string, long long> > Selection_t;
+
+   PurgeIndex();
+
+   void SetPolicy(Policy_e p) { m_policy = p; }
+
+   static const char* PolicyName(Policy_e p);
+
+   //---------------------------------------------------------------------
+   //! \brief Add or update a file from its cinfo.
+   //!
+   //! @param path   data file path
+   //! @param info   download status and access statistics of the file
+   //! @param atime  access time to use when info has no detach time
+   //---------------------------------------------------------------------
+   void Update(const std::string &path, const Info &info, time_t atime);
+
+   //---------------------------------------------------------------------
+   //! \brief Select files to remove, in policy order, until their size
+   //! adds up to at least nBytes.
+   //!
+   //! @return total size of the selected files
+   //---------------------------------------------------------------------
+   long long Select(long long nBytes, Selection_t &files) const;
+
+   //! File was purged, forget it and age the GDSF values of the others
+   void Evicted(const std::string &path);
+
+   //! File is no longer in the cache
+   void Remove(const std::string &path);
+
+   //---------------------------------------------------------------------
+   //! \brief Start rebuilding the index into scan, which gets the policy
+   //! of this index. Files updated here meanwhile are remembered.
+   //---------------------------------------------------------------------
+   void BeginRebuild(PurgeIndex &scan);
+
+   //---------------------------------------------------------------------
+   //! \brief Replace the files of this index by those of scan, keeping
+   //! the updates made since BeginRebuild(). Leaves scan empty.
+   //---------------------------------------------------------------------
+   void EndRebuild(PurgeIndex &scan);
+
+   size_t Size() const;
+
+   //---------------------------------------------------------------------
+   //! \brief Read the index from a checkpoint file.
+   //! @return false if there is no valid checkpoint
+   //---------------------------------------------------------------------
+   bool Load(XrdOss *oss, const std::string &user, const char *path);
+
+   //---------------------------------------------------------------------
+   //! \brief Write the index to a checkpoint file if it has changed.
+   //! The index is written to a temporary file which is then renamed.
+   //---------------------------------------------------------------------
+   bool Save(XrdOss *oss, const std::string &user, const std::string &space, const char *path);
+
+   XrdSysTrace* GetTrace() const;
+
+   static const char *m_checkpointName;  //!< checkpoint path in the cache
+
+private:
+   typedef std::map<std::string, Entry> Map_t;
+   typedef Map_t::const_iterator        Map_ci;
+   typedef std::set<std::string>        Set_t;
+
+   double value(const Entry &e) const;
+
+   static const char  *m_traceID;
+
+   mutable XrdSysMutex m_mutex;
+   Map_t               m_files;
+   Set_t               m_updated;     //!< files updated during a rebuild
+   double              m_inflation;   //!< GDSF value of the last purged file
+   Policy_e            m_policy;
+   bool                m_dirty;       //!< changed since last checkpoint
+   bool                m_rebuilding;  //!< BeginRebuild() was called
+};
+}
+
+#endif
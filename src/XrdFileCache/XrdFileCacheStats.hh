@@ -35,11 +35,14 @@ public:
    //----------------------------------------------------------------------
    Stats() {
       m_BytesDisk = m_BytesRam = m_BytesMissed = 0;
+      m_BlocksPrefetched = m_BlocksPrefetchHit = 0;
    }
 
    long long m_BytesDisk;         //!< number of bytes served from disk cache
    long long m_BytesRam;          //!< number of bytes served from RAM cache
    long long m_BytesMissed;       //!< number of bytes served directly from XrdCl
+   int       m_BlocksPrefetched;  //!< number of blocks requested by prefetch
+   int       m_BlocksPrefetchHit; //!< number of prefetched blocks later read by clients
 
    inline void AddStats(Stats &Src)
    {
@@ -48,6 +51,8 @@ public:
       m_BytesDisk   += Src.m_BytesDisk;
       m_BytesRam    += Src.m_BytesRam;
       m_BytesMissed += Src.m_BytesMissed;
+      m_BlocksPrefetched  += Src.m_BlocksPrefetched;
+      m_BlocksPrefetchHit += Src.m_BlocksPrefetchHit;
 
       m_MutexXfc.UnLock();
    }
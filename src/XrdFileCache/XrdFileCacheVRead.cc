@@ -11,6 +11,8 @@
 #include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 
+#include <algorithm>
+
 namespace XrdFileCache
 {
 // a list of IOVec chuncks that match a given block index
@@ -179,6 +181,17 @@ int File::ReadV(const XrdOucIOVec *readV, int n)
    {
       XrdSysCondVarHelper _lck(m_downloadCond);
 
+      // update prefetch score, before blocks can get released
+      int prefetchHits = 0;
+      for (std::vector<ReadVChunkListRAM>::iterator i = blks_processed.begin(); i != blks_processed.end(); ++i)
+         if (take_prefetch_hit(i->block)) ++prefetchHits;
+
+      for (std::vector<ReadVChunkListDisk>::iterator i = blocks_on_disk.bv.begin(); i != blocks_on_disk.bv.end(); ++i)
+         if (take_prefetch_hit(i->block_idx)) ++prefetchHits;
+
+      add_prefetch_hits(prefetchHits);
+      loc_stats.m_BlocksPrefetchHit += prefetchHits;
+
       // decrease ref count on the remaining blocks
       // this happens in case read process has been broke due to previous errors
       for (std::vector<ReadVChunkListRAM>::iterator i = blocks_to_process.bv.begin(); i != blocks_to_process.bv.end(); ++i)
@@ -225,8 +238,12 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
 {
    BlockList_t blks_to_request;
 
+   std::vector<int> blks_touched;
+
    m_downloadCond.Lock();
 
+   note_demand();
+
    for (int iov_idx = 0; iov_idx < n; iov_idx++)
    {
       const int blck_idx_first =  readV[iov_idx].offset / m_cfi.GetBufferSize();
@@ -234,6 +251,8 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
 
       for (int block_idx = blck_idx_first; block_idx <= blck_idx_last; ++block_idx)
       {
+         blks_touched.push_back(block_idx);
+
          TRACEF(Dump, "VReadPreProcess chunk "<<  readV[iov_idx].size << "@"<< readV[iov_idx].offset);
 
          BlockMap_i bi = m_block_map.find(block_idx);
@@ -278,6 +297,11 @@ bool File::VReadPreProcess(const XrdOucIOVec *readV, int n,
       }
    }
 
+   std::sort(blks_touched.begin(), blks_touched.end());
+   blks_touched.erase(std::unique(blks_touched.begin(), blks_touched.end()), blks_touched.end());
+   m_accessModel.RegisterReadV(blks_touched);
+   resume_prefetch();
+
    m_downloadCond.UnLock();
 
    ProcessBlockRequests(blks_to_request);
@@ -83,6 +83,7 @@ XrdOucHash<XrdHttpProtocol::StaticPreloadInfo> *XrdHttpProtocol::staticpreload =
 
 kXR_int32 XrdHttpProtocol::myRole = kXR_isManager;
 bool XrdHttpProtocol::selfhttps2http = false;
+bool XrdHttpProtocol::usektls = false;
 bool XrdHttpProtocol::isdesthttps = false;
 char *XrdHttpProtocol::sslcafile = 0;
 char *XrdHttpProtocol::secretkey = 0;
@@ -177,6 +178,12 @@ extern "C" {
 
 
 
+// Kernel TLS needs OpenSSL 3.0 or later built with ktls support
+//
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define XRDHTTP_KTLS 1
+#endif
+
 /******************************************************************************/
 /*               U g l y  O p e n S S L   w o r k a r o u n d s               */
 /******************************************************************************/
@@ -633,6 +640,11 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
   if (ishttps && !ssldone) {
 
       if (!ssl) {
+#ifdef XRDHTTP_KTLS
+          // The kernel can only take over a TLS session from a socket BIO
+          if (usektls) sbio = BIO_new_socket(Link->FDnum(), BIO_NOCLOSE);
+            else
+#endif
           sbio = CreateBIO(Link);
           BIO_set_nbio(sbio, 1);
           ssl = SSL_new(sslctx);
@@ -676,6 +688,7 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
           return -1;
         }
       BIO_set_nbio(sbio, 0);
+      if (usektls) SetKTLS();
 
       res = SSL_get_verify_result(ssl);
       TRACEI(DEBUG, " SSL_get_verify_result returned :" << res);
@@ -1097,6 +1110,7 @@ int XrdHttpProtocol::Config(const char *ConfigFN, XrdOucEnv *myEnv) {
       else if TS_Xeq("staticpreload", xstaticpreload);
       else if TS_Xeq("listingdeny", xlistdeny);
       else if TS_Xeq("header2cgi", xheader2cgi);
+      else if TS_Xeq("ktls", xktls);
       else {
         eDest.Say("Config warning: ignoring unknown directive '", var, "'.");
         Config.Echo();
@@ -1259,12 +1273,27 @@ int XrdHttpProtocol::getDataOneShot(int blen, bool wait) {
       myBuffEnd = myBuff->buff;
     }
 
+    // The kernel decrypts straight from the socket, bypassing the link. So,
+    // wait via the link to honor its timeout and account for what we read.
+    if (ktlsrecv && wait && SSL_pending(ssl) <= 0) {
+      int retc = Link->Wait4Data(readWait);
+      if (retc < 0) {
+        Link->setEtext("link read error or closed");
+        return -1;
+      }
+      if (!retc) {
+        Link->setEtext("link timeout");
+        return 1;
+      }
+    }
+
     rlen = SSL_read(ssl, myBuffEnd, sslavail);
     if (rlen <= 0) {
       Link->setEtext("link SSL read error");
       ERR_print_errors(sslbio_err);
       return -1;
     }
+    if (ktlsrecv) Link->addIOStats(rlen, 0);
 
 
   } else {
@@ -1401,7 +1430,7 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
 
   if (body && bodylen) {
     TRACE(REQ, "Sending " << bodylen << " bytes");
-    if (ishttps) {
+    if (ishttps && !ktlssend) {
       r = SSL_write(ssl, body, bodylen);
       if (r <= 0) {
         ERR_print_errors(sslbio_err);
@@ -1417,6 +1446,50 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
   return 0;
 }
 
+/// Hand the TLS session to the kernel, if it took it, or fall back to the
+/// XrdLink BIO. Must be called once the handshake has completed.
+
+void XrdHttpProtocol::SetKTLS() {
+#ifdef XRDHTTP_KTLS
+  BIO *rbio = SSL_get_rbio(ssl);
+  BIO *wbio = SSL_get_wbio(ssl);
+
+  ktlsrecv = BIO_get_ktls_recv(rbio);
+  ktlssend = BIO_get_ktls_send(wbio);
+  TRACEI(DEBUG, " kTLS send: " << ktlssend << " recv: " << ktlsrecv);
+
+  // If the kernel decrypts what we receive we must keep reading through the
+  // socket BIO. getDataOneShot() then waits via the link and accounts for the
+  // bytes itself. The socket's own timeout must match the link's read wait.
+  if (ktlsrecv) {
+    struct timeval tv;
+    tv.tv_sec = readWait / 1000;
+    tv.tv_usec = (readWait % 1000) * 1000;
+    setsockopt(Link->FDnum(), SOL_SOCKET, SO_RCVTIMEO, (struct timeval *)&tv, sizeof(struct timeval));
+    if (ktlssend) return;
+  }
+
+  // Whatever the kernel does not handle goes through the link so that
+  // timeouts and statistics work as usual
+  BIO *lbio = CreateBIO(Link);
+  if (!lbio) return;
+
+  if (ktlssend) {
+    // The socket BIO stays as the write BIO and loses its read reference
+    BIO_up_ref(wbio);
+    SSL_set0_rbio(ssl, lbio);
+  } else if (ktlsrecv) {
+    // The socket BIO stays as the read BIO and loses its write reference
+    BIO_up_ref(rbio);
+    SSL_set0_wbio(ssl, lbio);
+  } else {
+    // The kernel lacks TLS ULP support or the cipher is not supported
+    SSL_set_bio(ssl, lbio, lbio);
+  }
+  sbio = lbio;
+#endif
+}
+
 int XrdHttpProtocol::StartSimpleResp(int code, const char *desc, const char *header_to_add, long long bodylen) {
   std::stringstream ss;
   const std::string crlf = "\r\n";
@@ -1683,6 +1756,17 @@ int XrdHttpProtocol::InitSecurity() {
 #endif
 
   sslctx = SSL_CTX_new((SSL_METHOD *)meth);
+
+  // Ask OpenSSL to move the session keys into the kernel after the handshake
+  if (usektls) {
+#ifdef XRDHTTP_KTLS
+    SSL_CTX_set_options(sslctx, SSL_OP_ENABLE_KTLS);
+    eDest.Say(" Using kernel TLS when available");
+#else
+    eDest.Say("Config warning: kernel TLS is not supported by this OpenSSL; ktls ignored.");
+    usektls = false;
+#endif
+  }
   //SSL_CTX_set_min_proto_version(sslctx, TLS1_2_VERSION);
   SSL_CTX_set_session_cache_mode(sslctx, SSL_SESS_CACHE_SERVER);
   SSL_CTX_set_session_id_context(sslctx, s_server_session_id_context,
@@ -1788,6 +1872,8 @@ void XrdHttpProtocol::Cleanup() {
 
   ssl = 0;
   sbio = 0;
+  ktlssend = false;
+  ktlsrecv = false;
 
   if (SecEntity.grps) free(SecEntity.grps);
   if (SecEntity.endorsements) free(SecEntity.endorsements);
@@ -1837,6 +1923,8 @@ void XrdHttpProtocol::Reset() {
   SecEntity.tident = XrdHttpSecEntityTident;
   ishttps = false;
   ssldone = false;
+  ktlssend = false;
+  ktlsrecv = false;
 
   Bridge = 0;
   ssl = 0;
@@ -1886,6 +1974,41 @@ int XrdHttpProtocol::xsslverifydepth(XrdOucStream & Config) {
   return 0;
 }
 
+/******************************************************************************/
+/*                                 x k t l s                                  */
+/******************************************************************************/
+
+/* Function: xktls
+
+   Purpose:  To parse the directive: ktls <yes|no|0|1>
+
+             <val>    when yes, https connections try to hand the TLS session
+                      to the kernel (kTLS) after the handshake. Data is then
+                      encrypted by the kernel and sendfile() can be used. When
+                      the kernel or cipher does not support it, the connection
+                      falls back to the usual path.
+
+  Output: 0 upon success or !0 upon failure.
+ */
+
+int XrdHttpProtocol::xktls(XrdOucStream & Config) {
+  char *val;
+
+  // Get the value
+  //
+  val = Config.GetWord();
+  if (!val || !val[0]) {
+    eDest.Emsg("Config", "ktls flag not specified");
+    return 1;
+  }
+
+  // Record the value
+  //
+  usektls = (!strcasecmp(val, "true") || !strcasecmp(val, "yes") || !strcmp(val, "1"));
+
+  return 0;
+}
+
 /******************************************************************************/
 /*                                 x s s l c e r t                            */
 /******************************************************************************/
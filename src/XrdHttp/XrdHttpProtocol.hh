@@ -154,6 +154,10 @@ private:
 
   /// Create a new BIO object from an XrdLink.  Returns NULL on failure.
   static BIO *CreateBIO(XrdLink *lp);
+
+  /// After the SSL handshake, see if the kernel took over the TLS records.
+  /// If not, go back to the XrdLink BIO.
+  void SetKTLS();
   
   /// Functions related to the configuration
   static int Config(const char *fn, XrdOucEnv *myEnv);
@@ -176,6 +180,7 @@ private:
   static int xsslverifydepth(XrdOucStream &Config);
   static int xsecretkey(XrdOucStream &Config);
   static int xheader2cgi(XrdOucStream &Config);
+  static int xktls(XrdOucStream &Config);
   
   static XrdHttpSecXtractor *secxtractor;
   
@@ -266,6 +271,14 @@ private:
   /// connection being established
   bool ssldone;
 
+  /// Tells that the kernel encrypts what we send (kTLS), so that data can be
+  /// sent directly through the link, including via sendfile()
+  bool ktlssend;
+
+  /// Tells that the kernel decrypts what we receive (kTLS), so that reads go
+  /// through the socket and the link is only used to wait and keep statistics
+  bool ktlsrecv;
+
   
   
   static XrdCryptoFactory *myCryptoFactory;
@@ -356,6 +369,9 @@ protected:
   
   /// If client is HTTPS, self-redirect with HTTP+token
   static bool selfhttps2http;
+
+  /// If true, try to hand the TLS session to the kernel after the handshake
+  static bool usektls;
   
   /// If true, use the embedded css and icons
   static bool embeddedstatic;
@@ -86,6 +86,11 @@
 //
 #define XRDNET_NORLKUP   0x00800000
 
+// Allow several sockets to bind to the same port (SO_REUSEPORT) so that
+// incomming connections are spread across them by the kernel.
+//
+#define XRDNET_REUSEPORT 0x01000000
+
 /******************************************************************************/
 /*                  X r d N e t S o c k e t   O p t i o n s                   */
 /******************************************************************************/
@@ -266,6 +266,11 @@ int XrdNetSocket::Open(const char *inpath, int port, int flags, int windowsz)
        setOpts(SockFD, flags, eroute);
        if (setsockopt(SockFD,SOL_SOCKET,SO_REUSEADDR, (Sokdata_t)&one, szone)
        &&  eroute) eroute->Emsg("Open",errno,"set socket REUSEADDR for",epath);
+#ifdef SO_REUSEPORT
+       if (flags & XRDNET_REUSEPORT
+       &&  setsockopt(SockFD,SOL_SOCKET,SO_REUSEPORT, (Sokdata_t)&one, szone)
+       &&  eroute) eroute->Emsg("Open",errno,"set socket REUSEPORT for",epath);
+#endif
       }
 
 // Set the window size or udp buffer size, as needed (ignore errors)
@@ -1035,6 +1035,50 @@ XrdSfsXferSize XrdOfsFile::write(XrdSfsFileOffset  offset,    // In
    return nbytes;
 }
 
+/******************************************************************************/
+/*                                w r i t e v                                 */
+/******************************************************************************/
+
+XrdSfsXferSize XrdOfsFile::writev(XrdOucIOVec     *writeV,    // In
+                                  int              wdvCnt)    // In
+/*
+  Function: Perform all the writes specified in the writeV vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data to be written.
+            wdvCnt    - The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and SFS_ERROR o/w.
+            If the number of bytes written is less than requested, it is
+            considered an error.
+*/
+{
+   EPNAME("writev");
+   XrdSfsXferSize nbytes;
+
+// Perform any required tracing
+//
+   FTRACE(write, wdvCnt <<" segments");
+
+// Silly Castor stuff
+//
+   if (XrdOfsFS->evsObject && !(oh->isChanged)
+   &&  XrdOfsFS->evsObject->Enabled(XrdOfsEvs::Fwrite)) GenFWEvent();
+
+// Write the requested segments as a single vector so that the storage system
+// may write them as efficiently as it can.
+//
+   oh->isPending = 1;
+   nbytes = (XrdSfsXferSize)(oh->Select().WriteV(writeV, wdvCnt));
+   if (nbytes < 0)
+      return XrdOfsFS->Emsg(epname, error, (int)nbytes, "writev", oh);
+
+// Return number of bytes written
+//
+   return nbytes;
+}
+
 /******************************************************************************/
 /*                             w r i t e   A I O                              */
 /******************************************************************************/
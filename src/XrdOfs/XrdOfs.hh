@@ -144,6 +144,9 @@ public:
 
         int            write(XrdSfsAio *aioparm);
 
+        XrdSfsXferSize writev(XrdOucIOVec      *writeV,
+                              int               wdvCnt);
+
         int            sync();
 
         int            sync(XrdSfsAio *aiop);
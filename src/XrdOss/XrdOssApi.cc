@@ -34,6 +34,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <strings.h>
 #include <stdio.h>
@@ -41,6 +42,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
 #endif
@@ -1000,6 +1002,86 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      return retval;
 }
 
+/******************************************************************************/
+/*                                W r i t e V                                 */
+/******************************************************************************/
+
+/*
+  Function: Perform all the writes specified in the writeV vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data.
+            n         - The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+
+  Notes:    Elements that are adjacent in the file are written with a single
+            pwritev() call. Partial writes are continued where they stopped.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+#if defined(__linux__)
+   struct iovec iov[IOV_MAX], *iovP;
+   ssize_t wrsz, totBytes = 0;
+   long long wrOffs, wrLen;
+   int i, k, iovNum;
+
+// Make sure the file is open
+//
+   if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Make sure no offset is too large
+//
+#if _FILE_OFFSET_BITS!=64
+   for (i = 0; i < n; i++)
+       if (writeV[i].offset > 0x000000007fffffff) return (ssize_t)-EFBIG;
+#endif
+
+// Run through the vector gathering elements that are adjacent in the file
+//
+   for (i = 0; i < n; i = k)
+       {wrOffs = writeV[i].offset; wrLen = 0; iovNum = 0;
+        for (k = i; k < n && iovNum < IOV_MAX
+                  && writeV[k].offset == wrOffs+wrLen; k++)
+            {iov[iovNum].iov_base = writeV[k].data;
+             iov[iovNum].iov_len  = writeV[k].size;
+             wrLen += writeV[k].size; iovNum++;
+            }
+
+        if (XrdOssSS->MaxSize && wrOffs+wrLen > XrdOssSS->MaxSize)
+           return (ssize_t)-XRDOSS_E8007;
+
+     // Write out the range, continuing any partial write
+     //
+        iovP = iov;
+        while(wrLen > 0)
+             {do {wrsz = pwritev(fd, iovP, iovNum, wrOffs);}
+                 while(wrsz < 0 && errno == EINTR);
+              if (wrsz <= 0)
+                 {if (!wrsz) return -ESPIPE;
+                  return (errno == EBADF && cxobj ? (ssize_t)-XRDOSS_E8022
+                                                  : (ssize_t)-errno);
+                 }
+              totBytes += wrsz; wrOffs += wrsz; wrLen -= wrsz;
+              while(wrsz && wrsz >= (ssize_t)iovP->iov_len)
+                   {wrsz -= iovP->iov_len; iovP++; iovNum--;}
+              if (wrsz)
+                 {iovP->iov_base = (char *)iovP->iov_base + wrsz;
+                  iovP->iov_len -= wrsz;
+                 }
+             }
+       }
+
+// All done, return bytes written
+//
+   return totBytes;
+#else
+   return XrdOssDF::WriteV(writeV, n);
+#endif
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
@@ -38,6 +38,11 @@
 //! we need to pass a vector of file offsets, lengths, and the corresponding
 //! target buffer pointers to effect a sendfile() call. It is used by the
 //! xrd, sfs, ofs., and oss components.
+//!
+//! When the file descriptor does not support sendfile() (e.g. a pipe or some
+//! fuse and plugin provided descriptors) the data is moved using splice().
+//! An element whose offset is sfPipe refers to a pipe; sendsz bytes are taken
+//! from wherever the pipe happens to be.
 //-----------------------------------------------------------------------------
 
 struct XrdOucSFVec {union {char *buffer;    //!< ->Data if fdnum < 0
@@ -47,5 +52,6 @@ struct XrdOucSFVec {union {char *buffer;    //!< ->Data if fdnum < 0
                     int   fdnum;            //!< File descriptor for data
 
                     enum {sfMax = 16};      //!< Maximum number of elements
+                    static const off_t sfPipe = -1; //!< Offset for a pipe
                    };
 #endif
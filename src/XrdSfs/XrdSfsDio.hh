@@ -74,6 +74,9 @@ virtual int SendFile(int fildes) = 0;
 //! @param  sfvnum - total number of elements in sfvec and includes the first
 //!                  unused element. There is a maximum number of elements
 //!                  that the vector may have; defined inside XrdOucSFVec.
+//!                  Elements may also refer to descriptors that do not
+//!                  support sendfile() (e.g. a pipe, see XrdOucSFVec::sfPipe)
+//!                  in which case the data is moved using splice().
 //!
 //! @return >0     - either data has been sent in a previous call or the total
 //!                  amount of data in sfvec is greater than the original
@@ -51,7 +51,45 @@
 #include <sys/types.h>
 #include <sys/utsname.h>
 #endif
+#ifdef __linux__
+#include <sched.h>
+#endif
 #include "XrdSysUtils.hh"
+
+/******************************************************************************/
+/*                               B i n d C P U                                */
+/******************************************************************************/
+
+bool XrdSysUtils::BindCPU(int cpuSet, int numSets)
+{
+#if defined(__linux__) && defined(CPU_SET)
+   cpu_set_t cpuMask;
+   long numCPU = sysconf(_SC_NPROCESSORS_ONLN);
+   int  i, n = 0;
+
+// Validate the arguments
+//
+   if (numSets < 1 || cpuSet < 0 || cpuSet >= numSets)
+      {errno = EINVAL; return false;}
+
+// Construct the mask of processors in the set. When there are more sets than
+// processors, sets share processors in round-robin fashion.
+//
+   CPU_ZERO(&cpuMask);
+   if (numCPU < 1) {errno = ERANGE; return false;}
+   if (cpuSet >= numCPU) cpuSet = cpuSet % numCPU;
+   for (i = cpuSet; i < numCPU && i < CPU_SETSIZE; i += numSets)
+       {CPU_SET(i, &cpuMask); n++;}
+   if (!n) {errno = ERANGE; return false;}
+
+// Bind the calling thread (pid 0 refers to the calling thread in Linux)
+//
+   return sched_setaffinity(0, sizeof(cpuMask), &cpuMask) == 0;
+#else
+   errno = ENOTSUP;
+   return false;
+#endif
+}
   
 /******************************************************************************/
 /*                              E x e c N a m e                               */
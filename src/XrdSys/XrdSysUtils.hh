@@ -37,6 +37,22 @@ class XrdSysUtils
 {
 public:
 
+//-----------------------------------------------------------------------------
+//! Restrict the calling thread to a subset of the online processors. The
+//! processors are striped into numSets sets and the thread is bound to all
+//! processors whose number modulo numSets equals cpuSet. When there are more
+//! sets than processors, sets share processors in a round-robin fashion.
+//!
+//! @param  cpuSet  - the set to bind to (0 <= cpuSet < numSets).
+//! @param  numSets - the number of sets the processors are divided into.
+//!
+//! @return true   - thread is bound to the set.
+//! @return false  - thread not bound, errno has the reason (ENOTSUP if the
+//!                  platform does not support thread affinity).
+//-----------------------------------------------------------------------------
+
+static bool        BindCPU(int cpuSet, int numSets);
+
 //-----------------------------------------------------------------------------
 //! Get the name of the current executable.
 //!
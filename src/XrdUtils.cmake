@@ -151,6 +151,7 @@ add_library(
   # Xrd
   #-----------------------------------------------------------------------------
   Xrd/XrdBuffer.cc              Xrd/XrdBuffer.hh
+  Xrd/XrdBuffArena.cc           Xrd/XrdBuffArena.hh
   Xrd/XrdBuffXL.cc              Xrd/XrdBuffXL.hh
   Xrd/XrdInet.cc                Xrd/XrdInet.hh
   Xrd/XrdInfo.cc                Xrd/XrdInfo.hh
@@ -164,6 +165,8 @@ add_library(
                                 Xrd/XrdPollE.icc
                                 Xrd/XrdPollPoll.hh
                                 Xrd/XrdPollPoll.icc
+                                Xrd/XrdPollU.hh
+                                Xrd/XrdPollU.icc
   Xrd/XrdProtocol.cc            Xrd/XrdProtocol.hh
   Xrd/XrdScheduler.cc           Xrd/XrdScheduler.hh
   Xrd/XrdSendQ.cc               Xrd/XrdSendQ.hh
@@ -71,6 +71,8 @@
 #include "XrdXrootd/XrdXrootdMonitor.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
+#include "XrdXrootd/XrdXrootdStatm.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdTransit.hh"
@@ -331,10 +333,33 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
    else if (!as_noaio) XrdXrootdAioReq::Init(as_segsize, as_maxperreq, as_maxpersrv);
    else eDest.Say("Config warning: asynchronous I/O has been disabled!");
 
+// Initialize for parallel readv, if so wanted
+//
+   if (as_rvfanout > 1 || as_rvmrggap > 0)
+      {XrdXrootdReadV::Init(Sched,as_rvfanout,as_rvminsegs,as_rvmrggap);
+       if (as_rvfanout > XrdXrootdReadV::maxSlices)
+          {char buff[64];
+           sprintf(buff, "%d readjusted to %d", as_rvfanout,
+                         XrdXrootdReadV::maxSlices);
+           eDest.Emsg("Config", "async rvfanout", buff);
+          }
+      }
+
+// Initialize for bulk stat requests
+//
+   XrdXrootdStatm::Init(Sched, as_stfanout);
+   if (as_stfanout > XrdXrootdStatm::maxFanout)
+      {char buff[64];
+       sprintf(buff, "%d readjusted to %d", as_stfanout,
+                     XrdXrootdStatm::maxFanout);
+       eDest.Emsg("Config", "async stfanout", buff);
+      }
+
 // Create the file lock manager
 //
    Locker = (XrdXrootdFileLock *)new XrdXrootdFileLock1();
-   XrdXrootdFile::Init(Locker, as_nosf == 0);
+   XrdXrootdFile::Init(Locker, as_nosf == 0, as_ramax, as_raseq);
+   XrdXrootdWBuff::Init(Sched, as_wbmax, as_miniosz, as_wbwait);
    if (as_nosf) eDest.Say("Config warning: sendfile I/O has been disabled!");
 
 // Schedule protocol object cleanup (also advise the transit protocol)
@@ -581,6 +606,11 @@ int XrdXrootdProtocol::ConfigSecurity(XrdOucEnv &xEnv, const char *cfn)
    Purpose:  To parse directive: async [limit <aiopl>] [maxsegs <msegs>]
                                        [maxtot <mtot>] [segsize <segsz>]
                                        [minsize <iosz>] [maxstalls <cnt>]
+                                       [rvfanout <rvf>] [rvminsegs <rvs>]
+                                       [rvmerge <gap>] [rvsfsize <rvsz>]
+                                       [conreqs <creqs>] [ramax <rasz>]
+                                       [raseq <rasq>] [stfanout <stf>]
+                                       [wbmax <wbsz>] [wbwait <wbms>]
                                        [force] [syncw] [off] [nosf]
 
              <aiopl>  maximum number of async ops per link. Default 8.
@@ -595,6 +625,43 @@ int XrdXrootdProtocol::ConfigSecurity(XrdOucEnv &xEnv, const char *cfn)
                       typically 1M).
              <cnt>    Maximum number of client stalls before synchronous i/o is
                       used. Async mode is tried after <cnt> requests.
+             <rvf>    maximum number of slices a readv request for a file is
+                      split into; the slices are read concurrently. The default
+                      is 1 (i.e. readv segments are read serially).
+             <rvs>    minimum number of readv segments in a slice. Default 8.
+             <gap>    readv segments for a file are sorted by offset and read
+                      as a single range when they are less than <gap> bytes
+                      apart (overlapping or adjacent segments always qualify).
+                      By default, segments are read as requested.
+             <rvsz>   the minimum size of a readv segment for it to be sent
+                      using sendfile. Sendfile is only used when at least half
+                      of the readv data is in such segments. Default 256K.
+             <creqs>  maximum number of path based requests (e.g. open, stat,
+                      locate) per link that may be executed concurrently with
+                      the link's other requests. Requests that refer to a file
+                      handle are always executed in order. The default is 0
+                      (i.e. requests are executed one at a time).
+             <rasz>   the largest readahead window used for a file that is
+                      being read sequentially. The window starts at a few
+                      requests worth of data and doubles whenever the client
+                      catches up to it. The default is 0 (i.e. no readahead).
+             <rasq>   number of consecutive sequential reads needed before
+                      readahead starts. The default is 2.
+             <stf>    maximum number of threads used to stat the paths of a
+                      bulk stat (kXR_statm) request or the entries of a
+                      dirlist with stat information. The default is 4. Note
+                      that a paged dirlist (kXR_dpage) is resumed by entry
+                      position; each page rereads the preceding entries and
+                      entries may be skipped or repeated should the directory
+                      change between pages.
+             <wbsz>   the size of the write-behind buffer of a file opened for
+                      writing. Contiguous writes smaller than the minimum async
+                      size (at most <wbsz>/2) are merged and written in the
+                      background in pieces aligned to <wbsz>. Write errors are
+                      then reported by the next sync or close. The default is
+                      0 (i.e. no write-behind).
+             <wbms>   maximum number of milliseconds data may be held in the
+                      write-behind buffer. The default is 100.
              force    Uses async i/o for all requests, even when not explicitly
                       requested (this is compatible with synchronous clients).
              syncw    Use synchronous i/o for write requests.
@@ -610,7 +677,9 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
     int  i, ppp;
     int  V_force=-1, V_syncw = -1, V_off = -1, V_mstall = -1, V_nosf = -1;
     int  V_limit=-1, V_msegs=-1, V_mtot=-1, V_minsz=-1, V_segsz=-1;
-    int  V_minsf=-1;
+    int  V_minsf=-1, V_rvfan=-1, V_rvmsg=-1, V_rvgap=-1, V_rvsfs=-1;
+    int  V_conrq=-1, V_ramax=-1, V_raseq=-1, V_stfan=-1, V_wbmax=-1;
+    int  V_wbwt=-1;
     long long llp;
     struct asyncopts {const char *opname; int minv; int *oploc;
                       const char *opmsg;} asopts[] =
@@ -625,7 +694,17 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
         {"maxstalls",  0, &V_mstall,"async maxstalls"},
         {"maxtot",     0, &V_mtot,  "async maxtot"},
         {"minsfsz",    1, &V_minsf, "async minsfsz"},
-        {"minsize", 4096, &V_minsz, "async minsize"}};
+        {"minsize", 4096, &V_minsz, "async minsize"},
+        {"rvfanout",   0, &V_rvfan, "async rvfanout"},
+        {"rvminsegs",  0, &V_rvmsg, "async rvminsegs"},
+        {"rvmerge",    1, &V_rvgap, "async rvmerge"},
+        {"rvsfsize",   1, &V_rvsfs, "async rvsfsize"},
+        {"conreqs",    0, &V_conrq, "async conreqs"},
+        {"ramax",   4096, &V_ramax, "async ramax"},
+        {"raseq",      0, &V_raseq, "async raseq"},
+        {"stfanout",   0, &V_stfan, "async stfanout"},
+        {"wbmax",   4096, &V_wbmax, "async wbmax"},
+        {"wbwait",     0, &V_wbwt,  "async wbwait"}};
     int numopts = sizeof(asopts)/sizeof(struct asyncopts);
 
     if (!(val = Config.GetWord()))
@@ -688,6 +767,16 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
    if (V_syncw > 0) as_syncw     = 1;
    if (V_nosf  > 0) as_nosf      = 1;
    if (V_minsf > 0) as_minsfsz   = V_minsf;
+   if (V_rvfan > 0) as_rvfanout  = V_rvfan;
+   if (V_rvmsg > 0) as_rvminsegs = V_rvmsg;
+   if (V_rvgap > 0) as_rvmrggap  = V_rvgap;
+   if (V_rvsfs > 0) as_rvsfsize  = V_rvsfs;
+   if (V_conrq > 0) as_conreqs   = V_conrq;
+   if (V_ramax > 0) as_ramax     = V_ramax;
+   if (V_raseq > 0) as_raseq     = V_raseq;
+   if (V_stfan > 0) as_stfanout  = V_stfan;
+   if (V_wbmax > 0) as_wbmax     = V_wbmax;
+   if (V_wbwt  > 0) as_wbwait    = V_wbwt;
 
    return 0;
 }
@@ -1106,7 +1195,8 @@ int XrdXrootdProtocol::xlog(XrdOucStream &Config)
 /* Function: xmon
 
    Purpose:  Parse directive: monitor [all] [auth]  [flush [io] <sec>]
-                                      [fstat <sec> [lfn] [ops] [ssq] [xfr <n>]
+                                      [fstat <sec> [lfn] [ops] [ra] [ssq]
+                                                   [xfr <n>]
                                       [ident <sec>] [mbuff <sz>] [rbuff <sz>]
                                       [rnums <cnt>] [window <sec>]
                                       dest [Events] <host:port>
@@ -1121,6 +1211,8 @@ int XrdXrootdProtocol::xlog(XrdOucStream &Config)
                             <sec> specifies the flush interval (also see xfr)
                             lfn    - adds lfn to the open event
                             ops    - adds the ops record when the file is closed
+                            ra     - adds the readahead record when the file is
+                                     closed (see async ramax)
                             ssq    - computes the sum of squares for the ops rec
                             xfr <n>- inserts i/o stats for open files every
                                      <sec>*<n>. Minimum is 1.
@@ -1180,6 +1272,7 @@ int XrdXrootdProtocol::xmon(XrdOucStream &Config)
                    while((val = Config.GetWord()))
                         if (!strcmp("lfn", val)) monFSopt |=  XROOTD_MON_FSLFN;
                    else if (!strcmp("ops", val)) monFSopt |=  XROOTD_MON_FSOPS;
+                   else if (!strcmp("ra",  val)) monFSopt |=  XROOTD_MON_FSRDA;
                    else if (!strcmp("ssq", val)) monFSopt |=  XROOTD_MON_FSSSQ;
                    else if (!strcmp("xfr", val))
                            {if (!(val = Config.GetWord()))
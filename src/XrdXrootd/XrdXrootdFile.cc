@@ -55,6 +55,8 @@ extern XrdOucTrace      *XrdXrootdTrace;
        XrdXrootdFileLock *XrdXrootdFile::Locker;
 
        int              XrdXrootdFile::sfOK         = 1;
+       int              XrdXrootdFile::raMax        = 0;
+       int              XrdXrootdFile::raSeq        = 2;
        const char      *XrdXrootdFile::TraceID      = "File";
        const char      *XrdXrootdFileTable::TraceID = "FileTable";
 
@@ -78,6 +80,10 @@ XrdXrootdFile::XrdXrootdFile(const char *id, const char *path, XrdSfsFile *fp,
     FileMode = mode;
     AsyncMode= (async ? 1 : 0);
     ID       = id;
+    raNext   = raEnd = 0;
+    raWind   = raRun = 0;
+    wbP      = (mode == 'w' && XrdXrootdWBuff::isOn()
+             ? new XrdXrootdWBuff(fp) : 0);
 
     Stats.Init();
 
@@ -112,6 +118,22 @@ XrdXrootdFile::~XrdXrootdFile()
 
    if (XrdSfsp)
       {TRACEI(FS, "closing " <<FileMode <<' ' <<FileKey);
+       if (Stats.rvm.segs)
+          TRACEI(FS, "readv merged " <<Stats.rvm.segs <<" segs into "
+                     <<Stats.rvm.reads <<" reads; " <<Stats.rvm.rqbytes
+                     <<" bytes wanted " <<Stats.rvm.rdbytes <<" read");
+       if (Stats.rda.reads)
+          TRACEI(FS, "readahead covered " <<Stats.rda.hits <<" of "
+                     <<Stats.rda.reads <<" sequential reads; "
+                     <<Stats.rda.advs <<" advises for " <<Stats.rda.bytes
+                     <<" bytes max window " <<Stats.rda.wmax);
+       if (wbP)
+          {wbP->Flush();
+           if (wbP->numIn)
+              TRACEI(FS, "write-behind merged " <<wbP->numIn <<" writes into "
+                         <<wbP->numOut);
+           delete wbP;
+          }
        delete XrdSfsp;
        XrdSfsp = 0;
        Locker->Unlock(FileKey, FileMode);
@@ -119,6 +141,59 @@ XrdXrootdFile::~XrdXrootdFile()
    if (FileKey) free(FileKey);
 }
 
+/******************************************************************************/
+/* Private:                        R e a d A h e a d 2                        */
+/******************************************************************************/
+
+// This is only called by the thread handling reads for the file. The state is
+// advisory; should it ever be stale the only cost is an unneeded readahead.
+//
+void XrdXrootdFile::ReadAhead2(long long offs, int rlen)
+{
+   long long raBeg, raLen;
+
+// A read that does not start where the previous one ended breaks the stream.
+// Drop all readahead state; it is rebuilt once reads are sequential again.
+//
+   if (offs != raNext)
+      {raNext = offs + rlen;
+       raEnd  = 0; raWind = 0; raRun = 0;
+       return;
+      }
+   raNext = offs + rlen;
+
+// Wait until enough sequential reads were seen to trust the pattern
+//
+   if (raRun < raSeq && ++raRun < raSeq) return;
+
+// Record whether this read was fully covered by an earlier readahead
+//
+   Stats.raOps(raNext <= raEnd);
+
+// Advise more data once less than half a window remains in front of the
+// reader. The initial window is a few requests worth of data and it doubles,
+// up to the maximum, each time the stream needs more readahead.
+//
+   if (!raWind) raWind = (rlen < raMax/4 ? rlen*4 : raMax);
+      else {if (raEnd - raNext >= raWind/2) return;
+            if (raWind < raMax) raWind = (raWind < raMax/2 ? raWind*2 : raMax);
+           }
+
+// We never advise anything past the end of the file
+//
+   raBeg = (raEnd > raNext ? raEnd : raNext);
+   if (raBeg >= Stats.fSize) return;
+   raLen = raNext + raWind - raBeg;
+   if (raBeg + raLen > Stats.fSize) raLen = Stats.fSize - raBeg;
+
+// Issue the preread; for plain files the oss turns this into a kernel
+// readahead of the range so that later reads find the data in memory.
+//
+   XrdSfsp->read(raBeg, static_cast<XrdSfsXferSize>(raLen));
+   raEnd = raBeg + raLen;
+   Stats.raAdv(raWind, raLen);
+}
+
 /******************************************************************************/
 /*                   x r d _ F i l e T a b l e   C l a s s                    */
 /******************************************************************************/
@@ -128,8 +203,6 @@ XrdXrootdFile::~XrdXrootdFile()
   
 int XrdXrootdFileTable::Add(XrdXrootdFile *fp)
 {
-   const int allocsz = XRD_FTABSIZE*sizeof(fp);
-   XrdXrootdFile **newXTab, **oldXTab;
    int i;
 
 // Find a free spot in the internal table
@@ -139,36 +212,20 @@ int XrdXrootdFileTable::Add(XrdXrootdFile *fp)
    if (i < XRD_FTABSIZE)
       {FTab[i] = fp; FTfree = i+1; return i;}
 
-// Allocate an external table if we do not have one
-//
-   if (!XTab)
-      {if (!(XTab = (XrdXrootdFile **)malloc(allocsz))) return -1;
-       memset((void *)XTab, 0, allocsz);
-       XTnum   = XRD_FTABSIZE;
-       XTfree  = 1;
-       XTab[0] = fp;
-       return XRD_FTABSIZE;
-      }
-
 // Find a free spot in the external table
 //
    for (i = XTfree; i < XTnum; i++) if (!XTab[i]) break;
-   if (i < XTnum)
-      {XTab[i] = fp; XTfree = i+1; return i+XRD_FTABSIZE;}
 
-// Extend the table
+// Extend the table if it is full
 //
-   if (!(newXTab = (XrdXrootdFile **)malloc(XTnum*sizeof(XrdXrootdFile *)+allocsz)))
-      return -1;
-   memcpy((void *)newXTab, (const void *)XTab, XTnum*sizeof(XrdXrootdFile *));
-   memset((void *)(newXTab+XTnum), 0, allocsz);
-   oldXTab = XTab;
-   XTab = newXTab;
-   XTab[XTnum] = fp;
-   i = XTnum;
-   XTfree = XTnum+1;
-   XTnum += XRD_FTABSIZE;
-   free(oldXTab);
+   if (i >= XTnum)
+      {if (!Extend()) return -1;
+       i = XTfree;
+      }
+
+// Add the file to the external table
+//
+   XTab[i] = fp; XTfree = i+1;
    return i+XRD_FTABSIZE;
 }
  
@@ -251,6 +308,67 @@ if (XTab)
    delete this;
 }
   
+/******************************************************************************/
+/*                               R e s e r v e                                */
+/******************************************************************************/
+
+// Make sure that at least num slots are free so that a subsequent Add() does
+// not need to reallocate the table, which would pull it out from under Get().
+//
+bool XrdXrootdFileTable::Reserve(int num)
+{
+   int i, numFree = 0;
+
+// Count the free slots in both tables
+//
+   for (i = FTfree; i < XRD_FTABSIZE; i++) if (!FTab[i]) numFree++;
+   for (i = XTfree; i < XTnum;        i++) if (!XTab[i]) numFree++;
+
+// Extend the external table until we have enough free slots
+//
+   while(numFree < num)
+        {if (!Extend()) return false;
+         numFree += XRD_FTABSIZE;
+        }
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                            E x t e n d                            */
+/******************************************************************************/
+
+// Extend the external table by XRD_FTABSIZE slots and set XTfree to the first
+// of the new slots.
+//
+bool XrdXrootdFileTable::Extend()
+{
+   const int allocsz = XRD_FTABSIZE*sizeof(XrdXrootdFile *);
+   XrdXrootdFile **newXTab, **oldXTab;
+
+// Allocate an external table if we do not have one
+//
+   if (!XTab)
+      {if (!(XTab = (XrdXrootdFile **)malloc(allocsz))) return false;
+       memset((void *)XTab, 0, allocsz);
+       XTnum   = XRD_FTABSIZE;
+       XTfree  = 0;
+       return true;
+      }
+
+// Extend the table
+//
+   if (!(newXTab = (XrdXrootdFile **)malloc(XTnum*sizeof(XrdXrootdFile *)+allocsz)))
+      return false;
+   memcpy((void *)newXTab, (const void *)XTab, XTnum*sizeof(XrdXrootdFile *));
+   memset((void *)(newXTab+XTnum), 0, allocsz);
+   oldXTab = XTab;
+   XTab = newXTab;
+   XTfree = XTnum;
+   XTnum += XRD_FTABSIZE;
+   free(oldXTab);
+   return true;
+}
+
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
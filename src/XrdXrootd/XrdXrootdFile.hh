@@ -33,6 +33,7 @@
 
 #include "XProtocol/XPtypes.hh"
 #include "XrdXrootd/XrdXrootdFileStats.hh"
+#include "XrdXrootd/XrdXrootdWBuff.hh"
 
 /******************************************************************************/
 /*                         X r d X r o o t d F i l e                          */
@@ -47,6 +48,7 @@ class XrdXrootdFile
 public:
 
 XrdSfsFile  *XrdSfsp;           // -> Actual file object
+XrdXrootdWBuff *wbP;            // -> Write-behind buffer, if any
 char        *mmAddr;            // Memory mapped location, if any
 char        *FileKey;           // -> File hash name (actual file name now)
 char         FileMode;          // 'r' or 'w'
@@ -58,7 +60,23 @@ const char  *ID;                // File user
 
 XrdXrootdFileStats Stats;       // File access statistics
 
-static void Init(XrdXrootdFileLock *lp, int sfok) {Locker = lp; sfOK = sfok;}
+static void Init(XrdXrootdFileLock *lp, int sfok, int ramax=0, int raseq=2)
+                {Locker = lp; sfOK = sfok; raMax = ramax; raSeq = raseq;}
+
+inline void ReadAhead(long long offs, int rlen)
+                     {if (raMax) ReadAhead2(offs, rlen);}
+
+// Write() must be used for kXR_write data so that small writes are buffered
+// when write-behind is enabled. Any other operation on the file must first
+// call wbFlush() so that it sees the data written so far.
+//
+inline XrdSfsXferSize Write(long long offs, const char *buff, int blen)
+                      {return (wbP ? wbP->Write(offs, buff, blen)
+                                   : XrdSfsp->write(offs, buff, blen));
+                      }
+
+inline int  wbFlush(bool rpt=false)
+                   {return (wbP ? wbP->Flush(rpt) : SFS_OK);}
 
            XrdXrootdFile(const char *id, const char *path, XrdSfsFile *fp,
                          char mode='r', bool async=false, int sfOK=0,
@@ -66,10 +84,19 @@ static void Init(XrdXrootdFileLock *lp, int sfok) {Locker = lp; sfOK = sfok;}
           ~XrdXrootdFile();
 
 private:
-int bin2hex(char *outbuff, char *inbuff, int inlen);
+int  bin2hex(char *outbuff, char *inbuff, int inlen);
+void ReadAhead2(long long offs, int rlen);
+
 static XrdXrootdFileLock *Locker;
 static int                sfOK;
+static int                raMax;
+static int                raSeq;
 static const char        *TraceID;
+
+long long                 raNext;  // Offset of the read expected next
+long long                 raEnd;   // End of the range already read ahead
+int                       raWind;  // Current readahead window size
+int                       raRun;   // Number of consecutive sequential reads
 };
  
 /******************************************************************************/
@@ -85,7 +112,9 @@ static const char        *TraceID;
   
 // WARNING! Manipulation (i.e., Add/Del/delete) of this object must be
 //          externally serialized at the link level. Only one thread
-//          may be active w.r.t this object during manipulation!
+//          may be active w.r.t this object during manipulation! The one
+//          exception is that Add() may run alongside Get() as long as a free
+//          slot was reserved beforehand so that the table need not grow.
 //
 class XrdXrootdFileTable
 {
@@ -106,6 +135,8 @@ inline XrdXrootdFile *Get(int fnum)
 
        void           Recycle(XrdXrootdMonitor *monP);
 
+       bool           Reserve(int num);
+
        XrdXrootdFileTable(unsigned int mid=0) : FTfree(0), monID(mid),
                                                 XTab(0), XTnum(0), XTfree(0)
                          {memset((void *)FTab, 0, sizeof(FTab));}
@@ -114,6 +145,8 @@ private:
 
       ~XrdXrootdFileTable() {} // Always use Recycle() to delete this object!
 
+bool   Extend();
+
 static const char *TraceID;
 
 XrdXrootdFile *FTab[XRD_FTABSIZE];
@@ -48,6 +48,17 @@ struct {double      read;     // sum(read_size[i] **2) i = 1 to Ops.read
         double      rsegs;    // sum(readv_segs[i]**2) i = 1 to Ops.readv
         double      write;    // sum(write_size[i]**2) i = 1 to Ops.write
        }            ssq;
+struct {long long   segs;     // readv segments presented for merging
+        long long   reads;    // Ranges actually read after merging
+        long long   rqbytes;  // Bytes requested by the merged segments
+        long long   rdbytes;  // Bytes actually read for the merged ranges
+       }            rvm;
+struct {long long   bytes;    // Bytes advised for readahead
+        int         reads;    // Reads seen while the stream was sequential
+        int         hits;     // Such reads fully covered by the readahead
+        int         advs;     // Number of readahead requests issued
+        int         wmax;     // Largest readahead window used
+       }            rda;
 
 enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
 
@@ -58,6 +69,8 @@ enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
                  ops.rsMin = 0x7fff;
                  ops.rdMin = ops.rvMin = ops.wrMin = 0x7fffffff;
                  ssq.read  = ssq.readv = ssq.write = ssq.rsegs = 0.0;
+                 memset(&rvm, 0, sizeof(rvm));
+                 memset(&rda, 0, sizeof(rda));
                 };
 
 inline void rdOps(int rsz)
@@ -91,6 +104,18 @@ inline void rvOps(int rsz, int ssz)
                      }
                  }
 
+inline void rmOps(int ssz, int rsz, long long rqsz, long long rdsz)
+                 {rvm.segs += ssz; rvm.reads += rsz;
+                  rvm.rqbytes += rqsz; rvm.rdbytes += rdsz;
+                 }
+
+inline void raOps(bool hit) {rda.reads++; if (hit) rda.hits++;}
+
+inline void raAdv(int wsz, long long asz)
+                 {rda.advs++; rda.bytes += asz;
+                  if (wsz > rda.wmax) rda.wmax = wsz;
+                 }
+
 inline void wrOps(int wsz)
                  {if (monLvl)
                      {xfr.write += wsz; ops.write++; xfrXeq = 1;
@@ -161,6 +161,7 @@ enum  recTval {isClose = 0,   // Record for close
 enum  recFval {forced  =0x01, // If recFlag == isClose close due to disconnect
                hasOPS  =0x02, // If recFlag == isClose MonStatXFR + MonStatOPS
                hasSSQ  =0x04, // If recFlag == isClose XFR + OPS  + MonStatSSQ
+               hasRDA  =0x08, // If recFlag == isClose MonStatRDA is last
                hasLFN  =0x01, // If recFlag == isOpen  the lfn is present
                hasRW   =0x02, // If recFlag == isOpen  file opened r/w
                hasSID  =0x01  // if recFlag == isTime sID is present (new rec)
@@ -243,6 +244,17 @@ XrdXrootdMonDouble  rsegs;    // Sum (all readv segments)**2 (count as a unit)
 XrdXrootdMonDouble  write;    // Sum (all write requests)**2 (size)
 };
 
+// The following readahead data is collected per file when "ra" is specified
+//
+struct XrdXrootdMonStatRDA    // 24 Bytes
+{
+long long           bytes;    // Bytes advised for readahead
+int                 reads;    // Reads seen while the stream was sequential
+int                 hits;     // Such reads fully covered by the readahead
+int                 advs;     // Number of readahead requests issued
+int                 wmax;     // Largest readahead window used
+};
+
 // The following transfer data is collected for each open file.
 //
 struct XrdXrootdMonStatXFR
@@ -257,13 +269,16 @@ long long           write;    // Bytes written to file so far
 // If (recFlag & hasOPS) TRUE XrdXrootdMonStatOPS follows XrdXrootdMonStatXFR
 // If (recFlag & hasSSQ) TRUE XrdXrootdMonStatSQV follows XrdXrootdMonStatOPS
 // The XrdXrootdMonStatSSQ information is present only if "ssq" was specified.
+// If (recFlag & hasRDA) TRUE XrdXrootdMonStatRDA follows whatever precedes it
+// (i.e. it immediately follows Xfr, Ops, or Ssq depending on the other flags).
 //
-struct XrdXrootdMonFileCLS    // 32 | 80 | 96 Bytes
+struct XrdXrootdMonFileCLS    // 32 | 80 | 96 Bytes (+24 with hasRDA)
 {
 XrdXrootdMonFileHdr Hdr;      // Always present (recSize has full length)
 XrdXrootdMonStatXFR Xfr;      // Always present
 XrdXrootdMonStatOPS Ops;      // Only   present when (recFlag & hasOPS) is True
 XrdXrootdMonStatSSQ Ssq;      // Only   present when (recFlag & hasSSQ) is True
+XrdXrootdMonStatRDA Rda;      // Only   present when (recFlag & hasRDA) is True
 };
 
 // The following is reported when a user ends a session.
@@ -69,6 +69,7 @@ int                  XrdXrootdMonFile::repSize  = 0;
 int                  XrdXrootdMonFile::repTime  = 0;
 int                  XrdXrootdMonFile::fmHWM    =-1;
 int                  XrdXrootdMonFile::crecSize = 0;
+int                  XrdXrootdMonFile::rrecOffs = 0;
 int                  XrdXrootdMonFile::xfrCnt   = 0;
 int                  XrdXrootdMonFile::xfrRem   = 0;
 XrdXrootdMonFileXFR  XrdXrootdMonFile::xfrRec;
@@ -77,6 +78,7 @@ short                XrdXrootdMonFile::trecNLen = 0;
 char                 XrdXrootdMonFile::fsLFN    = 0;
 char                 XrdXrootdMonFile::fsLVL    = 0;
 char                 XrdXrootdMonFile::fsOPS    = 0;
+char                 XrdXrootdMonFile::fsRDA    = 0;
 char                 XrdXrootdMonFile::fsSSQ    = 0;
 char                 XrdXrootdMonFile::fsXFR    = 0;
 char                 XrdXrootdMonFile::crecFlag = 0;
@@ -162,6 +164,19 @@ void XrdXrootdMonFile::Close(XrdXrootdFileStats *fsP, bool isDisc)
        cRec.Ssq.write.dlong = htonll(xval.dlong);
       }
 
+// Record readahead statistics if so needed. This record always comes last and
+// its position depends on which of the preceding records are present.
+//
+   if (fsRDA)
+      {XrdXrootdMonStatRDA rda;
+       rda.bytes = htonll(fsP->rda.bytes);
+       rda.reads = htonl (fsP->rda.reads);
+       rda.hits  = htonl (fsP->rda.hits);
+       rda.advs  = htonl (fsP->rda.advs);
+       rda.wmax  = htonl (fsP->rda.wmax);
+       memcpy(((char *)&cRec)+rrecOffs, &rda, sizeof(rda));
+      }
+
 // Get a pointer to the next slot (the buffer gets locked)
 //
    cP = GetSlot(crecSize);
@@ -188,6 +203,7 @@ void XrdXrootdMonFile::Defaults(int intv, int opts, int xfrcnt)
    fsLFN  = (opts &  XROOTD_MON_FSLFN) != 0;
    fsOPS  = (opts & (XROOTD_MON_FSOPS  | XROOTD_MON_FSSSQ)) != 0;
    fsSSQ  = (opts &  XROOTD_MON_FSSSQ) != 0;
+   fsRDA  = (opts &  XROOTD_MON_FSRDA) != 0;
 
 // Set monitoring level
 //
@@ -371,6 +387,11 @@ bool XrdXrootdMonFile::Init(XrdScheduler *sp, XrdSysError  *errp, int bfsz)
       {crecSize += sizeof(XrdXrootdMonStatSSQ);
        crecFlag |= XrdXrootdMonFileHdr::hasSSQ;
       }
+   if (fsRDA)
+      {rrecOffs  = crecSize;
+       crecSize += sizeof(XrdXrootdMonStatRDA);
+       crecFlag |= XrdXrootdMonFileHdr::hasRDA;
+      }
    crecNLen = htons(static_cast<short>(crecSize));
 
 // Preformat the i/o record
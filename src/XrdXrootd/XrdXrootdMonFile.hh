@@ -86,6 +86,7 @@ static int                  repSize;
 static int                  repTime;
 static int                  fmHWM;
 static int                  crecSize;
+static int                  rrecOffs;
 static int                  xfrCnt;
 static int                  xfrRem;
 static XrdXrootdMonFileXFR  xfrRec;
@@ -94,6 +95,7 @@ static short                trecNLen;
 static char                 fsLFN;
 static char                 fsLVL;
 static char                 fsOPS;
+static char                 fsRDA;
 static char                 fsSSQ;
 static char                 fsXFR;
 static char                 crecFlag;
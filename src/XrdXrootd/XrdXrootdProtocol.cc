@@ -109,6 +109,16 @@ int                   XrdXrootdProtocol::as_force     = 0;
 int                   XrdXrootdProtocol::as_noaio     = 0;
 int                   XrdXrootdProtocol::as_nosf      = 0;
 int                   XrdXrootdProtocol::as_syncw     = 0;
+int                   XrdXrootdProtocol::as_rvfanout  = 1;
+int                   XrdXrootdProtocol::as_rvminsegs = 8;
+int                   XrdXrootdProtocol::as_rvmrggap  = 0;
+int                   XrdXrootdProtocol::as_rvsfsize  = 262144;
+int                   XrdXrootdProtocol::as_conreqs   = 0;
+int                   XrdXrootdProtocol::as_stfanout  = 4;
+int                   XrdXrootdProtocol::as_ramax     = 0;
+int                   XrdXrootdProtocol::as_raseq     = 2;
+int                   XrdXrootdProtocol::as_wbmax     = 0;
+int                   XrdXrootdProtocol::as_wbwait    = 100;
 
 const char           *XrdXrootdProtocol::myInst  = 0;
 const char           *XrdXrootdProtocol::TraceID = "Protocol";
@@ -318,6 +328,11 @@ int dlen, rc;
        return (XrdProtocol *)0;
       }
 
+// We only read the link via the link object so the poller may receive our
+// requests along with the link becoming ready.
+//
+   lp->setRecvAhead();
+
 // Get a protocol object off the stack (if none, allocate a new one)
 //
    if (!(xp = ProtStack.Pop())) xp = new XrdXrootdProtocol();
@@ -415,6 +430,29 @@ int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
 /******************************************************************************/
   
 int XrdXrootdProtocol::Process2()
+{
+   kXR_unt16 reqID = Request.header.requestid;
+   long long tBeg  = XrdXrootdStats::Clock(), tSnd;
+   int rc;
+
+// Execute the request and record how long it took, separating the time spent
+// sending the response. A request handed off to a worker is recorded there.
+//
+   Response.SendTime(true);
+   conDisp = false;
+   rc = ProcReq();
+   if (!conDisp)
+      {tSnd = Response.SendTime();
+       SI->Latency(reqID, XrdXrootdStats::Clock() - tBeg - tSnd, tSnd);
+      }
+   return rc;
+}
+
+/******************************************************************************/
+/*                       p r i v a t e   P r o c R e q                        */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::ProcReq()
 {
 // If we are verifying requests, see if this request needs to be verified
 //
@@ -496,6 +534,10 @@ int XrdXrootdProtocol::Process2()
 //
    ReqID.setID(Request.header.streamid);
 
+// Independent requests may be executed concurrently with this link's others
+//
+   if (as_conreqs && !ConReq()) return 0;
+
 // Process items that don't need arguments but may have them
 //
    switch(Request.header.requestid)
@@ -539,6 +581,7 @@ int XrdXrootdProtocol::Process2()
           case kXR_rm:        return do_Rm();
           case kXR_rmdir:     return do_Rmdir();
           case kXR_set:       return do_Set();
+          case kXR_statm:     return do_Statm();
           case kXR_statx:     return do_Statx();
           case kXR_truncate:  return do_Truncate();
           default:            break;
@@ -792,6 +835,177 @@ void XrdXrootdProtocol::Cleanup()
    if (wvInfo) {free(wvInfo); wvInfo = 0;}
 }
   
+/******************************************************************************/
+/*                                C o n R e q                                 */
+/******************************************************************************/
+
+// Return 0 if the request was handed off to a scheduler thread. Otherwise, the
+// request must be executed inline by the caller.
+//
+int XrdXrootdProtocol::ConReq()
+{
+   XrdXrootdProtocol *wp;
+   XrdBuffer *bp;
+
+// Only path based requests qualify as they cannot depend on any other request
+// that the client may have pipelined. Requests that refer to a file handle
+// are always executed inline so that they remain ordered.
+//
+   switch(Request.header.requestid)
+         {case kXR_chmod:
+          case kXR_dirlist:
+          case kXR_locate:
+          case kXR_mkdir:
+          case kXR_mv:
+          case kXR_open:
+          case kXR_rm:
+          case kXR_rmdir:
+          case kXR_stat:
+          case kXR_statm:
+          case kXR_statx:   break;
+          default:          return 1;
+         }
+
+// Bridged and bound links as well as requests without a path run inline
+//
+   if (!Response.isOurs() || Status == XRD_BOUNDPATH
+   ||  !argp || !Request.header.dlen) return 1;
+
+// Get a buffer to hold the request arguments
+//
+   if (!(bp = BPool->Obtain(Request.header.dlen+1))) return 1;
+
+// Check if we can have another request in flight. An open needs a file table
+// slot and we make sure that one is free so that the table need not grow
+// while the link is using it. Workers only add files under our mutex.
+//
+   conMutex.Lock();
+   if (conActive >= as_conreqs)
+      {conMutex.UnLock();
+       BPool->Release(bp);
+       return 1;
+      }
+   if (Request.header.requestid == kXR_open)
+      {if (!FTab) FTab = new XrdXrootdFileTable(Monitor.Did);
+       if (!FTab->Reserve(conActive+1))
+          {conMutex.UnLock();
+           BPool->Release(bp);
+           return 1;
+          }
+      }
+   conActive++;
+   conMutex.UnLock();
+
+// Get a protocol object to act as a worker for this request
+//
+   if (!(wp = ProtStack.Pop())) wp = new XrdXrootdProtocol();
+
+// Copy the session state the request needs. The worker shares the link, the
+// security entity, the file table, and the monitor with us.
+//
+   wp->conParent      = this;
+   wp->Link           = Link;
+   wp->Status         = Status;
+   wp->CapVer         = CapVer;
+   wp->clientPV       = clientPV;
+   wp->rdType         = rdType;
+   wp->Client         = Client;
+   wp->FTab           = FTab;
+   wp->Monitor.Agent  = Monitor.Agent;
+   wp->Monitor.Did    = Monitor.Did;
+   wp->Monitor.Iops   = Monitor.Iops;
+   wp->Monitor.Fops   = Monitor.Fops;
+   wp->ReqID          = ReqID;
+   wp->Response       = Response;
+   memcpy((void *)&wp->Request, (const void *)&Request, sizeof(Request));
+   memcpy(bp->buff, argp->buff, Request.header.dlen+1);
+   wp->argp           = bp;
+   wp->Resume         = &XrdXrootdProtocol::ConRun;
+
+// Keep the link stable until the worker is done and schedule the worker
+//
+   TRACEP(REQ, "req=" <<XProtocol::reqName(Request.header.requestid)
+               <<" dispatched; inflight=" <<conActive);
+   Link->setRef(1);
+   conDisp = true;
+   Sched->Schedule((XrdJob *)wp);
+   return 0;
+}
+
+/******************************************************************************/
+/*                                C o n R u n                                 */
+/******************************************************************************/
+
+// This is invoked via DoIt() on a scheduler thread to execute a request that
+// was handed off by ConReq(). Afterwards the worker recycles itself.
+//
+int XrdXrootdProtocol::ConRun()
+{
+   XrdXrootdProtocol *pp = conParent;
+   XrdLink *lp = Link;
+   long long tBeg = XrdXrootdStats::Clock(), tSnd;
+   int rc;
+
+// Only time spent sending this request's responses counts as send time
+//
+   Response.SendTime(true);
+
+// Process items that keep their own statistics
+//
+   switch(Request.header.requestid)
+         {case kXR_open:    rc = do_Open();   break;
+          case kXR_stat:    rc = do_Stat();   break;
+          default:          SI->Bump(SI->miscCnt);
+                            rc = 0;
+                            break;
+         }
+
+// Now process the remaining requests
+//
+   switch(Request.header.requestid)
+         {case kXR_chmod:   rc = do_Chmod();   break;
+          case kXR_dirlist: rc = do_Dirlist(); break;
+          case kXR_locate:  rc = do_Locate();  break;
+          case kXR_mkdir:   rc = do_Mkdir();   break;
+          case kXR_mv:      rc = do_Mv();      break;
+          case kXR_rm:      rc = do_Rm();      break;
+          case kXR_rmdir:   rc = do_Rmdir();   break;
+          case kXR_statm:   rc = do_Statm();   break;
+          case kXR_statx:   rc = do_Statx();   break;
+          default:          break;
+         }
+
+// Record how long the request took
+//
+   tSnd = Response.SendTime();
+   SI->Latency(Request.header.requestid,
+               XrdXrootdStats::Clock() - tBeg - tSnd, tSnd);
+
+// A fatal error means that the link must go away. Shutting it down will cause
+// the link's own thread to notice and close it.
+//
+   if (rc < 0) lp->Shutdown(true);
+
+// Indicate that this request is no longer in flight
+//
+   pp->conMutex.Lock();
+   pp->conActive--;
+   pp->conMutex.UnLock();
+
+// Recycle ourselves. Nothing we share with the session may be released.
+//
+   if (argp) {BPool->Release(argp); argp = 0;}
+   Monitor.Agent = 0;
+   Monitor.Clear();
+   Reset();
+   ProtStack.Push(&ProtLink);
+
+// Release our hold on the link; the session may now go away
+//
+   lp->setRef(-1);
+   return 0;
+}
+
 /******************************************************************************/
 /*                               g e t D a t a                                */
 /******************************************************************************/
@@ -872,4 +1086,6 @@ void XrdXrootdProtocol::Reset()
    Entity.Reset();
    memset(Stream,  0, sizeof(Stream));
    PrepareCount       = 0;
+   conParent          = 0;
+   conActive          = 0;
 }
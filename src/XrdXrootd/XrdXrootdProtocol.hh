@@ -67,6 +67,7 @@
 class XrdNetSocket;
 class XrdOucEnv;
 class XrdOucErrInfo;
+struct XrdOucIOVec;
 class XrdOucReqID;
 class XrdOucStream;
 class XrdOucTList;
@@ -108,6 +109,8 @@ static int           Configure(char *parms, XrdProtocol_Config *pi);
 
        int           Process2();
 
+       int           ProcReq();
+
        int           ProcSig();
 
        void          Recycle(XrdLink *lp, int consec, const char *reason);
@@ -144,7 +147,8 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_CKsum(char *algT, const char *Path, char *Opaque);
        int   do_Close();
        int   do_Dirlist();
-       int   do_DirStat(XrdSfsDirectory *dp, char *pbuff, char *opaque);
+       int   do_DirStat(XrdSfsDirectory *dp, char *pbuff, char *opaque,
+                        int dlSkip, int dlLeft);
        int   do_Endsess();
        int   do_Getfile();
        int   do_Login();
@@ -166,6 +170,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Qxattr();
        int   do_Read();
        int   do_ReadV();
+       int   do_ReadVSF(XrdOucIOVec *rdVec, int rdVNum, int Quantum);
        int   do_ReadAll(int asyncOK=1);
        int   do_ReadNone(int &retc, int &pathID);
        int   do_Rm();
@@ -173,6 +178,7 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Set();
        int   do_Set_Mon(XrdOucTokenizer &setargs);
        int   do_Stat();
+       int   do_Statm();
        int   do_Statx();
        int   do_Sync();
        int   do_Truncate();
@@ -194,6 +200,10 @@ static int   CheckSum(XrdOucStream *, char **, int);
        void  Cleanup();
 static int   Config(const char *fn);
 static int   ConfigSecurity(XrdOucEnv &xEnv, const char *cfn);
+       int   ConReq();
+       int   ConRun();
+       int   dirCursor(char *bP, int bSz, char *&buff, int &bleft,
+                       int cursor);
        int   fsError(int rc, char opc, XrdOucErrInfo &myError,
                      const char *Path, char *Cgi);
        int   fsOvrld(char opc, const char *Path, char *Cgi);
@@ -306,6 +316,16 @@ static int                 as_force;     // aio to be forced
 static int                 as_noaio;     // aio is disabled
 static int                 as_nosf;      // sendfile is disabled
 static int                 as_syncw;     // writes to be synchronous
+static int                 as_rvfanout;  // Max concurrent slices per readv
+static int                 as_rvminsegs; // Min segments per readv slice
+static int                 as_rvmrggap;  // Max gap for merging readv segments
+static int                 as_rvsfsize;  // Min readv segment size for sendfile
+static int                 as_conreqs;   // Max concurrent requests per link
+static int                 as_stfanout;  // Max concurrent stats per statm
+static int                 as_ramax;     // Max readahead window for a file
+static int                 as_raseq;     // Sequential reads before readahead
+static int                 as_wbmax;     // Write-behind buffer size per file
+static int                 as_wbwait;    // Max msecs data is write-behind
 static int                 maxBuffsz;    // Maximum buffer size we can have
 static int                 maxTransz;    // Maximum transfer size we can have
 static const int           maxRvecsz = 1024;   // Maximum read vector size
@@ -406,6 +426,13 @@ char                       doWriteC;
 unsigned char              rvSeq;
 unsigned char              wvSeq;
 
+// This area is used for requests executed concurrently with others on a link
+//
+XrdSysMutex                conMutex;
+XrdXrootdProtocol         *conParent;   // Session protocol for a worker
+int                        conActive;   // Number of requests in flight
+bool                       conDisp;     // Request was handed to a worker
+
 // Track usage limts.
 //
 static bool                LimitError;  // Indicates that hitting a limit should result in an error response.
@@ -0,0 +1,325 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d R e a d V . c c                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Xrd/XrdScheduler.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdXrootd/XrdXrootdFile.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+struct rvSeg {long long offset;   // Segment offset
+              int       size;     // Segment size
+              int       vix;      // Index of segment in the readv vector
+             };
+
+extern "C"
+{
+int rvSegCmp(const void *a, const void *b)
+{
+   const rvSeg *sa = (const rvSeg *)a, *sb = (const rvSeg *)b;
+
+   if (sa->offset < sb->offset) return -1;
+   if (sa->offset > sb->offset) return  1;
+   return sa->vix - sb->vix;
+}
+}
+}
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdScheduler *XrdXrootdReadV::Sched   = 0;
+int           XrdXrootdReadV::maxFan  = 0;
+int           XrdXrootdReadV::minSegs = 8;
+int           XrdXrootdReadV::mrgGap  = 0;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdXrootdReadV::XrdXrootdReadV(XrdSfsFile *fP, XrdOucIOVec *rdV,
+                               int rdN, int sNum)
+                              : rvDone(0), rvFile(fP), rvVec(rdV), rvRslt(0),
+                                rvSNum(sNum), rvNext(0), rvLeft(sNum),
+                                rvRefs(sNum), rvWait(false), rvFail(false)
+{
+   long long totSZ = 0, segSZ = 0;
+   int i, k = 1;
+
+// Compute the total number of bytes so that we can balance the slices by size
+//
+   for (i = 0; i < rdN; i++) totSZ += rdV[i].size;
+
+// Cut the run so that each slice has about the same number of bytes. Every
+// slice must have at least one segment, whatever the size of the segments.
+//
+   rvSBeg[0] = 0;
+   for (i = 0; i < rdN && k < sNum; i++)
+       {if (i > rvSBeg[k-1] && (segSZ*sNum >= totSZ*k || rdN-i <= sNum-k))
+           rvSBeg[k++] = i;
+        segSZ += rdV[i].size;
+       }
+   rvSBeg[sNum] = rdN;
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+void XrdXrootdReadV::Init(XrdScheduler *sP, int fanout, int minsegs,
+                          int mrggap)
+{
+   Sched   = sP;
+   maxFan  = (fanout > maxSlices ? maxSlices : fanout);
+   if (minsegs > 0) minSegs = minsegs;
+   mrgGap  = mrggap;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+XrdSfsXferSize XrdXrootdReadV::Read(XrdXrootdFile *fP, XrdOucIOVec *rdV,
+                                    int rdN)
+{
+// Merge nearby segments if so wanted, otherwise just issue the readv
+//
+   if (mrgGap > 0 && rdN > 1) return Merge(fP, rdV, rdN);
+   return Issue(fP->XrdSfsp, rdV, rdN);
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 I s s u e                                  */
+/******************************************************************************/
+
+XrdSfsXferSize XrdXrootdReadV::Issue(XrdSfsFile *fP, XrdOucIOVec *rdV, int rdN)
+{
+   XrdXrootdReadV *rvP;
+   XrdSfsXferSize  rdAmt;
+   int i, sNum = rdN / minSegs;
+
+// Avoid all of the overhead when the run is too small to be split up
+//
+   if (sNum > maxFan) sNum = maxFan;
+   if (sNum < 2) return fP->readv(rdV, rdN);
+
+// Get a new readv object and schedule the helpers. Helpers that find nothing
+// left to do simply drop their reference to the object.
+//
+   rvP = new XrdXrootdReadV(fP, rdV, rdN, sNum);
+   for (i = 1; i < sNum; i++)
+       {rvP->rvHelp[i].rvP = rvP;
+        Sched->Schedule(&rvP->rvHelp[i]);
+       }
+
+// Run slices ourselves until there are no more to be claimed
+//
+   while(rvP->RunSlice()) {}
+
+// Wait for any slices that helpers are still working on
+//
+   rvP->rvMutex.Lock();
+   if (rvP->rvLeft)
+      {rvP->rvWait = true;
+       rvP->rvMutex.UnLock();
+       rvP->rvDone.Wait();
+      } else rvP->rvMutex.UnLock();
+
+// Capture the result before dropping our reference
+//
+   rdAmt = (rvP->rvFail ? -1 : rvP->rvRslt);
+   rvP->Release();
+
+// If anything went wrong, redo the whole run serially so that the error
+// information reflects a single failure.
+//
+   if (rdAmt < 0) return fP->readv(rdV, rdN);
+   return rdAmt;
+}
+
+/******************************************************************************/
+/*                                 M e r g e                                  */
+/******************************************************************************/
+
+XrdSfsXferSize XrdXrootdReadV::Merge(XrdXrootdFile *fP, XrdOucIOVec *rdV,
+                                     int rdN)
+{
+   rvSeg *sVec;
+   XrdOucIOVec *mVec;
+   char *mBuff = 0, *bP;
+   long long rqSZ = 0, rdSZ = 0, bfSZ = 0, mEnd, sEnd;
+   int i, j, k, mBeg, mNum = 0;
+
+// Sort the segments by offset. Segments with the same offset keep their order.
+//
+   sVec = new rvSeg[rdN];
+   for (i = 0; i < rdN; i++)
+       {sVec[i].offset = rdV[i].offset;
+        sVec[i].size   = rdV[i].size;
+        sVec[i].vix    = i;
+        rqSZ += rdV[i].size;
+       }
+   qsort(sVec, rdN, sizeof(rvSeg), rvSegCmp);
+
+// Coalesce segments into ranges. A segment joins the current range when it
+// starts less than mrgGap bytes past the range's end (overlapping segments
+// always join). The info field records the sorted index of a range's first
+// segment and the temporary buffer is sized for ranges with several segments.
+//
+   mVec = new XrdOucIOVec[rdN];
+   i = 0;
+   while(i < rdN)
+        {mBeg = i; mEnd = sVec[i].offset + sVec[i].size;
+         for (i++; i < rdN && sVec[i].offset - mEnd < mrgGap; i++)
+             {sEnd = sVec[i].offset + sVec[i].size;
+              if (sEnd > mEnd)
+                 {if (sEnd - sVec[mBeg].offset > 0x7fffffffLL) break;
+                  mEnd = sEnd;
+                 }
+             }
+         mVec[mNum].offset = sVec[mBeg].offset;
+         mVec[mNum].size   = static_cast<int>(mEnd - sVec[mBeg].offset);
+         mVec[mNum].info   = mBeg;
+         mVec[mNum].data   = rdV[sVec[mBeg].vix].data;
+         if (i - mBeg > 1) bfSZ += mVec[mNum].size;
+         rdSZ += mVec[mNum].size;
+         mNum++;
+        }
+
+// Record what we did
+//
+   fP->Stats.rmOps(rdN, mNum, rqSZ, rdSZ);
+
+// If nothing could be merged we simply issue the reads in offset order
+//
+   if (mNum == rdN)
+      {for (i = 0; i < rdN; i++) mVec[i] = rdV[sVec[i].vix];
+       rdSZ = Issue(fP->XrdSfsp, mVec, rdN);
+       delete [] mVec; delete [] sVec;
+       if (rdSZ == rqSZ) return rdSZ;
+       return fP->XrdSfsp->readv(rdV, rdN);
+      }
+
+// Point multi-segment ranges into the temporary buffer
+//
+   if (bfSZ && !(mBuff = (char *)malloc(bfSZ)))
+      {delete [] mVec; delete [] sVec;
+       return Issue(fP->XrdSfsp, rdV, rdN);
+      }
+   bP = mBuff;
+   for (k = 0; k < mNum; k++)
+       {j = (k+1 < mNum ? mVec[k+1].info : rdN);
+        if (j - mVec[k].info > 1) {mVec[k].data = bP; bP += mVec[k].size;}
+       }
+
+// Read the ranges. Upon any failure reissue the original request serially.
+//
+   if (Issue(fP->XrdSfsp, mVec, mNum) != rdSZ)
+      {if (mBuff) free(mBuff);
+       delete [] mVec; delete [] sVec;
+       return fP->XrdSfsp->readv(rdV, rdN);
+      }
+
+// Scatter the data of multi-segment ranges to the segments' buffers
+//
+   for (k = 0; k < mNum; k++)
+       {j = (k+1 < mNum ? mVec[k+1].info : rdN);
+        if (j - mVec[k].info < 2) continue;
+        for (i = mVec[k].info; i < j; i++)
+            memcpy(rdV[sVec[i].vix].data,
+                   mVec[k].data + (sVec[i].offset - mVec[k].offset),
+                   sVec[i].size);
+       }
+
+// All done
+//
+   if (mBuff) free(mBuff);
+   delete [] mVec; delete [] sVec;
+   return rqSZ;
+}
+
+/******************************************************************************/
+/*                               R e l e a s e                                */
+/******************************************************************************/
+
+void XrdXrootdReadV::Release()
+{
+   bool isLast;
+
+// Drop a reference and delete the object when it was the last one
+//
+   rvMutex.Lock();
+   isLast = (--rvRefs == 0);
+   rvMutex.UnLock();
+   if (isLast) delete this;
+}
+
+/******************************************************************************/
+/*                              R u n S l i c e                               */
+/******************************************************************************/
+
+bool XrdXrootdReadV::RunSlice()
+{
+   XrdSfsXferSize rdAmt, rdExp = 0;
+   int i, sBeg, sEnd;
+
+// Claim the next slice, if any
+//
+   rvMutex.Lock();
+   if (rvNext >= rvSNum) {rvMutex.UnLock(); return false;}
+   i = rvNext++;
+   rvMutex.UnLock();
+
+// Read the slice
+//
+   sBeg = rvSBeg[i]; sEnd = rvSBeg[i+1];
+   for (i = sBeg; i < sEnd; i++) rdExp += rvVec[i].size;
+   rdAmt = rvFile->readv(&rvVec[sBeg], sEnd-sBeg);
+
+// Account for the slice and wake up the caller if this was the last one
+//
+   rvMutex.Lock();
+   if (rdAmt != rdExp) rvFail = true;
+      else rvRslt += rdAmt;
+   if (!(--rvLeft) && rvWait) rvDone.Post();
+   rvMutex.UnLock();
+   return true;
+}
@@ -0,0 +1,105 @@
+#ifndef __XRDXROOTDREADV_HH_
+#define __XRDXROOTDREADV_HH_
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d R e a d V . h h                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "Xrd/XrdJob.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdScheduler;
+class XrdXrootdFile;
+
+// XrdXrootdReadV optionally merges nearby segments of a readv run that refers
+// to a single file and then splits the run into slices that are issued
+// concurrently. The slices are handed out to
+// scheduler threads as well as to the calling thread, so the request always
+// completes even when no scheduler thread is available. Each slice reads into
+// the buffer locations that were preassigned by the caller; hence, the caller
+// assembles the response exactly as it would for a serial readv.
+//
+class XrdXrootdReadV
+{
+public:
+
+// Read() performs the readv and returns the total number of bytes read. When
+// merging is enabled, segments are sorted by offset and those separated by
+// less than the merge gap are read as a single range whose contents are then
+// copied to each segment's buffer. The resulting reads are issued in up to
+// maxFan concurrent slices of at least minSegs reads each. Should anything
+// fail or come up short, the whole run is reissued serially and that result
+// is returned so that the file's error information is set by a single thread.
+//
+static XrdSfsXferSize Read(XrdXrootdFile *fP, XrdOucIOVec *rdV, int rdN);
+
+static void           Init(XrdScheduler *sP, int fanout, int minsegs,
+                           int mrggap);
+
+static const int      maxSlices = 16;
+
+private:
+
+       XrdXrootdReadV(XrdSfsFile *fP, XrdOucIOVec *rdV, int rdN, int sNum);
+      ~XrdXrootdReadV() {}
+
+class rvJob : public XrdJob
+     {public:
+      void DoIt() {while(rvP->RunSlice()) {} rvP->Release();}
+
+           rvJob() : XrdJob("readv slice"), rvP(0) {}
+          ~rvJob() {}
+
+      XrdXrootdReadV *rvP;
+     };
+
+static XrdSfsXferSize Issue(XrdSfsFile *fP, XrdOucIOVec *rdV, int rdN);
+static XrdSfsXferSize Merge(XrdXrootdFile *fP, XrdOucIOVec *rdV, int rdN);
+       void           Release();
+       bool           RunSlice();
+
+static XrdScheduler  *Sched;
+static int            maxFan;
+static int            minSegs;
+static int            mrgGap;
+
+XrdSysMutex           rvMutex;
+XrdSysSemaphore       rvDone;
+XrdSfsFile           *rvFile;
+XrdOucIOVec          *rvVec;
+XrdSfsXferSize        rvRslt;
+rvJob                 rvHelp[maxSlices];
+int                   rvSBeg[maxSlices+1];  // First segment of each slice
+int                   rvSNum;               // Number of slices
+int                   rvNext;               // Next slice to be claimed
+int                   rvLeft;               // Slices not yet completed
+int                   rvRefs;               // Helpers plus the caller
+bool                  rvWait;               // Caller waits for completion
+bool                  rvFail;               // A slice failed or was short
+};
+#endif
@@ -34,6 +34,7 @@
 
 #include "Xrd/XrdLink.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
+#include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdTransit.hh"
   
@@ -51,6 +52,26 @@ const char *XrdXrootdResponse::TraceID = "Response";
 
 #define TRACELINK Link
 
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+// Add the time spent sending a response to the response's send time
+//
+class sendTimer
+{
+public:
+      sendTimer(long long &tacc) : tAcc(tacc), tBeg(XrdXrootdStats::Clock()) {}
+     ~sendTimer() {tAcc += XrdXrootdStats::Clock() - tBeg;}
+
+private:
+long long &tAcc;
+long long  tBeg;
+};
+}
+
 /******************************************************************************/
 /*                                  S e n d                                   */
 /******************************************************************************/
@@ -69,6 +90,7 @@ int XrdXrootdResponse::Send()
     Resp.status = isOK;
     Resp.dlen   = 0;
 
+    sendTimer sTime(sndTime);
     if (Link->Send((char *)&Resp, sizeof(Resp)) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -93,6 +115,7 @@ int XrdXrootdResponse::Send(const char *msg)
     Resp.status        = isOK;
     Resp.dlen          = static_cast<kXR_int32>(htonl(RespIO[1].iov_len));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(RespIO, 2, sizeof(Resp) + RespIO[1].iov_len) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -116,6 +139,7 @@ int XrdXrootdResponse::Send(XResponseType rcode, void *data, int dlen)
     Resp.status        = static_cast<kXR_unt16>(htons(rcode));
     Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(RespIO, 2, sizeof(Resp) + dlen) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -142,6 +166,7 @@ int XrdXrootdResponse::Send(XResponseType rcode,
     Resp.status        = static_cast<kXR_unt16>(htons(rcode));
     Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(IOResp, iornum, sizeof(Resp) + dlen) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -170,6 +195,7 @@ int XrdXrootdResponse::Send(XResponseType rcode, int info,
     Resp.status        = static_cast<kXR_unt16>(htons(rcode));
     Resp.dlen          = static_cast<kXR_int32>(htonl((dlen+sizeof(xbuf))));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(RespIO, 3, sizeof(Resp) + dlen + sizeof(xbuf)) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -194,6 +220,7 @@ int XrdXrootdResponse::Send(void *data, int dlen)
     Resp.status        = isOK;
     Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(RespIO, 2, sizeof(Resp) + dlen) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -221,6 +248,7 @@ int XrdXrootdResponse::Send(struct iovec *IOResp, int iornum, int iolen)
     Resp.status        = isOK;
     Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(IOResp, iornum, sizeof(Resp) + dlen) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -249,6 +277,7 @@ int XrdXrootdResponse::Send(XErrorCode ecode, const char *msg)
     Resp.status        = static_cast<kXR_unt16>(htons(kXR_error));
     Resp.dlen          = static_cast<kXR_int32>(htonl(dlen));
 
+    sendTimer sTime(sndTime);
     if (Link->Send(RespIO, 3, sizeof(Resp) + dlen) < 0)
        return Link->setEtext("send failure");
     return 0;
@@ -284,6 +313,7 @@ int XrdXrootdResponse::Send(int fdnum, long long offset, int dlen)
 
 // Send off the request
 //
+    sendTimer sTime(sndTime);
     if (Link->Send(myVec, 2) < 0)
        return Link->setEtext("sendfile failure");
     return 0;
@@ -293,18 +323,27 @@ int XrdXrootdResponse::Send(int fdnum, long long offset, int dlen)
 
 int XrdXrootdResponse::Send(XrdOucSFVec *sfvec, int sfvnum, int dlen)
 {
-   static kXR_unt16 isOK = static_cast<kXR_unt16>(htons(kXR_ok));
+   return Send(kXR_ok, sfvec, sfvnum, dlen);
+}
 
-   TRACES(RSP, "sendfile " <<dlen <<" data bytes");
+/******************************************************************************/
 
+int XrdXrootdResponse::Send(XResponseType rcode,
+                            XrdOucSFVec *sfvec, int sfvnum, int dlen)
+{
+
+   TRACES(RSP, "sendfile " <<dlen <<" data bytes; status=" <<rcode);
+
+// The bridge only handles complete responses
+//
    if (Bridge)
-      {if (Bridge->Send(sfvec, sfvnum, dlen) >= 0) return 0;
+      {if (rcode == kXR_ok && Bridge->Send(sfvec, sfvnum, dlen) >= 0) return 0;
        return Link->setEtext("send failure");
       }
 
 // We are only called should sendfile be enabled for this response
 //
-   Resp.status = isOK;
+   Resp.status = static_cast<kXR_unt16>(htons(rcode));
    Resp.dlen   = static_cast<kXR_int32>(htonl(dlen));
    sfvec[0].buffer = (char *)&Resp;
    sfvec[0].sendsz = sizeof(Resp);
@@ -312,6 +351,7 @@ int XrdXrootdResponse::Send(XrdOucSFVec *sfvec, int sfvnum, int dlen)
 
 // Send off the request
 //
+    sendTimer sTime(sndTime);
     if (Link->Send(sfvec, sfvnum) < 0)
        return Link->setEtext("sendfile failure");
     return 0;
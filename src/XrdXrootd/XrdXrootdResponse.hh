@@ -62,9 +62,20 @@ const  char *ID() {return (const char *)trsid;}
        int   Send(XResponseType rcode, int info, const char *data, int dsz=-1);
        int   Send(int fdnum, long long offset, int dlen);
        int   Send(XrdOucSFVec *sfvec, int sfvnum, int dlen);
+       int   Send(XResponseType rcode, XrdOucSFVec *sfvec, int sfvnum,
+                  int dlen);
 static int   Send(XrdXrootdReqID &ReqID,  XResponseType Status,
                   struct iovec   *IOResp, int           iornum, int  iolen);
 
+// Return the nanoseconds spent sending responses, optionally restarting the
+// count (request latencies are split into execution and send times).
+//
+inline long long SendTime(bool reset=false)
+                         {long long t = sndTime;
+                          if (reset) sndTime = 0;
+                          return t;
+                         }
+
 inline void  Set(XrdLink *lp) {Link = lp;}
 inline void  Set(XrdXrootdTransit *tp) {Bridge = tp;}
        void  Set(kXR_char *stream);
@@ -79,9 +90,11 @@ inline void  Set(XrdXrootdTransit *tp) {Bridge = tp;}
        XrdXrootdResponse(XrdXrootdResponse &rhs) {Set(rhs.Link);
                                                   Set(rhs.Bridge);
                                                   Set(rhs.Resp.streamid);
+                                                  sndTime = 0;
                                                  }
 
        XrdXrootdResponse() {Link = 0; Bridge = 0; *trsid = '\0';
+                          sndTime = 0;
                           RespIO[0].iov_base = (caddr_t)&Resp;
                           RespIO[0].iov_len  = sizeof(Resp);
                          }
@@ -99,6 +112,7 @@ private:
        XrdXrootdTransit    *Bridge;
        ServerResponseHeader Resp;
        XrdLink             *Link;
+       long long            sndTime;
 struct iovec                RespIO[3];
 
        char                 trsid[8];  // sizeof() does not work here
@@ -0,0 +1,192 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d S t a t m . c c                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Xrd/XrdScheduler.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdXrootd/XrdXrootdStatm.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdScheduler *XrdXrootdStatm::Sched  = 0;
+int           XrdXrootdStatm::maxFan = 1;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdXrootdStatm::XrdXrootdStatm(XrdSfsFileSystem *fsP,
+                               const XrdSecEntity *client,
+                               const char *tident, const char *cksT,
+                               Item *iV, int iN, int hNum)
+                              : smDone(0), smFS(fsP), smClient(client),
+                                smTID(tident), smCksT(cksT), smVec(iV),
+                                smNum(iN), smNext(0), smLeft(iN),
+                                smRefs(hNum+1), smWait(false)
+{}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+void XrdXrootdStatm::Init(XrdScheduler *sP, int fanout)
+{
+   Sched  = sP;
+   maxFan = (fanout > maxFanout ? maxFanout : fanout);
+}
+
+/******************************************************************************/
+/*                                  S t a t                                   */
+/******************************************************************************/
+
+void XrdXrootdStatm::Stat(XrdSfsFileSystem *fsP, const XrdSecEntity *client,
+                          const char *tident, const char *cksT,
+                          Item *iV, int iN)
+{
+   XrdXrootdStatm *smP;
+   int i, hNum = iN / minPaths;
+
+// Determine how many helpers we need. The caller is always one of them.
+//
+   if (hNum > maxFan) hNum = maxFan;
+   hNum = (Sched && hNum > 1 ? hNum-1 : 0);
+
+// Get a new object and schedule the helpers. Helpers that find nothing left
+// to do simply drop their reference to the object.
+//
+   smP = new XrdXrootdStatm(fsP, client, tident, cksT, iV, iN, hNum);
+   for (i = 0; i < hNum; i++)
+       {smP->smHelp[i].smP = smP;
+        Sched->Schedule(&smP->smHelp[i]);
+       }
+
+// Stat paths ourselves until there are no more to be claimed
+//
+   while(smP->StatNext()) {}
+
+// Wait for any paths that helpers are still working on
+//
+   smP->smMutex.Lock();
+   if (smP->smLeft)
+      {smP->smWait = true;
+       smP->smMutex.UnLock();
+       smP->smDone.Wait();
+      } else smP->smMutex.UnLock();
+
+// Drop our reference; the item vector now holds all of the results
+//
+   smP->Release();
+}
+
+/******************************************************************************/
+/* Private:                           R e l e a s e                           */
+/******************************************************************************/
+
+void XrdXrootdStatm::Release()
+{
+   bool isLast;
+
+// Drop a reference and delete the object when it was the last one
+//
+   smMutex.Lock();
+   isLast = (--smRefs == 0);
+   smMutex.UnLock();
+   if (isLast) delete this;
+}
+
+/******************************************************************************/
+/* Private:                          S t a t N e x t                          */
+/******************************************************************************/
+
+bool XrdXrootdStatm::StatNext()
+{
+   int i;
+
+// Claim the next path, if any
+//
+   smMutex.Lock();
+   if (smNext >= smNum) {smMutex.UnLock(); return false;}
+   i = smNext++;
+   smMutex.UnLock();
+
+// Stat the path
+//
+   StatOne(smVec[i]);
+
+// Account for the path and wake up the caller if this was the last one
+//
+   smMutex.Lock();
+   if (!(--smLeft) && smWait) smDone.Post();
+   smMutex.UnLock();
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                           S t a t O n e                           */
+/******************************************************************************/
+
+void XrdXrootdStatm::StatOne(Item &item)
+{
+   XrdOucErrInfo myError(smTID);
+   const char *csData;
+   int rc;
+
+// Skip paths that were rejected by the caller
+//
+   if (item.rc) return;
+
+// Stat the path. There is no callback object so the request cannot be
+// deferred. Anything other than success or a plain error (e.g. a redirect
+// or a stall) can't be reflected in the response and is reported as such.
+//
+   rc = smFS->stat(item.path, &item.sbuf, myError, smClient, item.opaque);
+   if (rc != SFS_OK)
+      {item.rc = (rc == SFS_ERROR ? XProtocol::mapError(myError.getErrInfo())
+                                  : kXR_ServerError);
+       return;
+      }
+
+// Obtain the stored checksum for files, if wanted. Checksums are never
+// computed here; a missing checksum is simply omitted from the response.
+//
+   if (smCksT && S_ISREG(item.sbuf.st_mode))
+      {XrdOucErrInfo ckError(smTID);
+       if (smFS->chksum(XrdSfsFileSystem::csGet, smCksT, item.path,
+                        ckError, smClient, item.opaque) == SFS_OK)
+          {csData = ckError.getErrText();
+           if (*csData && *csData != '!') item.cksum = strdup(csData);
+          }
+      }
+}
@@ -0,0 +1,111 @@
+#ifndef __XRDXROOTDSTATM_HH_
+#define __XRDXROOTDSTATM_HH_
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d S t a t m . h h                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include "Xrd/XrdJob.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdScheduler;
+class XrdSecEntity;
+class XrdSfsFileSystem;
+
+// XrdXrootdStatm performs the stat calls for a kXR_statm request. The paths
+// are handed out one at a time to scheduler threads as well as to the calling
+// thread, so the request always completes even when no scheduler thread is
+// available. Results are placed in the caller's item vector, in path order.
+//
+class XrdXrootdStatm
+{
+public:
+
+struct Item {char        *path;    // Path to be stat'ed (cgi removed)
+             char        *opaque;  // Its cgi, if any
+             char        *cksum;   // Checksum text (strdup'd), if any
+             int          rc;      // 0 or the kXR error code for the path
+             struct stat  sbuf;    // The stat information when rc is zero
+
+             Item() : path(0), opaque(0), cksum(0), rc(0) {}
+            ~Item() {if (cksum) free(cksum);}
+            };
+
+// Stat() stats each item whose rc is zero and, when cksT is not null, also
+// obtains the locally stored checksum of that type for regular files. Items
+// are processed by up to maxFan threads with at least minPaths items each.
+//
+static void Stat(XrdSfsFileSystem *fsP, const XrdSecEntity *client,
+                 const char *tident, const char *cksT, Item *iV, int iN);
+
+static void Init(XrdScheduler *sP, int fanout);
+
+static const int maxFanout = 16;
+static const int minPaths  = 4;
+
+private:
+
+       XrdXrootdStatm(XrdSfsFileSystem *fsP, const XrdSecEntity *client,
+                      const char *tident, const char *cksT,
+                      Item *iV, int iN, int hNum);
+      ~XrdXrootdStatm() {}
+
+class smJob : public XrdJob
+     {public:
+      void DoIt() {while(smP->StatNext()) {} smP->Release();}
+
+           smJob() : XrdJob("statm helper"), smP(0) {}
+          ~smJob() {}
+
+      XrdXrootdStatm *smP;
+     };
+
+       void           Release();
+       void           StatOne(Item &item);
+       bool           StatNext();
+
+static XrdScheduler  *Sched;
+static int            maxFan;
+
+XrdSysMutex           smMutex;
+XrdSysSemaphore       smDone;
+XrdSfsFileSystem     *smFS;
+const XrdSecEntity   *smClient;
+const char           *smTID;
+const char           *smCksT;
+Item                 *smVec;
+smJob                 smHelp[maxFanout];
+int                   smNum;                // Number of items
+int                   smNext;               // Next item to be claimed
+int                   smLeft;               // Items not yet completed
+int                   smRefs;               // Helpers plus the caller
+bool                  smWait;               // Caller waits for completion
+};
+#endif
@@ -28,11 +28,82 @@
 /******************************************************************************/
  
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
   
 #include "Xrd/XrdStats.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysPlatform.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// Each thread records request latencies into its own histogram set. Phase 0
+// is the time taken to execute the request and phase 1 the time taken to send
+// the response(s). All values are in microseconds.
+//
+class XrdXrootdLatHist
+{
+public:
+
+XrdXrootdLatHist *next;
+XrdXrootdStats   *owner;
+long long         Num[XrdXrootdStats::latReqs];
+long long         Sum[XrdXrootdStats::latReqs][2];
+long long         Max[XrdXrootdStats::latReqs][2];
+unsigned int      Bkt[XrdXrootdStats::latReqs][2][XrdXrootdStats::latBkts];
+
+void              Add(XrdXrootdLatHist &rhs)
+                     {for (int i = 0; i < XrdXrootdStats::latReqs; i++)
+                          {Num[i] += rhs.Num[i];
+                           for (int j = 0; j < 2; j++)
+                               {Sum[i][j] += rhs.Sum[i][j];
+                                if (rhs.Max[i][j] > Max[i][j])
+                                   Max[i][j] = rhs.Max[i][j];
+                                for (int k = 0; k < XrdXrootdStats::latBkts; k++)
+                                    Bkt[i][j][k] += rhs.Bkt[i][j][k];
+                               }
+                          }
+                     }
+
+                  XrdXrootdLatHist(XrdXrootdStats *oP) : next(0), owner(oP)
+                                  {memset(Num, 0, sizeof(Num));
+                                   memset(Sum, 0, sizeof(Sum));
+                                   memset(Max, 0, sizeof(Max));
+                                   memset(Bkt, 0, sizeof(Bkt));
+                                  }
+                 ~XrdXrootdLatHist() {}
+};
+
+namespace
+{
+// Return the bucket for a microsecond value. Values below 4 have their own
+// bucket, the rest fall into one of four buckets per power of two.
+//
+int latIndex(long long us)
+{
+   int e;
+
+   if (us < 4) return (us < 0 ? 0 : static_cast<int>(us));
+   e = 63 - __builtin_clzll(us);
+   if (e > 27) return XrdXrootdStats::latBkts-1;
+   return 4 + (e-2)*4 + static_cast<int>((us >> (e-2)) & 3);
+}
+
+// Return the highest value that falls into a bucket
+//
+long long latValue(int bkt)
+{
+   int e, s;
+
+   if (bkt < 4) return bkt;
+   e = (bkt-4)/4 + 2; s = (bkt-4)%4;
+   return (static_cast<long long>(5+s) << (e-2)) - 1;
+}
+}
  
 /******************************************************************************/
 /*                           C o n s t r c u t o r                            */
@@ -43,6 +114,9 @@ XrdXrootdStats::XrdXrootdStats(XrdStats *sp)
 
 xstats   = sp;
 fsP      = 0;
+latList  = 0;
+latGone  = new XrdXrootdLatHist(this);
+pthread_key_create(&latKey, latDrop);
 
 Count    = 0;     // Stats: Number of matches
 errorCnt = 0;     // Stats: Number of errors returned
@@ -74,6 +148,129 @@ badSCnt  = 0;     // Stats: Number of signature failures
 ignSCnt  = 0;     // Stats: Number of signature ignored
 }
 
+/******************************************************************************/
+/*                               L a t e n c y                                */
+/******************************************************************************/
+
+void XrdXrootdStats::Latency(kXR_unt16 reqID, long long exeNS, long long sndNS)
+{
+   XrdXrootdLatHist *hP;
+   long long tVal[2] = {exeNS/1000, sndNS/1000};
+   int rX = reqID - kXR_auth;
+
+// Ignore anything that is not a valid request
+//
+   if (rX < 0 || rX >= latReqs) return;
+
+// Get this thread's histograms, creating them on first use
+//
+   if (!(hP = static_cast<XrdXrootdLatHist *>(pthread_getspecific(latKey))))
+      {hP = new XrdXrootdLatHist(this);
+       pthread_setspecific(latKey, hP);
+       latMutex.Lock();
+       hP->next = latList;
+       latList  = hP;
+       latMutex.UnLock();
+      }
+
+// Record the times. Only this thread ever updates these histograms.
+//
+   hP->Num[rX]++;
+   for (int i = 0; i < 2; i++)
+       {hP->Sum[rX][i] += tVal[i];
+        if (tVal[i] > hP->Max[rX][i]) hP->Max[rX][i] = tVal[i];
+        hP->Bkt[rX][i][latIndex(tVal[i])]++;
+       }
+}
+
+/******************************************************************************/
+/* Private:                        l a t D r o p                              */
+/******************************************************************************/
+
+void XrdXrootdStats::latDrop(void *histP)
+{
+   XrdXrootdLatHist *pP, *hP = static_cast<XrdXrootdLatHist *>(histP);
+   XrdXrootdStats   *sP = hP->owner;
+
+// Remove the histograms from the list and keep their counts
+//
+   sP->latMutex.Lock();
+   if (sP->latList == hP) sP->latList = hP->next;
+      else {pP = sP->latList;
+            while(pP && pP->next != hP) pP = pP->next;
+            if (pP) pP->next = hP->next;
+           }
+   sP->latGone->Add(*hP);
+   sP->latMutex.UnLock();
+   delete hP;
+}
+
+/******************************************************************************/
+/* Private:                       l a t S t a t s                             */
+/******************************************************************************/
+
+int XrdXrootdStats::latStats(char *buff, int blen)
+{
+   static const char reqfmt[] = "<req id=\"%s\"><n>%lld</n>";
+   static const char phsfmt[] = "<%s><avg>%lld</avg><p50>%lld</p50>"
+                                "<p90>%lld</p90><p99>%lld</p99>"
+                                "<max>%lld</max></%s>";
+   static const char *phsName[2] = {"exe", "snd"};
+   static const long long LLMax = 0x7fffffffffffffffLL;
+   static const int pctV[3] = {50, 90, 99};
+   XrdXrootdLatHist *hP, *tP;
+   long long pVal[3], Cnt, Num;
+   int len, n;
+
+// If no buffer, caller wants the maximum size we will generate
+//
+   if (!buff)
+      {char dummy[1024];
+       len = snprintf(dummy, sizeof(dummy), reqfmt, "longestname", LLMax);
+       for (int i = 0; i < 2; i++)
+           len += snprintf(dummy, sizeof(dummy), phsfmt, phsName[i],
+                           LLMax, LLMax, LLMax, LLMax, LLMax, phsName[i]);
+       return (len + 6)*latReqs + 11;
+      }
+
+// Sum up the histograms of all the threads
+//
+   tP = new XrdXrootdLatHist(this);
+   latMutex.Lock();
+   tP->Add(*latGone);
+   hP = latList;
+   while(hP) {tP->Add(*hP); hP = hP->next;}
+   latMutex.UnLock();
+
+// Format each request type that has been seen
+//
+   len = snprintf(buff, blen, "<lat>");
+   for (int i = 0; i < latReqs && len < blen; i++)
+       {if (!(Num = tP->Num[i])) continue;
+        len += snprintf(buff+len, blen-len, reqfmt,
+                        XProtocol::reqName(i+kXR_auth), Num);
+        for (int j = 0; j < 2 && len < blen; j++)
+            {Cnt = 0; n = 0;
+             pVal[0] = pVal[1] = pVal[2] = tP->Max[i][j];
+             for (int k = 0; k < latBkts && n < 3; k++)
+                 {Cnt += tP->Bkt[i][j][k];
+                  while(n < 3 && Cnt*100 >= Num*pctV[n])
+                       {pVal[n] = latValue(k);
+                        if (pVal[n] > tP->Max[i][j]) pVal[n] = tP->Max[i][j];
+                        n++;
+                       }
+                 }
+             len += snprintf(buff+len, blen-len, phsfmt, phsName[j],
+                             tP->Sum[i][j]/Num, pVal[0], pVal[1], pVal[2],
+                             tP->Max[i][j], phsName[j]);
+            }
+        if (len < blen) len += snprintf(buff+len, blen-len, "</req>");
+       }
+   if (len < blen) len += snprintf(buff+len, blen-len, "</lat>");
+   delete tP;
+   return (len < blen ? len : blen-1);
+}
+ 
 /******************************************************************************/
 /*                                 S t a t s                                  */
 /******************************************************************************/
@@ -88,7 +285,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
    "<sig><ok>%d</ok><bad>%d</bad><ign>%d</ign></sig>"
    "<aio><num>%lld</num><max>%d</max><rej>%lld</rej></aio>"
    "<err>%d</err><rdr>%lld</rdr><dly>%d</dly>"
-   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn></stats>";
+   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn>";
 //                                   1 2 3 4 5 6 7 8
    static const long long LLMax = 0x7fffffffffffffffLL;
    static const int       INMax = 0x7fffffff;
@@ -105,7 +302,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                       INMax, INMax, INMax,
                       LLMax, INMax, LLMax, INMax, LLMax, INMax,
                       INMax, INMax, INMax, INMax);
-       return len + (fsP ? fsP->getStats(0,0) : 0);
+       return len + latStats(0,0) + 8 + (fsP ? fsP->getStats(0,0) : 0);
       }
 
 // Format our statistics
@@ -121,6 +318,12 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                   LoginAT, AuthBad, LoginAU, LoginUA);
    statsMutex.UnLock();
 
+// Add the request latencies and close off our statistics
+//
+   if (len < blen) len += latStats(buff+len, blen-len);
+   if (len < blen) len += strlcpy(buff+len, "</stats>", blen-len);
+   if (len >= blen) len = blen-1;
+
 // Now include filesystem statistics and return
 //
    if (fsP) len += fsP->getStats(buff+len, blen-len);
@@ -143,6 +346,7 @@ int XrdXrootdStats::Stats(XrdXrootdResponse &resp, const char *opts)
          };
     statsInfo statsResp(&resp);
     int xopts = 0;
+    bool latOnly = false;
 
     while(*opts)
          {switch(*opts)
@@ -154,11 +358,27 @@ int XrdXrootdStats::Stats(XrdXrootdResponse &resp, const char *opts)
                  case 'u': xopts |= XRD_STATS_PROC; break;    // u_sage
                  case 'p': xopts |= XRD_STATS_PROT; break;    // p_rotocol
                  case 's': xopts |= XRD_STATS_SCHD; break;    // s_scheduler
+                 case 'r': latOnly = true;          break;    // r_equests
                  default:  break;
                 }
           opts++;
          }
 
+// Request latencies are sent on their own, ahead of any other statistics
+//
+    if (latOnly)
+       {char *lbuff;
+        int lblen = latStats(0,0) + 32, llen, rc;
+        if (!(lbuff = (char *)malloc(lblen)))
+           return resp.Send(kXR_NoMemory, "Insufficient memory for stats");
+        llen  = snprintf(lbuff, lblen, "<stats id=\"xrootd\">");
+        llen += latStats(lbuff+llen, lblen-llen);
+        llen += snprintf(lbuff+llen, lblen-llen, "</stats>");
+        rc = resp.Send((xopts ? kXR_oksofar : kXR_ok), lbuff, llen+(xopts ? 0:1));
+        free(lbuff);
+        if (rc || !xopts) return rc;
+       }
+
     if (!xopts) return resp.Send();
 
     xstats->Stats(&statsResp, xopts);
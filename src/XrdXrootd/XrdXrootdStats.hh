@@ -29,11 +29,16 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <pthread.h>
+#include <time.h>
+
+#include "XProtocol/XProtocol.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdOuc/XrdOucStats.hh"
 
 class XrdSfsFileSystem;
 class XrdStats;
+class XrdXrootdLatHist;
 class XrdXrootdResponse;
 
 class XrdXrootdStats : public XrdOucStats
@@ -68,17 +73,43 @@ int              aokSCnt;      // Stats: Number of signature successes
 int              badSCnt;      // Stats: Number of signature failures
 int              ignSCnt;      // Stats: Number of signature ignored
 
+// Return a monotonic time stamp in nanoseconds, used to time requests.
+//
+static long long Clock() {struct timespec ts;
+                          clock_gettime(CLOCK_MONOTONIC, &ts);
+                          return ts.tv_sec*1000000000LL + ts.tv_nsec;
+                         }
+
+// Latency() records the time a request took to execute and the time spent
+// sending its response(s). Each thread records into its own histograms so
+// that no lock is needed; they are only summed when reported.
+//
+void             Latency(kXR_unt16 reqID, long long exeNS, long long sndNS);
+
 void             setFS(XrdSfsFileSystem *fsp) {fsP = fsp;}
 
 int              Stats(char *buff, int blen, int do_sync=0);
 
 int              Stats(XrdXrootdResponse &resp, const char *opts);
 
+// Latency histograms use four linear sub-buckets per power of two of the
+// microsecond value (i.e. at most 25% error) up to 2**28 microseconds.
+//
+static const int latReqs = kXR_REQFENCE - kXR_auth;
+static const int latBkts = 4 + (28-2)*4;
+
                  XrdXrootdStats(XrdStats *sp);
                 ~XrdXrootdStats() {}
 private:
 
+static void       latDrop(void *hP);
+       int        latStats(char *buff, int blen);
+
 XrdSfsFileSystem *fsP;
 XrdStats *xstats;
+XrdSysMutex       latMutex;
+XrdXrootdLatHist *latList;     // Histograms of running threads
+XrdXrootdLatHist *latGone;     // Histograms of threads that ended
+pthread_key_t     latKey;
 };
 #endif
@@ -0,0 +1,298 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d W B u f f . c c                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Xrd/XrdScheduler.hh"
+#include "XrdXrootd/XrdXrootdStats.hh"
+#include "XrdXrootd/XrdXrootdWBuff.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// The sweeper periodically writes out buffers whose data has become too old
+//
+class XrdXrootdWBSweep : public XrdJob
+{
+public:
+
+void DoIt() {XrdXrootdWBuff::Sweep();
+             XrdXrootdWBuff::Sched->Delay(this, XrdXrootdWBuff::wbWait);
+            }
+
+     XrdXrootdWBSweep() : XrdJob(".write-behind sweeper") {}
+    ~XrdXrootdWBSweep() {}
+};
+
+namespace
+{
+XrdXrootdWBSweep wbSweeper;
+}
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdScheduler   *XrdXrootdWBuff::Sched     = 0;
+XrdSysMutex     XrdXrootdWBuff::listMutex;
+XrdXrootdWBuff *XrdXrootdWBuff::listFirst = 0;
+int             XrdXrootdWBuff::wbMax     = 0;
+int             XrdXrootdWBuff::wbMin     = 0;
+int             XrdXrootdWBuff::wbWait    = 100;
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdXrootdWBuff::XrdXrootdWBuff(XrdSfsFile *fP)
+                              : XrdJob("write-behind"), numIn(0), numOut(0),
+                                wbCond(0), sfsP(fP), prev(0),
+                                curBuff(0), curOffs(0), curTime(0),
+                                curLen(0), curMax(0), fluBuff(0), fluOffs(0),
+                                fluLen(0), fluBusy(false), errCode(0),
+                                errText(0)
+{
+
+// Add ourselves to the list of buffers the sweeper looks at
+//
+   listMutex.Lock();
+   next = listFirst;
+   if (listFirst) listFirst->prev = this;
+   listFirst = this;
+   listMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+// The owner must have called Flush() as buffered data is simply discarded here
+//
+XrdXrootdWBuff::~XrdXrootdWBuff()
+{
+
+// Remove ourselves from the sweep list so the sweeper can't find us
+//
+   listMutex.Lock();
+   if (prev) prev->next = next;
+      else   listFirst   = next;
+   if (next) next->prev = prev;
+   listMutex.UnLock();
+
+// Make sure no write is still in progress
+//
+   wbCond.Lock();
+   while(fluBusy) wbCond.Wait();
+   wbCond.UnLock();
+
+// Release the buffers
+//
+   if (curBuff) free(curBuff);
+   if (fluBuff) free(fluBuff);
+   if (errText) free(errText);
+}
+
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+
+void XrdXrootdWBuff::DoIt()
+{
+   XrdSfsXferSize rc;
+
+// Write the standby buffer. Nothing else touches it while fluBusy is set.
+//
+   rc = sfsP->write(fluOffs, fluBuff, fluLen);
+
+// Record the first error and indicate that the standby buffer is free
+//
+   wbCond.Lock();
+   numOut++;
+   if (rc != fluLen && !errCode)
+      {if (rc >= 0) {errCode = EIO; errText = strdup("short write-behind");}
+          else {const char *eTxt = sfsP->error.getErrText(errCode);
+                if (!errCode) errCode = EIO;
+                errText = strdup(eTxt);
+               }
+      }
+   fluBusy = false;
+   wbCond.Broadcast();
+   wbCond.UnLock();
+}
+
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+
+int XrdXrootdWBuff::Flush(bool rpt)
+{
+
+// Write out whatever is buffered and wait for it to be written
+//
+   wbCond.Lock();
+   Handoff();
+   while(fluBusy) wbCond.Wait();
+
+// Reflect any error if so wanted
+//
+   if (rpt && errCode)
+      {sfsP->error.setErrInfo(errCode, (errText ? errText : "write failed"));
+       if (errText) {free(errText); errText = 0;}
+       errCode = 0;
+       wbCond.UnLock();
+       return SFS_ERROR;
+      }
+   wbCond.UnLock();
+   return SFS_OK;
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+void XrdXrootdWBuff::Init(XrdScheduler *sP, int wbmax, int wbmin, int wbwait)
+{
+   Sched  = sP;
+   wbMax  = wbmax;
+   wbMin  = (wbmin < wbmax/2 ? wbmin : wbmax/2);
+   wbWait = wbwait;
+
+// Start the sweeper if write-behind is enabled
+//
+   if (wbMax) Sched->Delay(&wbSweeper, wbWait);
+}
+
+/******************************************************************************/
+/*                                 W r i t e                                  */
+/******************************************************************************/
+
+XrdSfsXferSize XrdXrootdWBuff::Write(long long offs, const char *buff, int blen)
+{
+   int n, left = blen;
+
+// Small writes are buffered unless an earlier write-behind failed. In that
+// case we write directly so that the client sees errors when they occur.
+//
+   wbCond.Lock();
+   if (blen < wbMin && !errCode)
+      {if (curLen && offs != curOffs+curLen) Handoff();
+       while(left)
+            {if (!curLen && !Start(offs)) break;
+             n = curMax - curLen;
+             if (n > left) n = left;
+             memcpy(curBuff+curLen, buff, n);
+             curLen += n; offs += n; buff += n; left -= n;
+             if (curLen >= curMax) Handoff();
+            }
+       if (!left) {numIn++; wbCond.UnLock(); return blen;}
+      }
+
+// Write out what we have and then write the (remaining) data directly
+//
+   Handoff();
+   while(fluBusy) wbCond.Wait();
+   wbCond.UnLock();
+   if ((n = sfsP->write(offs, buff, left)) < 0) return n;
+   return blen - left + n;
+}
+
+/******************************************************************************/
+/* Private:                           H a n d o f f                           */
+/******************************************************************************/
+
+// Called with wbCond locked. The filled buffer becomes the standby buffer
+// which is then written by a scheduler thread.
+//
+void XrdXrootdWBuff::Handoff()
+{
+   char *bP;
+
+// Nothing to do if we have no data
+//
+   if (!curLen) return;
+
+// Wait for the previous write to finish and swap the buffers
+//
+   while(fluBusy) wbCond.Wait();
+   bP = fluBuff; fluBuff = curBuff; curBuff = bP;
+   fluOffs = curOffs; fluLen = curLen; curLen = 0;
+
+// Have the buffer written
+//
+   fluBusy = true;
+   Sched->Schedule((XrdJob *)this);
+}
+
+/******************************************************************************/
+/* Private:                             S t a r t                             */
+/******************************************************************************/
+
+// Called with wbCond locked to start filling an empty buffer at offs. The
+// buffer ends at the next wbMax boundary so that later writes are aligned.
+//
+bool XrdXrootdWBuff::Start(long long offs)
+{
+   static const int pgSz = sysconf(_SC_PAGESIZE);
+
+   if (!curBuff && posix_memalign((void **)&curBuff, pgSz, wbMax))
+      {curBuff = 0; return false;}
+
+   curOffs = offs;
+   curMax  = wbMax - static_cast<int>(offs % wbMax);
+   curTime = XrdXrootdStats::Clock();
+   return true;
+}
+
+/******************************************************************************/
+/* Private:                             S w e e p                             */
+/******************************************************************************/
+
+void XrdXrootdWBuff::Sweep()
+{
+   XrdXrootdWBuff *wbP;
+   long long tOld = XrdXrootdStats::Clock() - wbWait*1000000LL;
+
+// Hand off any buffer whose data has been held too long. We skip buffers that
+// are still being written so that the sweeper itself never waits.
+//
+   listMutex.Lock();
+   wbP = listFirst;
+   while(wbP)
+        {wbP->wbCond.Lock();
+         if (wbP->curLen && wbP->curTime <= tOld && !wbP->fluBusy)
+            wbP->Handoff();
+         wbP->wbCond.UnLock();
+         wbP = wbP->next;
+        }
+   listMutex.UnLock();
+}
@@ -0,0 +1,104 @@
+#ifndef __XRDXROOTDWBUFF_HH_
+#define __XRDXROOTDWBUFF_HH_
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d X r o o t d W B u f f . h h                      */
+/*                                                                            */
+/* (c) 2019 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "Xrd/XrdJob.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdScheduler;
+
+// XrdXrootdWBuff is the write-behind buffer of a file opened for writing.
+// Small contiguous writes are merged in memory and written out by a scheduler
+// thread once the buffer reaches the next wbMax boundary in the file, when a
+// write does not continue the buffered data, or when the data has been held
+// longer than the configured wait time. While one buffer is being written the
+// next one is being filled. Write errors are only reflected by the next
+// Flush() that asks for them (i.e. on sync or close).
+//
+class XrdXrootdWBuff : public XrdJob
+{
+public:
+
+// Write() buffers a small write and returns blen. Any other write is done
+// directly, after buffered data has been written, and its result returned.
+//
+XrdSfsXferSize Write(long long offs, const char *buff, int blen);
+
+// Flush() writes out all buffered data and waits until it has been written.
+// When rpt is true, a pending write-behind error is returned as SFS_ERROR with
+// the error information placed in the file object and is then forgotten.
+//
+int            Flush(bool rpt=false);
+
+void           DoIt();         // Writes the standby buffer (scheduler thread)
+
+static void    Init(XrdScheduler *sP, int wbmax, int wbmin, int wbwait);
+
+static bool    isOn() {return wbMax != 0;}
+
+long long      numIn;          // Writes buffered
+long long      numOut;         // Writes done for buffered data
+
+               XrdXrootdWBuff(XrdSfsFile *fP);
+              ~XrdXrootdWBuff();
+
+private:
+
+       void    Handoff();
+       bool    Start(long long offs);
+static void    Sweep();
+
+friend class   XrdXrootdWBSweep;
+
+static XrdScheduler   *Sched;
+static XrdSysMutex     listMutex;
+static XrdXrootdWBuff *listFirst;
+static int             wbMax;
+static int             wbMin;
+static int             wbWait;
+
+XrdSysCondVar   wbCond;        // Serializes all below; signalled after DoIt()
+XrdSfsFile     *sfsP;
+XrdXrootdWBuff *prev;          // Sweep list
+XrdXrootdWBuff *next;
+char           *curBuff;       // Buffer being filled
+long long       curOffs;
+long long       curTime;       // When data was first placed in the buffer
+int             curLen;
+int             curMax;        // Bytes until the next wbMax boundary
+char           *fluBuff;       // Buffer being written
+long long       fluOffs;
+int             fluLen;
+bool            fluBusy;
+int             errCode;       // First write-behind error, if any
+char           *errText;
+};
+#endif
@@ -54,6 +54,8 @@
 #include "XrdXrootd/XrdXrootdPio.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadV.hh"
+#include "XrdXrootd/XrdXrootdStatm.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
 #include "XrdXrootd/XrdXrootdXPath.hh"
@@ -464,7 +466,7 @@ int XrdXrootdProtocol::do_Close()
 {
    XrdXrootdFile *fp;
    XrdXrootdFHandle fh(Request.close.fhandle);
-   int rc;
+   int rc, wbrc;
 
 // Keep statistics
 //
@@ -481,10 +483,16 @@ int XrdXrootdProtocol::do_Close()
 //
    Link->Serialize();
 
+// Write out any write-behind data. The file is closed regardless but an error
+// encountered while writing it out is reported in lieu of the close result.
+//
+   wbrc = fp->wbFlush(true);
+
 // Do an explicit close of the file here; reflecting any errors
 //
    rc = fp->XrdSfsp->close();
    TRACEP(FS, "close rc=" <<rc <<" fh=" <<fh.handle);
+   if (SFS_OK == rc && SFS_OK != wbrc) rc = wbrc;
    if (SFS_OK != rc)
       {if (rc == SFS_ERROR || rc == SFS_STALL)
           return fsError(rc, 0, fp->XrdSfsp->error, 0, 0);
@@ -505,11 +513,11 @@ int XrdXrootdProtocol::do_Close()
   
 int XrdXrootdProtocol::do_Dirlist()
 {
-   int bleft, rc = 0, dlen, cnt = 0;
+   int bleft, rc = 0, dlen, cnt = 0, dlCursor = 0, dlLeft = 0x7fffffff;
    char *opaque, *buff, ebuff[4096];
    const char *dname;
    XrdSfsDirectory *dp;
-   bool doDig;
+   bool doDig, dlMore = false;
 
 // Check if we are digging for data
 //
@@ -524,6 +532,20 @@ int XrdXrootdProtocol::do_Dirlist()
    if (rpCheck(argp->buff, &opaque)) return rpEmsg("Listing", argp->buff);
    if (!doDig && !Squash(argp->buff))return vpEmsg("Listing", argp->buff);
 
+// Check if the caller wants the listing returned a page at a time. The cursor
+// is simply the number of entries already returned. This allows the listing
+// to be resumed on any connection without keeping state here at the cost of
+// reading (but not returning) the entries that preceed the cursor. Since the
+// cursor is positional, a directory that changes between pages may have some
+// entries skipped or repeated.
+//
+   if (Request.dirlist.options[0] & kXR_dpage)
+      {int pgSize = ntohl(Request.dirlist.pgsize);
+       dlCursor   = ntohl(Request.dirlist.pgcursor);
+       if (dlCursor < 0) dlCursor = 0;
+       if (pgSize   > 0) dlLeft   = pgSize;
+      }
+
 // Get a directory object
 //
    if (doDig) dp = digFS->newDir(Link->ID, Monitor.Did);
@@ -549,28 +571,37 @@ int XrdXrootdProtocol::do_Dirlist()
 // Check if the caller wants stat information as well
 //
    if (Request.dirlist.options[0] & kXR_dstat)
-      return do_DirStat(dp, ebuff, opaque);
+      return do_DirStat(dp, ebuff, opaque, dlCursor, dlLeft);
 
 // Start retreiving each entry and place in a local buffer with a trailing new
 // line character (the last entry will have a null byte). If we cannot fit a
 // full entry in the buffer, send what we have with an OKSOFAR and continue.
 // This code depends on the fact that a directory entry will never be longer
 // than sizeof( ebuff)-1; otherwise, an infinite loop will result. No errors
-// are allowed to be reflected at this point.
+// are allowed to be reflected at this point. Entries before the cursor are
+// skipped and we stop once the page is full.
 //
   dname = 0;
   do {buff = ebuff; bleft = sizeof(ebuff);
       while(dname || (dname = dp->nextEntry()))
            {dlen = strlen(dname);
             if (dlen > 2 || dname[0] != '.' || (dlen == 2 && dname[1] != '.'))
-               {if ((bleft -= (dlen+1)) < 0) break;
-                strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++; cnt++;
+               {if (cnt < dlCursor) cnt++;
+                   else {if (!dlLeft) {dlMore = true; dname = 0; break;}
+                         if ((bleft -= (dlen+1)) < 0) break;
+                         strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++;
+                         cnt++; dlLeft--;
+                        }
                }
             dname = 0;
            }
        if (dname) rc = Response.Send(kXR_oksofar, ebuff, buff-ebuff);
      } while(!rc && dname);
 
+// If more entries remain, the last line holds the cursor for the next page
+//
+   if (!rc && dlMore) rc = dirCursor(ebuff, sizeof(ebuff), buff, bleft, cnt);
+
 // Send the ending packet if we actually have one to send
 //
    if (!rc) 
@@ -584,7 +615,8 @@ int XrdXrootdProtocol::do_Dirlist()
 //
    dp->close();
    delete dp;
-   if (!rc) {TRACEP(FS, "dirlist entries=" <<cnt <<" path=" <<argp->buff);}
+   if (!rc) {TRACEP(FS, "dirlist entries=" <<(cnt > dlCursor ? cnt-dlCursor : 0)
+                     <<" cursor=" <<dlCursor <<" path=" <<argp->buff);}
    return rc;
 }
 
@@ -593,23 +625,26 @@ int XrdXrootdProtocol::do_Dirlist()
 /******************************************************************************/
 
 int XrdXrootdProtocol::do_DirStat(XrdSfsDirectory *dp, char *pbuff,
-                                                       char *opaque)
+                                  char *opaque, int dlSkip, int dlLeft)
 {
+   static const int statSz = 80, dsBatch = 64;
    XrdOucErrInfo myError(Link->ID, Monitor.Did, clientPV);
+   XrdXrootdStatm::Item *iV;
    struct stat Stat;
-   static const int statSz = 80;
-   int bleft, rc = 0, dlen, cnt = 0;
-   char *buff, *dLoc, ebuff[8192];
+   int bleft, rc = 0, eRC = 0, dlen, cnt = 0, iNum, nOffs = 0;
+   int dlCursor = dlSkip;
+   char *buff, ebuff[8192];
    const char *dname;
+   bool isAuto, dlMore = false;
 
 // Construct the path to the directory as we will be asking for stat calls
 // if the interface does not support autostat.
 //
-   if (dp->autoStat(&Stat) == SFS_OK) dLoc = 0;
-      else {strcpy(pbuff, argp->buff);
-            dlen = strlen(pbuff);
-            if (pbuff[dlen-1] != '/') {pbuff[dlen] = '/'; dlen++;}
-            dLoc = pbuff+dlen;
+   if (dp->autoStat(&Stat) == SFS_OK) isAuto = true;
+      else {isAuto = false;
+            strcpy(pbuff, argp->buff);
+            nOffs = strlen(pbuff);
+            if (pbuff[nOffs-1] != '/') {pbuff[nOffs] = '/'; nOffs++;}
            }
 
 // The initial leadin is a "dot" entry to indicate to the client that we
@@ -620,40 +655,77 @@ int XrdXrootdProtocol::do_DirStat(XrdSfsDirectory *dp, char *pbuff,
    strcpy(ebuff, ".\n0 0 0 0\n");
    buff = ebuff+10; bleft = sizeof(ebuff)-10;
 
-// Start retreiving each entry and place in a local buffer with a trailing new
-// line character (the last entry will have a null byte). If we cannot fit a
-// full entry in the buffer, send what we have with an OKSOFAR and continue.
-// This code depends on the fact that a directory entry will never be longer
-// than sizeof( ebuff)-1; otherwise, an infinite loop will result. No errors
-// are allowed to be reflected at this point.
-//
-  dname = 0;
-  do {while(dname || (dname = dp->nextEntry()))
-           {dlen = strlen(dname);
-            if (dlen > 2 || dname[0] != '.' || (dlen == 2 && dname[1] != '.'))
-               {if ((bleft -= (dlen+1)) < 0 || bleft < statSz) break;
-                strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++; cnt++;
-                if (dLoc)
-                   {strcpy(dLoc, dname);
-                    rc = osFS->stat(pbuff, &Stat, myError, CRED, opaque);
-                    if (rc != SFS_OK)
-                       return fsError(rc, XROOTD_MON_STAT, myError,
-                                          argp->buff, opaque);
+// Retrieve the entries in batches skipping those before the cursor. Unless
+// the interface supports autostat, all the entries in a batch are stat'ed in
+// parallel (the directory read itself is inherently serial).
+//
+   iV = new XrdXrootdStatm::Item[dsBatch];
+   do {iNum = 0;
+       while(iNum < dsBatch && (dname = dp->nextEntry()))
+            {dlen = strlen(dname);
+             if (dlen > 2 || dname[0] != '.' || (dlen == 2 && dname[1] != '.'))
+                {if (dlSkip) dlSkip--;
+                    else if (!dlLeft) {dlMore = true; break;}
+                    else {if (isAuto) {iV[iNum].path = strdup(dname);
+                                       iV[iNum].sbuf = Stat;
+                                      }
+                             else     {strcpy(pbuff+nOffs, dname);
+                                       iV[iNum].path = strdup(pbuff);
+                                       iV[iNum].opaque = opaque;
+                                      }
+                          iNum++; dlLeft--;
+                         }
+                }
+            }
+       if (iNum && !isAuto) XrdXrootdStatm::Stat(osFS, CRED, Link->ID, 0,
+                                                iV, iNum);
+
+// Place each entry in a local buffer with a trailing new line character (the
+// last entry will have a null byte). If we cannot fit a full entry in the
+// buffer, send what we have with an OKSOFAR and continue. This code depends on
+// the fact that a directory entry will never be longer than sizeof(ebuff)-1.
+// The first entry we could not stat ends the listing with an error. Its stat
+// is redone here to obtain the error information needed by fsError().
+//
+       for (int i = 0; i < iNum; i++)
+           {if (rc || eRC) {free(iV[i].path); continue;}
+            if (iV[i].rc)
+               eRC = osFS->stat(iV[i].path, &iV[i].sbuf, myError, CRED, opaque);
+            if (!eRC)
+               {dname = iV[i].path + (isAuto ? 0 : nOffs);
+                dlen = strlen(dname);
+                if (bleft < dlen+1+statSz)
+                   {rc = Response.Send(kXR_oksofar, ebuff, buff-ebuff);
+                    buff = ebuff; bleft = sizeof(ebuff);
+                   }
+                if (!rc)
+                   {strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++;
+                    bleft -= (dlen+1); cnt++;
+                    dlen = StatGen(iV[i].sbuf, buff);
+                    bleft -= dlen; buff += (dlen-1); *buff = '\n'; buff++;
                    }
-                dlen = StatGen(Stat, buff);
-                bleft -= dlen; buff += (dlen-1); *buff = '\n'; buff++;
                }
-            dname = 0;
+            free(iV[i].path); iV[i].path = 0;
            }
-       if (dname)
-          {rc = Response.Send(kXR_oksofar, ebuff, buff-ebuff);
-           buff = ebuff; bleft = sizeof(ebuff);
-          }
-     } while(!rc && dname);
+      } while(!rc && !eRC && !dlMore && iNum == dsBatch);
+   delete [] iV;
+
+// Reflect a failed stat as done for any other stat request
+//
+   if (eRC)
+      {dp->close();
+       delete dp;
+       return fsError(eRC, XROOTD_MON_STAT, myError, argp->buff, opaque);
+      }
+
+// If more entries remain, the last line holds the cursor for the next page
+//
+   if (!rc && dlMore)
+      rc = dirCursor(ebuff, sizeof(ebuff), buff, bleft, dlCursor+cnt);
 
 // Send the ending packet if we actually have one to send
 //
-   if (!rc) 
+   if (!rc)
       {if (ebuff == buff) rc = Response.Send();
           else {*(buff-1) = '\0';
                 rc = Response.Send((void *)ebuff, buff-ebuff);
@@ -664,7 +736,8 @@ int XrdXrootdProtocol::do_DirStat(XrdSfsDirectory *dp, char *pbuff,
 //
    dp->close();
    delete dp;
-   if (!rc) {TRACEP(FS, "dirstat entries=" <<cnt <<" path=" <<argp->buff);}
+   if (!rc) {TRACEP(FS, "dirstat entries=" <<cnt <<" cursor=" <<dlCursor
+                     <<" path=" <<argp->buff);}
    return rc;
 }
 
@@ -1348,9 +1421,12 @@ int XrdXrootdProtocol::do_Open()
       }
    oHelp.xp = xp;
 
-// Serialize the link
+// Serialize the link. When executing concurrently with the link's other
+// requests we need only serialize with other such opens as a file table slot
+// was reserved for us.
 //
-   Link->Serialize();
+   if (conParent) conParent->conMutex.Lock();
+      else Link->Serialize();
    *ebuff = '\0';
 
 // Create a file table for this link if it does not have one
@@ -1359,7 +1435,12 @@ int XrdXrootdProtocol::do_Open()
 
 // Insert this file into the link's file table
 //
-   if (!FTab || (fhandle = FTab->Add(xp)) < 0)
+   fhandle = (FTab ? FTab->Add(xp) : -1);
+   if (conParent)
+      {if (fhandle >= 0) conParent->numFiles++;
+       conParent->conMutex.UnLock();
+      }
+   if (fhandle < 0)
       {snprintf(ebuff, sizeof(ebuff)-1, "Insufficient memory to open %s", fn);
        eDest.Emsg("Xeq", ebuff);
        return Response.Send(kXR_NoMemory, ebuff);
@@ -1416,7 +1497,7 @@ int XrdXrootdProtocol::do_Open()
 // Insert the file handle
 //
    memcpy((void *)myResp.fhandle,(const void *)&fhandle,sizeof(myResp.fhandle));
-   numFiles++;
+   if (!conParent) numFiles++;
 
 // Respond (failure is not an option now)
 //
@@ -1762,6 +1843,10 @@ int XrdXrootdProtocol::do_Qfh()
       return Response.Send(kXR_FileNotOpen,
                            "query does not refer to an open file");
 
+// The plug-in must see all of the data written so far
+//
+   fp->wbFlush();
+
 // The query is elegible for a defered response, indicate we're ok with that
 //
    fp->XrdSfsp->error.setErrCB(&qryCB, ReqID.getID());
@@ -1962,6 +2047,7 @@ int XrdXrootdProtocol::do_Read()
    if (!FTab || !(myFile = FTab->Get(fh.handle)))
       return Response.Send(kXR_FileNotOpen,
                            "read does not refer to an open file");
+   myFile->wbFlush();
 
 // Trace and verify read length is not negative
 //
@@ -1979,6 +2065,10 @@ int XrdXrootdProtocol::do_Read()
 //
    if (!myIOLen) return Response.Send();
 
+// Track the access pattern so that sequential streams get read ahead
+//
+   if (!myFile->isMMapped) myFile->ReadAhead(myOffset, myIOLen);
+
 // See if an alternate path is required, offload the read
 //
    if (pathID) return do_Offload(pathID, 0);
@@ -2097,6 +2187,7 @@ int XrdXrootdProtocol::do_ReadNone(int &retc, int &pathID)
                              "preread does not refer to an open file");
              return 1;
             }
+         myFile->wbFlush();
          myFile->XrdSfsp->read(myOffset, myIOLen);
          ralsz -= sizeof(struct readahead_list);
          ralsp++;
@@ -2203,6 +2294,21 @@ int XrdXrootdProtocol::do_ReadV()
    memcpy(respHdr.fhandle, &currFH, sizeof(respHdr.fhandle));
    if (!(myFile = FTab->Get(currFH))) return Response.Send(kXR_FileNotOpen,
                                       "readv does not refer to an open file");
+   myFile->wbFlush();
+
+// If all segments refer to a single sendfile enabled file and most of the data
+// is in large segments, then send the large segments directly from the file.
+//
+   if (myFile->sfEnabled && myFile->fdNum >= 0 && Response.isOurs())
+      {long long sfSZ = 0;
+       for (i = 0; i < rdVBreak; i++)
+           {if (rdVec[i].info != currFH
+            ||  rdVec[i].offset + rdVec[i].size > myFile->Stats.fSize) break;
+            if (rdVec[i].size >= as_rvsfsize) sfSZ += rdVec[i].size;
+           }
+       if (i >= rdVBreak && sfSZ && sfSZ*2 >= totSZ - rdVecLen)
+          return do_ReadVSF(rdVec, rdVBreak, Quantum);
+      }
 
 // Setup variables for running through the list.
 //
@@ -2213,7 +2319,7 @@ int XrdXrootdProtocol::do_ReadV()
 //
    for (i = 0; i < rdVecNum; i++)
        {if (rdVec[i].info != currFH)
-           {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
+           {xfrSZ = XrdXrootdReadV::Read(myFile, &rdVec[rdVNow], i-rdVNow);
             if (xfrSZ != rdVAmt) break;
             rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
             myFile->Stats.rvOps(rdVXfr, rdVNum);
@@ -2231,11 +2337,12 @@ int XrdXrootdProtocol::do_ReadV()
             if (!(myFile = FTab->Get(currFH)))
                return Response.Send(kXR_FileNotOpen,
                                     "readv does not refer to an open file");
+            myFile->wbFlush();
             }
 
         if (Qleft < (rdVec[i].size + hdrSZ))
            {if (rdVAmt)
-               {xfrSZ = myFile->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
+               {xfrSZ = XrdXrootdReadV::Read(myFile, &rdVec[rdVNow], i-rdVNow);
                 if (xfrSZ != rdVAmt) break;
                }
             if (Response.Send(kXR_oksofar,argp->buff,Quantum-Qleft) < 0)
@@ -2269,6 +2376,109 @@ int XrdXrootdProtocol::do_ReadV()
    return (Quantum != Qleft ? Response.Send(argp->buff, Quantum-Qleft) : 0);
 }
 
+/******************************************************************************/
+/*                             d o _ R e a d V S F                            */
+/******************************************************************************/
+
+// This sends a readv response for a single file using sendfile. Each segment
+// is preceded by its readahead_list header from memory. Large segments are
+// sent directly from the file descriptor while small ones are first read into
+// the request buffer. Segments are grouped into kXR_oksofar responses that do
+// not exceed the transfer quantum, just as for the copying path.
+//
+int XrdXrootdProtocol::do_ReadVSF(XrdOucIOVec *rdVec, int rdVNum, int Quantum)
+{
+   static const int hdrSZ = sizeof(readahead_list);
+   static const int sfMax = XrdOucSFVec::sfMax;
+   struct readahead_list rvHdr[sfMax/2];
+   struct XrdOucIOVec    rdVSmall[sfMax/2];
+   XrdOucSFVec sfVec[sfMax];
+   XrdSfsXferSize xfrSZ, rdVXfr = 0;
+   int i, k, segSZ, sfN = 1, nHdr = 0, nSmall = 0, frameSZ = 0, smallSZ = 0;
+   int rvMon = Monitor.InOut();
+   int ioMon = (rvMon > 1);
+   char *buffp = argp->buff;
+   char vType = (ioMon ? XROOTD_MON_READU : XROOTD_MON_READV);
+
+// This is a new readv sequence for monitoring purposes
+//
+   rvSeq++;
+
+// Run through all of the segments plus one more to flush the last response
+//
+   for (i = 0; i <= rdVNum; i++)
+       {segSZ = (i < rdVNum ? rdVec[i].size : 0);
+
+        // Send off what we have when we are done or the next segment will not
+        // fit into the sendfile vector, the header table, the buffer, or the
+        // transfer quantum. Zero length segments only add a header.
+        //
+        if (i == rdVNum
+        || (sfN > 1 && (sfN+2 > sfMax || nHdr >= sfMax/2
+                    || frameSZ+hdrSZ+segSZ > Quantum
+                    || (segSZ < as_rvsfsize && smallSZ+segSZ > argp->bsize))))
+           {if (nSmall)
+               {xfrSZ = XrdXrootdReadV::Read(myFile, rdVSmall, nSmall);
+                if (xfrSZ != smallSZ)
+                   {if (xfrSZ >= 0)
+                       {xfrSZ = SFS_ERROR;
+                        myFile->XrdSfsp->error.setErrInfo(-ENODATA,
+                                                          "readv past EOF");
+                       }
+                    return fsError(xfrSZ, 0, myFile->XrdSfsp->error, 0, 0);
+                   }
+               }
+            if (Response.Send((i == rdVNum ? kXR_ok : kXR_oksofar),
+                              sfVec, sfN, frameSZ) < 0) return -1;
+            if (i == rdVNum) break;
+            sfN = 1; nHdr = nSmall = 0; frameSZ = smallSZ = 0;
+            buffp = argp->buff;
+           }
+
+        // Add the segment header
+        //
+        k = nHdr++;
+        memcpy(rvHdr[k].fhandle, &rdVec[i].info, sizeof(rvHdr[k].fhandle));
+        rvHdr[k].rlen   = htonl(segSZ);
+        rvHdr[k].offset = htonll(rdVec[i].offset);
+        sfVec[sfN].buffer = (char *)&rvHdr[k];
+        sfVec[sfN].sendsz = hdrSZ;
+        sfVec[sfN].fdnum  = -1;
+        sfN++; frameSZ += hdrSZ + segSZ; rdVXfr += segSZ;
+        TRACEP(FS, "fh=" <<rdVec[i].info <<" readV " <<segSZ <<'@'
+                   <<rdVec[i].offset <<(segSZ >= as_rvsfsize ? " sf" : ""));
+
+        // Add the segment data unless there is none
+        //
+        if (!segSZ) continue;
+        if (segSZ >= as_rvsfsize)
+           {sfVec[sfN].offset = rdVec[i].offset;
+            sfVec[sfN].fdnum  = myFile->fdNum;
+           } else {
+            rdVSmall[nSmall]      = rdVec[i];
+            rdVSmall[nSmall].data = buffp;
+            nSmall++;
+            sfVec[sfN].buffer = buffp;
+            sfVec[sfN].fdnum  = -1;
+            buffp += segSZ; smallSZ += segSZ;
+           }
+        sfVec[sfN].sendsz = segSZ;
+        sfN++;
+       }
+
+// Record the statistics and monitoring information
+//
+   myFile->Stats.rvOps(rdVXfr, rdVNum);
+   if (rvMon)
+      {Monitor.Agent->Add_rv(myFile->Stats.FileID, htonl(rdVXfr),
+                                     htons(rdVNum), rvSeq, vType);
+       if (ioMon) for (k = 0; k < rdVNum; k++)
+           Monitor.Agent->Add_rd(myFile->Stats.FileID,
+                   htonl(rdVec[k].size), htonll(rdVec[k].offset));
+      }
+   return 0;
+}
+
 /******************************************************************************/
 /*                                 d o _ R m                                  */
 /******************************************************************************/
@@ -2448,6 +2658,7 @@ int XrdXrootdProtocol::do_Stat()
        if (!FTab || !(fp = FTab->Get(fh.handle)))
           return Response.Send(kXR_FileNotOpen,
                               "stat does not refer to an open file");
+       fp->wbFlush();
        rc = fp->XrdSfsp->stat(&buf);
        TRACEP(FS, "stat rc=" <<rc <<" fh=" <<fh.handle);
        if (SFS_OK == rc) return Response.Send(xxBuff, StatGen(buf, xxBuff));
@@ -2482,6 +2693,89 @@ int XrdXrootdProtocol::do_Stat()
    return fsError(rc, (doDig ? 0 : XROOTD_MON_STAT),myError,argp->buff,opaque);
 }
 
+/******************************************************************************/
+/*                              d o _ S t a t m                               */
+/******************************************************************************/
+
+// The response has one line per path in the order the paths were given. Each
+// line is "0 <id> <size> <flags> <mtime>" followed by " <cktype> <ckval>" when
+// a checksum was requested and is known, or just "<ecode>" (a kXR error code)
+// when the path could not be stat'ed. The last line ends with a null byte.
+//
+int XrdXrootdProtocol::do_Statm()
+{
+   static const int lineSz = 512;
+   XrdXrootdStatm::Item *iV;
+   XrdOucTokenizer pathlist(argp->buff);
+   const char *cksT = 0;
+   char *path, *opaque, *bP, rBuff[8192];
+   int i, k, pNum = 1, pCnt = 0, okCnt = 0, rc = 0;
+
+// Check for static routing. A redirector can't handle bulk requests as each
+// path may need to be redirected to a different server.
+//
+   STATIC_REDIRECT(RD_stat);
+   if (isRedir)
+      return Response.Send(kXR_Unsupported, "statm is not supported by a "
+                                            "redirector");
+
+// Checksums are returned only if they may be queried without a calculation
+//
+   if ((Request.stat.options & kXR_retcks) && JobCKT && JobLCL) cksT = JobCKT;
+
+// Allocate an item for each path and prescreen the path. A path that fails
+// the prescreen is reported as such; it does not fail the whole request.
+//
+   for (i = 0; i < Request.header.dlen; i++) if (argp->buff[i] == '\n') pNum++;
+   iV = new XrdXrootdStatm::Item[pNum];
+   while(pCnt < pNum && (path = pathlist.GetLine()))
+        {iV[pCnt].path = path;
+         if (rpCheck(path, &opaque) || !Squash(path))
+            iV[pCnt].rc = kXR_NotAuthorized;
+            else iV[pCnt].opaque = opaque;
+         pCnt++;
+        }
+
+// Stat all of the paths, concurrently if so configured
+//
+   XrdXrootdStatm::Stat(osFS, CRED, Link->ID, cksT, iV, pCnt);
+
+// Format the response. Should the local buffer fill up, send what we have
+// with an OKSOFAR and continue.
+//
+   bP = rBuff;
+   for (i = 0; i < pCnt && !rc; i++)
+       {if (rBuff+sizeof(rBuff)-bP < lineSz)
+           {rc = Response.Send(kXR_oksofar, rBuff, bP-rBuff);
+            bP = rBuff;
+           }
+        if (iV[i].rc) bP += sprintf(bP, "%d\n", iV[i].rc);
+           else {*bP++ = '0'; *bP++ = ' ';
+                 bP += StatGen(iV[i].sbuf, bP) - 1;
+                 if (iV[i].cksum
+                 && (k = snprintf(bP, lineSz-96, " %s %s", cksT, iV[i].cksum))
+                     < lineSz-96) bP += k;
+                 *bP++ = '\n';
+                 okCnt++;
+                }
+       }
+
+// Send the ending packet
+//
+   if (!rc)
+      {if (bP == rBuff) rc = Response.Send();
+          else {*(bP-1) = '\0';
+                rc = Response.Send(rBuff, bP-rBuff);
+               }
+      }
+
+// All done
+//
+   TRACEP(FS, "statm rc=" <<rc <<" paths=" <<pCnt <<" ok=" <<okCnt);
+   delete [] iV;
+   return rc;
+}
+
 /******************************************************************************/
 /*                              d o _ S t a t x                               */
 /******************************************************************************/
@@ -2544,6 +2838,11 @@ int XrdXrootdProtocol::do_Sync()
 //
    fp->XrdSfsp->error.setErrCB(&syncCB, ReqID.getID());
 
+// Write out any write-behind data, reflecting any error encountered doing so
+//
+   if (fp->wbFlush(true) != SFS_OK)
+      return fsError(SFS_ERROR, 0, fp->XrdSfsp->error, 0, 0);
+
 // Sync the file
 //
    rc = fp->XrdSfsp->sync();
@@ -2587,6 +2886,7 @@ int XrdXrootdProtocol::do_Truncate()
 
      // Truncate the file (it is eligible for async callbacks)
      //
+        fp->wbFlush();
         fp->XrdSfsp->error.setErrCB(&truncCB, ReqID.getID());
         rc = fp->XrdSfsp->truncate(theOffset);
         TRACEP(FS, "trunc rc=" <<rc <<" sz=" <<theOffset <<" fh=" <<fh.handle);
@@ -2669,7 +2969,8 @@ int XrdXrootdProtocol::do_Write()
    if (myFile->AsyncMode && !as_syncw)
       {if (myStalls > as_maxstalls) myStalls--;
           else if (myIOLen >= as_miniosz && Link->UseCnt() < as_maxperlnk)
-                  {if ((retc = aio_Write()) != -EAGAIN)
+                  {myFile->wbFlush();
+                   if ((retc = aio_Write()) != -EAGAIN)
                       {if (retc != -EIO) return retc;
                        myEInfo[0] = SFS_ERROR;
                        myFile->XrdSfsp->error.setErrInfo(retc, "I/O error");
@@ -2714,7 +3015,7 @@ int XrdXrootdProtocol::do_WriteAll()
                 }
              return rc;
             }
-         if ((rc = myFile->XrdSfsp->write(myOffset, argp->buff, Quantum)) < 0)
+         if ((rc = myFile->Write(myOffset, argp->buff, Quantum)) < 0)
             {myIOLen  = myIOLen-Quantum; myEInfo[0] = rc;
              return do_WriteNone();
             }
@@ -2742,7 +3043,7 @@ int XrdXrootdProtocol::do_WriteCont()
 
 // Write data that was finaly finished comming in
 //
-   if ((rc = myFile->XrdSfsp->write(myOffset, argp->buff, myBlast)) < 0)
+   if ((rc = myFile->Write(myOffset, argp->buff, myBlast)) < 0)
       {myIOLen  = myIOLen-myBlast; myEInfo[0] = rc;
        return do_WriteNone();
       }
@@ -2821,7 +3122,7 @@ int XrdXrootdProtocol::do_WriteSpan()
 
 // Write data that was already read
 //
-   if ((rc = myFile->XrdSfsp->write(myOffset, myBuff, myBlast)) < 0)
+   if ((rc = myFile->Write(myOffset, myBuff, myBlast)) < 0)
       {myIOLen  = myIOLen-myBlast; myEInfo[0] = rc;
        return do_WriteNone();
       }
@@ -3000,6 +3301,7 @@ do{if (myIOLen > 0)
 // We need to write out what we have.
 //
    wrVNum = vNow - wvInfo->vBeg;
+   myFile->wbFlush();
    xfrSZ = myFile->XrdSfsp->writev(&(wvInfo->wrVec[wvInfo->vBeg]), wrVNum);
    TRACEP(FS,"fh=" <<wvInfo->curFH <<" writeV " << xfrSZ <<':' <<wrVNum);
    if (xfrSZ != myBlast) break;
@@ -3113,6 +3415,32 @@ void XrdXrootdProtocol::SetFD(int fildes)
 /******************************************************************************/
 /*                       U t i l i t y   M e t h o d s                        */
 /******************************************************************************/
+/******************************************************************************/
+/*                             d i r C u r s o r                              */
+/******************************************************************************/
+
+// Append the line holding the cursor of the next page to a paged listing. The
+// line starts with a slash so it can't be mistaken for an entry name.
+//
+int XrdXrootdProtocol::dirCursor(char *bP, int bSz, char *&buff, int &bleft,
+                                 int cursor)
+{
+   int rc;
+
+// Make room if need be (an int never needs more than 11 characters)
+//
+   if (bleft < 14)
+      {if ((rc = Response.Send(kXR_oksofar, bP, buff-bP))) return rc;
+       buff = bP; bleft = bSz;
+      }
+
+// Add the cursor
+//
+   rc = sprintf(buff, "/%d\n", cursor);
+   buff += rc; bleft -= rc;
+   return 0;
+}
+
 /******************************************************************************/
 /*                               f s E r r o r                                */
 /******************************************************************************/
@@ -24,6 +24,7 @@
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <set>
 
 #include "TestEnv.hh"
 #include "IdentityPlugIn.hh"
@@ -45,10 +46,12 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( ChmodTest );
       CPPUNIT_TEST( PingTest );
       CPPUNIT_TEST( StatTest );
+      CPPUNIT_TEST( BulkStatTest );
       CPPUNIT_TEST( StatVFSTest );
       CPPUNIT_TEST( ProtocolTest );
       CPPUNIT_TEST( DeepLocateTest );
       CPPUNIT_TEST( DirListTest );
+      CPPUNIT_TEST( PagedDirListTest );
       CPPUNIT_TEST( SendInfoTest );
       CPPUNIT_TEST( PrepareTest );
       CPPUNIT_TEST( PlugInTest );
@@ -61,10 +64,12 @@ class FileSystemTest: public CppUnit::TestCase
     void ChmodTest();
     void PingTest();
     void StatTest();
+    void BulkStatTest();
     void StatVFSTest();
     void ProtocolTest();
     void DeepLocateTest();
     void DirListTest();
+    void PagedDirListTest();
     void SendInfoTest();
     void PrepareTest();
     void PlugInTest();
@@ -331,6 +336,103 @@ void FileSystemTest::StatTest()
   delete response;
 }
 
+//------------------------------------------------------------------------------
+// Bulk stat test
+//------------------------------------------------------------------------------
+void FileSystemTest::BulkStatTest()
+{
+  using namespace XrdCl;
+
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+  std::string remoteFile;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath",      dataPath ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  FileSystem fs( url );
+
+  //----------------------------------------------------------------------------
+  // A file, a directory, a missing path and a disallowed path, each one
+  // gets its own entry in the order given
+  //----------------------------------------------------------------------------
+  std::vector<std::string> paths;
+  paths.push_back( remoteFile );
+  paths.push_back( dataPath );
+  paths.push_back( dataPath + "/bulkstat-does-not-exist" );
+  paths.push_back( dataPath + "/../bulkstat-disallowed" );
+
+  BulkStatInfo *response = 0;
+  CPPUNIT_ASSERT_XRDST( fs.Stat( paths, StatFlags::None, response ) );
+  CPPUNIT_ASSERT( response );
+  CPPUNIT_ASSERT( response->GetSize() == paths.size() );
+
+  for( uint32_t i = 0; i < paths.size(); ++i )
+    CPPUNIT_ASSERT( response->At( i )->GetPath() == paths[i] );
+
+  BulkStatInfo::Entry *entry = response->At( 0 );
+  CPPUNIT_ASSERT_XRDST( entry->GetStatus() );
+  CPPUNIT_ASSERT( entry->GetStatInfo() );
+  CPPUNIT_ASSERT( entry->GetStatInfo()->GetSize() == 1048576000 );
+  CPPUNIT_ASSERT( !entry->GetStatInfo()->TestFlags( StatInfo::IsDir ) );
+
+  entry = response->At( 1 );
+  CPPUNIT_ASSERT_XRDST( entry->GetStatus() );
+  CPPUNIT_ASSERT( entry->GetStatInfo() );
+  CPPUNIT_ASSERT( entry->GetStatInfo()->TestFlags( StatInfo::IsDir ) );
+
+  entry = response->At( 2 );
+  CPPUNIT_ASSERT( !entry->GetStatus().IsOK() );
+  CPPUNIT_ASSERT( entry->GetStatus().code  == errErrorResponse );
+  CPPUNIT_ASSERT( entry->GetStatus().errNo == kXR_NotFound );
+  CPPUNIT_ASSERT( !entry->GetStatInfo() );
+
+  entry = response->At( 3 );
+  CPPUNIT_ASSERT( !entry->GetStatus().IsOK() );
+  CPPUNIT_ASSERT( entry->GetStatus().code  == errErrorResponse );
+  CPPUNIT_ASSERT( entry->GetStatus().errNo == kXR_NotAuthorized );
+  CPPUNIT_ASSERT( !entry->GetStatInfo() );
+  delete response;
+
+  //----------------------------------------------------------------------------
+  // The server sends the response in kXR_oksofar parts once it fills its
+  // 8k buffer, so make sure these are put together correctly
+  //----------------------------------------------------------------------------
+  paths.clear();
+  for( int i = 0; i < 1000; ++i )
+    paths.push_back( i % 100 == 50 ? dataPath + "/bulkstat-does-not-exist"
+                                   : remoteFile );
+
+  response = 0;
+  CPPUNIT_ASSERT_XRDST( fs.Stat( paths, StatFlags::None, response ) );
+  CPPUNIT_ASSERT( response );
+  CPPUNIT_ASSERT( response->GetSize() == paths.size() );
+
+  for( uint32_t i = 0; i < paths.size(); ++i )
+  {
+    entry = response->At( i );
+    CPPUNIT_ASSERT( entry->GetPath() == paths[i] );
+    if( i % 100 == 50 )
+    {
+      CPPUNIT_ASSERT( entry->GetStatus().errNo == kXR_NotFound );
+      CPPUNIT_ASSERT( !entry->GetStatInfo() );
+    }
+    else
+    {
+      CPPUNIT_ASSERT_XRDST( entry->GetStatus() );
+      CPPUNIT_ASSERT( entry->GetStatInfo() );
+      CPPUNIT_ASSERT( entry->GetStatInfo()->GetSize() == 1048576000 );
+    }
+  }
+  delete response;
+}
+
 //------------------------------------------------------------------------------
 // Stat VFS test
 //------------------------------------------------------------------------------
@@ -450,6 +552,97 @@ void FileSystemTest::DirListTest()
 }
 
 
+//------------------------------------------------------------------------------
+// Paged dir list
+//------------------------------------------------------------------------------
+void FileSystemTest::PagedDirListTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Get the environment variables
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  std::string lsPath = dataPath + "/bigdir";
+  const uint32_t dirSize = 40000;
+
+  FileSystem fs( url );
+  DirectoryList *list = 0;
+
+  //----------------------------------------------------------------------------
+  // A page smaller than the directory returns a cursor to continue from
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( fs.DirList( lsPath, DirListFlags::None, 1000, 0,
+                                    list ) );
+  CPPUNIT_ASSERT( list );
+  CPPUNIT_ASSERT( list->GetSize() == 1000 );
+  CPPUNIT_ASSERT( list->GetCursor() == 1000 );
+  delete list; list = 0;
+
+  //----------------------------------------------------------------------------
+  // A page of exactly the directory size or larger returns all of it and no
+  // cursor
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( fs.DirList( lsPath, DirListFlags::None, dirSize, 0,
+                                    list ) );
+  CPPUNIT_ASSERT( list );
+  CPPUNIT_ASSERT( list->GetSize() == dirSize );
+  CPPUNIT_ASSERT( list->GetCursor() == 0 );
+  delete list; list = 0;
+
+  CPPUNIT_ASSERT_XRDST( fs.DirList( lsPath, DirListFlags::None, dirSize+100,
+                                    0, list ) );
+  CPPUNIT_ASSERT( list );
+  CPPUNIT_ASSERT( list->GetSize() == dirSize );
+  CPPUNIT_ASSERT( list->GetCursor() == 0 );
+  delete list; list = 0;
+
+  //----------------------------------------------------------------------------
+  // Continue from the cursor until the listing is complete, every entry must
+  // be listed exactly once; the last page is a partial one and pages with
+  // stat information are listed the same way
+  //----------------------------------------------------------------------------
+  DirListFlags::Flags flags[] = { DirListFlags::None, DirListFlags::Stat };
+  for( int f = 0; f < 2; ++f )
+  {
+    std::set<std::string> names;
+    uint32_t cursor = 0, pages = 0, total = 0;
+    do
+    {
+      CPPUNIT_ASSERT_XRDST( fs.DirList( lsPath, flags[f], 7000, cursor,
+                                        list ) );
+      CPPUNIT_ASSERT( list );
+      CPPUNIT_ASSERT( list->GetSize() <= 7000 );
+      for( uint32_t i = 0; i < list->GetSize(); ++i )
+      {
+        names.insert( list->At( i )->GetName() );
+        if( flags[f] & DirListFlags::Stat )
+          CPPUNIT_ASSERT( list->At( i )->GetStatInfo() );
+      }
+      total += list->GetSize();
+      cursor = list->GetCursor();
+      CPPUNIT_ASSERT( !cursor || cursor == total );
+      delete list; list = 0;
+      ++pages;
+    }
+    while( cursor );
+
+    CPPUNIT_ASSERT( pages == (dirSize+6999)/7000 );
+    CPPUNIT_ASSERT( total == dirSize );
+    CPPUNIT_ASSERT( names.size() == dirSize );
+  }
+}
+
 //------------------------------------------------------------------------------
 // Set
 //------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 //------------------------------------------------------------------------------
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <cstring>
 #include "TestEnv.hh"
 #include "Utils.hh"
 #include "IdentityPlugIn.hh"
@@ -480,10 +481,27 @@ void FileTest::VectorReadTest()
   crc = Utils::ComputeCRC32( buffer2, 40*256000 );
   CPPUNIT_ASSERT( crc == 3492603530UL );
 
+  //----------------------------------------------------------------------------
+  // A zero length chunk in the middle must not disturb the others
+  //----------------------------------------------------------------------------
+  char *buffer3 = new char[2*MB];
+  ChunkList chunkList3;
+  chunkList3.push_back( ChunkInfo( 10*MB, 1*MB, buffer3 ) );
+  chunkList3.push_back( ChunkInfo( 20*MB, 0,    buffer3+MB ) );
+  chunkList3.push_back( ChunkInfo( 30*MB, 1*MB, buffer3+MB ) );
+
+  info = 0;
+  CPPUNIT_ASSERT_XRDST( f.VectorRead( chunkList3, 0, info ) );
+  CPPUNIT_ASSERT( info->GetSize() == 2*MB );
+  delete info;
+  CPPUNIT_ASSERT( memcmp( buffer3, buffer1, MB ) == 0 );
+  CPPUNIT_ASSERT( memcmp( buffer3+MB, buffer1+2*MB, MB ) == 0 );
+
   CPPUNIT_ASSERT_XRDST( f.Close() );
 
   delete [] buffer1;
   delete [] buffer2;
+  delete [] buffer3;
 }
 
 void gen_random_str(char *s, const int len)